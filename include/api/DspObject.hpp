@@ -2,8 +2,10 @@
 #define SAPI_API_DSP_OBJECT_HPP_
 
 #if !defined __link
-
 #include <arm_dsp_api.h>
+#else
+#include "../dsp/HostDsp.hpp"
+#endif
 #include "WorkObject.hpp"
 #include "InfoObject.hpp"
 #include "../sys/requests.h"
@@ -20,11 +22,18 @@ class DspInfoObject : public virtual InfoObject {
 
 };
 
+#if !defined __link
 typedef api::Api<arm_dsp_api_q7_t, SAPI_API_REQUEST_ARM_DSP_Q7> DspQ7Api;
 typedef api::Api<arm_dsp_api_q15_t, SAPI_API_REQUEST_ARM_DSP_Q15> DspQ15Api;
 typedef api::Api<arm_dsp_api_q31_t, SAPI_API_REQUEST_ARM_DSP_Q31> DspQ31Api;
 typedef api::Api<arm_dsp_api_f32_t, SAPI_API_REQUEST_ARM_DSP_F32> DspF32Api;
 typedef api::Api<arm_dsp_conversion_api_t, SAPI_API_REQUEST_ARM_DSP_CONVERSION> DspConversionApi;
+#else
+//the host uses the kernels in dsp::HostDsp
+typedef api::Api<host_dsp_api_q15_t, SAPI_API_REQUEST_ARM_DSP_Q15> DspQ15Api;
+typedef api::Api<host_dsp_api_q31_t, SAPI_API_REQUEST_ARM_DSP_Q31> DspQ31Api;
+typedef api::Api<host_dsp_api_f32_t, SAPI_API_REQUEST_ARM_DSP_F32> DspF32Api;
+#endif
 
 
 /*! \brief DSP Work Object
@@ -36,25 +45,31 @@ typedef api::Api<arm_dsp_conversion_api_t, SAPI_API_REQUEST_ARM_DSP_CONVERSION>
 class DspWorkObject : public virtual WorkObject {
 public:
 
+#if !defined __link
 	static DspQ7Api & api_a7(){ return m_api_q7; }
+#endif
 	static DspQ15Api & api_q15(){ return m_api_q15; }
 	static DspQ31Api & api_q31(){ return m_api_q31; }
 	static DspF32Api & api_f32(){ return m_api_f32; }
+#if !defined __link
 	static DspConversionApi & api_conversion(){ return m_api_conversion; }
+#endif
 
 protected:
 
+#if !defined __link
 	static DspQ7Api m_api_q7;
+#endif
 	static DspQ15Api m_api_q15;
 	static DspQ31Api m_api_q31;
 	static DspF32Api m_api_f32;
+#if !defined __link
 	static DspConversionApi m_api_conversion;
+#endif
 
 };
 
 
 }
 
-#endif
-
 #endif // SAPI_API_DSP_OBJECT_HPP_
@@ -51,6 +51,15 @@ namespace calc {
 class Base64 : public api::CalcInfoObject {
 public:
 
+	enum {
+		STREAM_CHUNK_SIZE /*! Number of raw bytes encoded (or decoded) per file read and write (a multiple of 12) */ =
+#if defined __link
+		3072
+#else
+		192
+#endif
+	};
+
 	/*! \details Encodes data to the base64 format.
 	 *
 	 * @param dest Pointer to destination memory
@@ -73,6 +82,24 @@ public:
 	 */
 	static var::String encode(const var::Data & input);
 
+	/*! \details Encodes \a input and writes the zero terminated result to \a output.
+	 *
+	 * @param input The raw data to encode
+	 * @param output The destination string
+	 * @return The length of the encoded string or less than zero if \a output is too small
+	 *
+	 * If \a output already has enough capacity, no memory is allocated. This makes it possible to
+	 * reuse one string for many blocks or to encode into a fixed buffer.
+	 *
+	 * \code
+	 * char buffer[65]; //48 bytes encode to 64 characters plus the terminator
+	 * String encoded(buffer, sizeof(buffer));
+	 * Base64::encode(block, encoded); //block is up to 48 bytes
+	 * \endcode
+	 *
+	 */
+	static int encode(const var::Data & input, var::String & output);
+
 
 	/*! \details Reads binary data from *input* and writes a Base64
 	 * encoded string to *output*.
@@ -80,22 +107,24 @@ public:
 	 * @param input The input sys::File
 	 * @param output The output sys::File
 	 * @param size The number of bytes from input to read (0 to read to EOF)
-	 * @return Number of encoded bytes written to *output*
+	 * @return Number of bytes read from *input* or less than zero if *input* or *output* failed
 	 *
 	 * The method reads *size* bytes (or to EOF if *size* is zero) from *input*
 	 * start at the current location. The output string is written to *output*
 	 * at the current location.
 	 *
+	 * The data is processed STREAM_CHUNK_SIZE bytes at a time.
 	 *
 	 */
 	static int encode(const sys::File & input, sys::File & output, u32 size = 0);
 
 	/*! \details Decodes base64 encoded data.
 	 *
-	 * @param dest Pointer to destination memory (binary format)
-	 * @param src Pointer to source data (base64 encoded)
-	 * @param nbyte Pointer the number of bytes to decode (src size)
-	 * @return Zero
+	 * @param input The base64 encoded string
+	 * @return The decoded data or an empty object if \a input is not valid base64
+	 *
+	 * The input length must be a multiple of 4 and padding ('=') may
+	 * only appear at the end. Whitespace is not accepted.
 	 *
 	 * \code
 	 * #include <sapi/calc.hpp>
@@ -118,24 +147,26 @@ public:
 	 * @param input The input sys::File
 	 * @param output The output sys::File
 	 * @param size The number of bytes from input to read (0 to read to EOF)
-	 * @return Number of decoded bytes written to *output*
+	 * @return Number of bytes read from *input* or less than zero if the data is not valid base64 or a file operation failed
 	 *
 	 * The method reads *size* bytes (or to EOF if *size* is zero) from *input*
 	 * start at the current location. The output string is written to *output*
 	 * at the current location.
 	 *
+	 * Decoding stops at the first invalid group. The groups before it have
+	 * already been written to *output*.
 	 *
 	 */
 	static int decode(const sys::File & input, sys::File & output, u32 size = 0);
 
 
+	/*! \details Returns the length of the encoded string (not including the zero terminator) for \a nbyte bytes. */
+	static u32 calc_encoded_size(u32 nbyte){ return ((nbyte + 2)/3)*4; }
+
 private:
 	static int encode(char * dest, const void * src, int nbyte);
 	static int decode(void * dest, const char * src, int nbyte);
-	static int calc_decoded_size(int nbyte);
-	static int calc_encoded_size(int nbyte);
-	static char encode_six(uint8_t six_bit_value);
-	static char decode_eigth(uint8_t eight_bit_value);
+	static u32 calc_decoded_size(u32 nbyte);
 
 
 };
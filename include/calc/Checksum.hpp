@@ -11,6 +11,8 @@ namespace  calc {
 /*! \brief Checksum Class
  * \details The Checksum class is purely static and provides methods
  * for calculating and verifying checksums on data structures.
+ *
+ * \sa Crc for CRC32, CRC32C and CRC16-CCITT
  */
 class Checksum : public api::CalcInfoObject {
 public:
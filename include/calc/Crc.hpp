@@ -0,0 +1,134 @@
+/*! \file */ //Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_CALC_CRC_HPP_
+#define SAPI_CALC_CRC_HPP_
+
+#include "../api/CalcObject.hpp"
+#include "../var/Data.hpp"
+#include "../sys/File.hpp"
+
+namespace calc {
+
+/*! \brief Cyclic Redundancy Check Class
+ * \details The Crc class calculates CRC32, CRC32C and CRC16-CCITT
+ * values. Unlike Checksum, the CRC detects reordered and
+ * swapped bytes which makes it suitable for verifying firmware images
+ * and framed link traffic.
+ *
+ * The value can be calculated in a single call or accumulated
+ * as data arrives.
+ *
+ * \code
+ * #include <sapi/calc.hpp>
+ *
+ * //one shot
+ * u32 value = Crc::calculate(Crc::CRC32, data);
+ *
+ * //incremental
+ * Crc crc(Crc::CRC32C);
+ * crc << header << payload;
+ * if( crc.value() != expected ){
+ *   //data is corrupt
+ * }
+ *
+ * //whole file
+ * File image;
+ * image.open("/app/flash/image.bin", File::RDONLY);
+ * crc.start();
+ * crc.update(image);
+ * \endcode
+ *
+ * The data is processed eight bytes at a time using slicing-by-8 lookup
+ * tables. The tables for each type are built (8KB each) the first time the
+ * type is used. On desktop builds, CRC32C (SSE4.2 and ARMv8) and CRC32 (ARMv8)
+ * use the processor's CRC instructions when they are available.
+ *
+ */
+class Crc : public api::CalcWorkObject {
+public:
+
+	/*! \details CRC algorithms */
+	enum type {
+		CRC32 /*! IEEE 802.3 (zip, png), reflected polynomial 0xEDB88320 */,
+		CRC32C /*! Castagnoli (iSCSI, ext4), reflected polynomial 0x82F63B78 */,
+		CRC16_CCITT /*! CRC-16/CCITT-FALSE, polynomial 0x1021 with initial value 0xFFFF (not XMODEM, which starts at 0x0000) */
+	};
+
+	enum {
+		FILE_CHUNK_SIZE /*! Number of bytes read from a file at a time by update(const sys::File&) */ =
+#if defined __link
+		4096
+#else
+		512
+#endif
+	};
+
+	/*! \details Constructs a new object for calculating a CRC.
+	 *
+	 * @param type The algorithm to use
+	 */
+	Crc(enum type type = CRC32);
+
+	/*! \details Returns the algorithm. */
+	enum type type() const { return m_type; }
+
+	/*! \details Restarts the calculation (discarding previous data). */
+	void start();
+
+	/*! \details Adds \a size bytes of \a data to the calculation.
+	 *
+	 * @param data A pointer to the data
+	 * @param size The number of bytes to add
+	 * @return A reference to this object
+	 */
+	Crc & update(const void * data, u32 size);
+
+	/*! \details Adds the contents of \a data to the calculation. */
+	Crc & update(const var::Data & data){ return update(data.to_void(), data.size()); }
+
+	/*! \details Reads \a file from its current location and adds
+	 * the data to the calculation.
+	 *
+	 * @param file The file to read
+	 * @param size The maximum number of bytes to read (the default reads to the end of the file)
+	 * @return The number of bytes added or less than zero if the file could not be read
+	 *
+	 */
+	int update(const sys::File & file, u32 size = (u32)-1);
+
+	/*! \details Adds the contents of \a a to the calculation. */
+	Crc & operator << (const var::Data & a){ return update(a); }
+
+	/*! \details Returns the CRC of the data added since the object was constructed or start() was called.
+	 *
+	 * The value may be read at any time. More data can be added afterwards.
+	 * CRC16 values are returned in the lower 16 bits.
+	 *
+	 */
+	u32 value() const;
+
+	/*! \details Calculates the CRC of \a size bytes of \a data. */
+	static u32 calculate(enum type type, const void * data, u32 size);
+
+	/*! \details Calculates the CRC of \a data. */
+	static u32 calculate(enum type type, const var::Data & data){
+		return calculate(type, data.to_void(), data.size());
+	}
+
+	/*! \details Returns true if \a type is calculated using processor CRC instructions. */
+	static bool is_accelerated(enum type type);
+
+private:
+	/*! \cond */
+	static u32 update_state(enum type type, u32 state, const u8 * data, u32 size);
+	static const u32 * tables(enum type type);
+	static u32 initial_state(enum type type){ return type == CRC16_CCITT ? 0xffff : 0xffffffff; }
+
+	enum type m_type;
+	u32 m_state;
+	/*! \endcond */
+};
+
+}
+
+#endif /* SAPI_CALC_CRC_HPP_ */
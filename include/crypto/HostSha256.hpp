@@ -0,0 +1,90 @@
+/*! \file */ //Copyright 2011-2019 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_CRYPTO_HOST_SHA256_HPP_
+#define SAPI_CRYPTO_HOST_SHA256_HPP_
+
+#if defined __link
+
+#include <mcu/types.h>
+#include "../api/InfoObject.hpp"
+
+/*! \cond */
+typedef struct {
+	u32 state[8];
+	u64 length; //total number of bytes hashed
+	u32 buffer_size; //bytes waiting in buffer for a complete block
+	u8 buffer[64];
+} host_sha256_context_t;
+/*! \endcond */
+
+namespace crypto {
+
+/*! \brief Host SHA-256 Class
+ * \details The Host SHA-256 class provides the SHA-256
+ * implementation used by crypto::Sha256 on the host (link) build.
+ *
+ * On the device, Sha256 uses the kernel's sha256_api() (which may be
+ * backed by a hardware accelerator). On the host, the blocks are
+ * compressed with the SHA extensions (SHA-NI) on x86 or the
+ * cryptography extensions on 64-bit ARM. If the CPU has neither, a
+ * portable C implementation is used. The best backend for the CPU is
+ * chosen the first time a block is hashed.
+ *
+ * \code
+ * #include <sapi/crypto.hpp>
+ *
+ * printf("SHA-256 backend is %s\n", HostSha256::backend_name());
+ * \endcode
+ *
+ */
+class HostSha256 : public api::InfoObject {
+public:
+
+	enum backend {
+		BACKEND_AUTO /*! Select the fastest backend that the CPU supports */,
+		BACKEND_SCALAR /*! Portable C implementation */,
+		BACKEND_SHA_NI /*! x86 SHA extensions */,
+		BACKEND_ARMV8 /*! 64-bit ARM cryptography extensions */
+	};
+
+	/*! \details Returns the backend used to compress blocks.
+	 *
+	 * This is never BACKEND_AUTO. The CPU is checked the first time this is called.
+	 *
+	 */
+	static enum backend backend();
+
+	/*! \details Returns the name of the active backend (e.g. "sha-ni"). */
+	static const char * backend_name();
+
+	/*! \details Returns true if \a value can run on this CPU. */
+	static bool is_backend_supported(enum backend value);
+
+	/*! \details Selects the backend used to compress blocks.
+	 *
+	 * @param value The backend to use (BACKEND_AUTO selects the fastest one)
+	 * @return Zero on success or less than zero if \a value isn't supported by the CPU
+	 *
+	 * The setting applies to all threads.
+	 *
+	 */
+	static int set_backend(enum backend value);
+
+	/*! \cond */
+	static void start(host_sha256_context_t * context);
+	static void update(host_sha256_context_t * context, const u8 * input, u32 size);
+	static void finish(host_sha256_context_t * context, u8 * output);
+	/*! \endcond */
+
+private:
+	static void compress(u32 * state, const u8 * blocks, u32 count);
+	static enum backend detect_backend();
+	static enum backend m_backend;
+
+};
+
+}
+
+#endif
+
+#endif // SAPI_CRYPTO_HOST_SHA256_HPP_
@@ -6,11 +6,49 @@
 #include "../api/CryptoObject.hpp"
 #include "../var/Array.hpp"
 #include "../var/String.hpp"
+#include "../var/Vector.hpp"
+#include "../sys/File.hpp"
+#if defined __link
+#include "HostSha256.hpp"
+#endif
 
 namespace crypto {
 
+/*! \brief SHA-256 Class
+ * \details The Sha256 class calculates SHA-256 hashes.
+ *
+ * On the device, the hash is calculated by the kernel's sha256_api(). On
+ * the host, HostSha256 is used (which uses the CPU's SHA instructions when
+ * they are available).
+ *
+ * \code
+ * #include <sapi/crypto.hpp>
+ *
+ * Sha256 hash;
+ * hash << data;
+ * printf("%s\n", hash.stringify().cstring());
+ *
+ * //verify many images at once using all of the host's cores
+ * Vector<String> paths; //paths to the images
+ * Vector< Array<u8,32> > hashes;
+ * if( Sha256::calculate_files(paths, hashes) < 0 ){
+ *   //at least one file could not be read (its hash is all zeros)
+ * }
+ * \endcode
+ *
+ */
 class Sha256 : public api::CryptoWorkObject {
 public:
+
+	enum {
+		FILE_CHUNK_SIZE /*! Number of bytes read from a file at a time by update(const sys::File&) */ =
+#if defined __link
+		65536
+#else
+		512
+#endif
+	};
+
 	Sha256();
 	~Sha256();
 	int initialize();
@@ -19,6 +57,15 @@ public:
 	int update(const char * input, u32 len);
 	int finish();
 
+	/*! \details Reads \a file from its current location and adds the data to the hash.
+	 *
+	 * @param file The file to read
+	 * @param size The maximum number of bytes to read (the default reads to the end of the file)
+	 * @return The number of bytes added or less than zero if the file could not be read
+	 *
+	 */
+	int update(const sys::File & file, u32 size = (u32)-1);
+
 	Sha256 & operator << ( const var::Data & a);
 	Sha256 & operator << ( const var::ConstString & a);
 	Sha256 & operator << ( const var::String & a);
@@ -26,7 +73,47 @@ public:
 	const var::Array<u8, 32> & output();
 	var::String stringify();
 
+	/*! \details Calculates the hashes of \a count independent inputs.
+	 *
+	 * @param inputs An array of \a count inputs
+	 * @param outputs An array of \a count hashes that is written with the result
+	 * @param count The number of inputs
+	 * @param thread_count The number of threads to use (0 uses one per core on the host)
+	 * @return Zero on success
+	 *
+	 * The inputs are divided between the threads as each thread finishes
+	 * its previous input. On the device, the inputs are hashed by the calling thread.
+	 *
+	 */
+	static int calculate(const var::Data * inputs, var::Array<u8, 32> * outputs, u32 count, u32 thread_count = 0);
+
+	/*! \details Calculates the hashes of the files in \a paths.
+	 *
+	 * @param paths The files to hash
+	 * @param outputs Is resized to hold one hash per path (in the same order)
+	 * @param thread_count The number of threads to use (0 uses one per core on the host)
+	 * @return Zero on success or less than zero if any file could not be read
+	 *
+	 * The hash of a file that can't be read is set to all zeros.
+	 *
+	 */
+	static int calculate_files(const var::Vector<var::String> & paths, var::Vector< var::Array<u8, 32> > & outputs, u32 thread_count = 0);
+
 private:
+	/*! \cond */
+	typedef struct {
+		const var::Data * inputs;
+		const var::Vector<var::String> * paths;
+		var::Array<u8, 32> * outputs;
+		u32 count;
+		volatile u32 next;
+		volatile u32 failures;
+	} job_t;
+	/*! \endcond */
+
+	static void * work(void * args);
+	static int run(job_t & job, u32 thread_count);
+
 	var::Array<u8,32> m_output;
 	void * m_context;
 	bool m_is_finished;
@@ -7,6 +7,7 @@
 #include "Drawing.hpp"
 #include "../sgfx/Vector.hpp"
 #include "../var/String.hpp"
+#include "../var/Vector.hpp"
 
 namespace draw {
 
@@ -59,6 +60,18 @@ typedef IconAttributes IconAttr;
  * The icon is looked up by name using any icon files that are installed
  * in any of the system assets locations.
  *
+ * Rasterized icons are kept in a least-recently-used cache that is shared
+ * by all Icon objects and limited to cache_size() bytes. An icon that is drawn
+ * again with the same name, size, rotation, bits per pixel and pen is
+ * copied from the cache without reading the icon file or rasterizing the
+ * vector path.
+ *
+ * \code
+ * #include <sapi/draw.hpp>
+ *
+ * Icon::set_cache_size(16384); //room for the toolbar icons
+ * Icon().set_name("home").draw(attr);
+ * \endcode
  *
  */
 
@@ -67,6 +80,10 @@ public:
 	/*! \details Construct an empty graphic */
 	Icon();
 
+	enum {
+		CACHE_SIZE_DEFAULT /*! Default number of bytes used to cache rasterized icons */ = 8192
+	};
+
 	/*! \details Icon rotation orientations */
 	enum {
 		RIGHT /*! \brief Point to the right */ = 0,
@@ -111,8 +128,53 @@ public:
 	 */
 	sgfx::Region bounds() const { return m_bounds; }
 
+	/*! \details Sets the number of bytes available for caching rasterized icons.
+	 *
+	 * @param value The cache budget in bytes (zero disables the cache)
+	 *
+	 * If the cache is already using more than \a value bytes, the least
+	 * recently used icons are removed.
+	 *
+	 */
+	static void set_cache_size(u32 value);
+
+	/*! \details Returns the number of bytes available for caching rasterized icons. */
+	static u32 cache_size(){ return m_cache_size; }
+
+	/*! \details Returns the number of bytes currently used by rasterized icons. */
+	static u32 cache_used(){ return m_cache_used; }
+
+	/*! \details Removes all rasterized icons from the cache.
+	 *
+	 * This should be called if the icon assets are changed.
+	 *
+	 */
+	static void clear_cache();
+
 private:
 	/*! \cond */
+	class CachedIcon {
+	public:
+		CachedIcon(){ m_age = 0; m_hash = 0; m_rotation = 0; m_is_valid = false; }
+		u32 m_age;
+		u32 m_hash;
+		s16 m_rotation;
+		bool m_is_valid;
+		sg_pen_t m_pen;
+		var::String m_name;
+		sgfx::Bitmap m_bitmap;
+	};
+
+	static void render(sgfx::Bitmap & bitmap, sgfx::VectorPath & vector_path, s16 rotation, const sgfx::Pen & pen);
+	const sgfx::Bitmap * find_cached(const DrawingScaledAttr & attr) const;
+	const sgfx::Bitmap * add_cached(const DrawingScaledAttr & attr, sgfx::VectorPath & vector_path) const;
+	static void evict_cached();
+
+	static var::Vector<CachedIcon> m_cache;
+	static u32 m_cache_used;
+	static u32 m_cache_size;
+	static u32 m_cache_age;
+
 	sg_region_t m_bounds;
 	var::String m_name;
 	s16 m_rotation;
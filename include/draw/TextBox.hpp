@@ -6,10 +6,7 @@
 #include "Drawing.hpp"
 #include "TextAttr.hpp"
 #include "../sgfx/Font.hpp"
-
-namespace var {
-class Tokenizer;
-}
+#include "../var/Vector.hpp"
 
 namespace draw {
 
@@ -17,6 +14,12 @@ namespace draw {
  * \details This class is a scrolling text box that can be used to show
  * long text messages.
  *
+ * The line breaks are computed once and cached along with the string,
+ * font and width they were computed for. The cache is rebuilt only when one
+ * of those changes. If text was only appended, just the last line is wrapped
+ * again. Drawing builds and draws only the visible lines, so scrolling a
+ * long text box doesn't measure the whole string on each frame.
+ *
  */
 class TextBox : public TextAttr, public Drawing {
 public:
@@ -29,6 +32,7 @@ public:
 	sg_size_t scroll_max() const { return m_scroll_max; }
 
 
+	/*! \details Returns the number of lines the text wraps to in \a w pixels (uses the layout cache). */
 	int count_lines(sg_size_t w);
 	static int count_lines(const sgfx::Font * font, sg_size_t w, const TextAttr & text_attr);
 
@@ -40,10 +44,32 @@ public:
 
 private:
 	/*! \cond */
+	typedef struct {
+		u32 offset;
+		u32 length;
+		int width;
+	} word_t;
+
+	typedef struct {
+		u32 word;
+		u32 count;
+		int width;
+		bool is_trailing_space;
+	} line_t;
+
 	sg_size_t m_scroll;
 	sg_size_t m_scroll_max;
 
-	static void build_line(const sgfx::Font * font, u32 & i, var::String & line, var::Tokenizer & tokens, int & build_len, sg_size_t w);
+	//the layout cache and the values it was computed for
+	var::String m_layout_string;
+	const sgfx::Font * m_layout_font;
+	sg_size_t m_layout_width;
+	var::Vector<word_t> m_words;
+	var::Vector<line_t> m_lines;
+
+	int update_layout(const sgfx::Font * font, sg_size_t w);
+	static void find_words(const sgfx::Font * font, const var::ConstString & text, u32 offset, var::Vector<word_t> & words);
+	static void wrap_lines(const sgfx::Font * font, sg_size_t w, const var::Vector<word_t> & words, u32 first_word, var::Vector<line_t> & lines);
 	/*! \endcond */
 
 };
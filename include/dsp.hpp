@@ -14,8 +14,13 @@
 namespace dsp {}
 
 #include "dsp/SignalData.hpp"
+#if defined __link
+#include "dsp/HostDsp.hpp"
+#else
 #include "dsp/Transform.hpp"
 #include "dsp/Filter.hpp"
+#include "dsp/FilterChain.hpp"
+#endif
 
 using namespace dsp;
 
@@ -22,6 +22,12 @@ public:
 	FirFilterQ15(const SignalQ15 & coefficients, u32 n_samples);
 	u32 samples() const { return m_state.count(); }
 
+	/*! \details Returns the largest number of samples that can be filtered per call. */
+	u32 block_size() const { return m_state.count() - instance()->numTaps + 1; }
+
+	/*! \details Clears the filter history so the next block starts from rest. */
+	void reset(){ m_state.fill(0); }
+
 private:
 	SignalQ15 m_state;
 
@@ -32,6 +38,12 @@ public:
 	FirFilterQ31(const SignalQ31 & coefficients, u32 n_samples);
 	u32 samples() const { return m_state.count(); }
 
+	/*! \details Returns the largest number of samples that can be filtered per call. */
+	u32 block_size() const { return m_state.count() - instance()->numTaps + 1; }
+
+	/*! \details Clears the filter history so the next block starts from rest. */
+	void reset(){ m_state.fill(0); }
+
 private:
 	SignalQ31 m_state;
 
@@ -43,6 +55,12 @@ public:
 	FirFilterF32(const SignalF32 & coefficients, u32 n_samples);
 	u32 samples() const { return m_state.count(); }
 
+	/*! \details Returns the largest number of samples that can be filtered per call. */
+	u32 block_size() const { return m_state.count() - instance()->numTaps + 1; }
+
+	/*! \details Clears the filter history so the next block starts from rest. */
+	void reset(){ m_state.fill(0); }
+
 private:
 	SignalF32 m_state;
 
@@ -70,6 +88,9 @@ public:
 	BiquadFilterQ15(const BiquadCoefficientsQ15 & coefficients, s8 post_shift = 0);
 	u32 samples() const { return m_state.count(); }
 
+	/*! \details Clears the state of each stage so the next block starts from rest. */
+	void reset(){ m_state.fill(0); }
+
 private:
 	SignalQ15 m_state;
 };
@@ -80,12 +101,12 @@ public:
 
 	u8 stages() const { return count() / 5; }
 
-	q31_t & b0(u32 stage){ return at(stage*6 + 0); }
-	q31_t & b1(u32 stage){ return at(stage*6 + 1); }
-	q31_t & b2(u32 stage){ return at(stage*6 + 2); }
+	q31_t & b0(u32 stage){ return at(stage*5 + 0); }
+	q31_t & b1(u32 stage){ return at(stage*5 + 1); }
+	q31_t & b2(u32 stage){ return at(stage*5 + 2); }
 
-	q31_t & a1(u32 stage){ return at(stage*6 + 3); }
-	q31_t & a2(u32 stage){ return at(stage*6 + 4); }
+	q31_t & a1(u32 stage){ return at(stage*5 + 3); }
+	q31_t & a2(u32 stage){ return at(stage*5 + 4); }
 
 private:
 
@@ -98,6 +119,9 @@ public:
 	BiquadFilterQ31(const BiquadCoefficientsQ31 & coefficients, s8 post_shift = 0);
 	u32 samples() const { return m_state.count(); }
 
+	/*! \details Clears the state of each stage so the next block starts from rest. */
+	void reset(){ m_state.fill(0); }
+
 private:
 	SignalQ31 m_state;
 };
@@ -108,12 +132,12 @@ public:
 
 	u8 stages() const { return count() / 5; }
 
-	float32_t & b0(u32 stage){ return at(stage*6 + 0); }
-	float32_t & b1(u32 stage){ return at(stage*6 + 1); }
-	float32_t & b2(u32 stage){ return at(stage*6 + 2); }
+	float32_t & b0(u32 stage){ return at(stage*5 + 0); }
+	float32_t & b1(u32 stage){ return at(stage*5 + 1); }
+	float32_t & b2(u32 stage){ return at(stage*5 + 2); }
 
-	float32_t & a1(u32 stage){ return at(stage*6 + 3); }
-	float32_t & a2(u32 stage){ return at(stage*6 + 4); }
+	float32_t & a1(u32 stage){ return at(stage*5 + 3); }
+	float32_t & a2(u32 stage){ return at(stage*5 + 4); }
 
 private:
 
@@ -125,6 +149,9 @@ public:
 	BiquadFilterF32(const BiquadCoefficientsF32 & coefficients);
 	u32 samples() const { return m_state.count(); }
 
+	/*! \details Clears the state of each stage so the next block starts from rest. */
+	void reset(){ m_state.fill(0); }
+
 private:
 	SignalF32 m_state;
 };
@@ -133,6 +160,15 @@ class FirDecimateFilterQ31 : public Filter<arm_fir_decimate_instance_q31> {
 public:
 	FirDecimateFilterQ31(const SignalQ31 & coefficients, u8 M, u32 n_samples);
 
+	/*! \details Returns the decimation factor. */
+	u8 factor() const { return instance()->M; }
+
+	/*! \details Returns the largest number of input samples that can be filtered per call. */
+	u32 block_size() const { return m_state.count() - instance()->numTaps + 1; }
+
+	/*! \details Clears the filter history so the next block starts from rest. */
+	void reset(){ m_state.fill(0); }
+
 private:
 	SignalQ31 m_state;
 
@@ -0,0 +1,334 @@
+#ifndef SAPI_DSP_FILTER_CHAIN_HPP_
+#define SAPI_DSP_FILTER_CHAIN_HPP_
+
+#include <cstring>
+#include <errno.h>
+#include "../api/DspObject.hpp"
+#include "SignalData.hpp"
+#include "Filter.hpp"
+
+namespace dsp {
+
+/*! \brief Streaming Filter Chain
+ *
+ * \details A filter chain pushes blocks of samples through a cascade
+ * of filter stages (FIR, biquad and, for q1.31, FIR decimation).
+ *
+ * Unlike SignalData::filter(), the chain is designed for streaming:
+ *
+ * - the stages keep their state between calls so consecutive blocks
+ *   are filtered as one continuous signal
+ * - blocks of any size are accepted; they are split internally into
+ *   chunks of at most block_size() samples
+ * - decimation stages hold back the samples that do not complete a
+ *   group of M until the next block arrives
+ * - the intermediate buffers are allocated once when the chain is
+ *   constructed and stages are added; process() does not allocate
+ *
+ * The chain does not own the filters. The filters (and their
+ * coefficients) must remain valid for the life of the chain.
+ *
+ * \code
+ * #include <sapi/dsp.hpp>
+ *
+ * FirFilterQ31 anti_alias(fir_coefficients, 64);
+ * FirDecimateFilterQ31 decimate(decimate_coefficients, 4, 64);
+ * BiquadFilterQ31 shape(biquad_coefficients);
+ *
+ * FilterChainQ31 chain(64);
+ * chain.add(anti_alias);
+ * chain.add(decimate);
+ * chain.add(shape);
+ *
+ * SignalQ31 output;
+ * while( read_samples(input) > 0 ){
+ *   //input can be any size, output is resized to fit the result
+ *   chain.process(input, output);
+ * }
+ * \endcode
+ *
+ */
+template<typename SignalType, typename T> class FilterChain : public api::DspWorkObject {
+public:
+
+	/*! \details Returns the maximum number of samples passed to a stage per call. */
+	u32 block_size() const { return m_block_size; }
+
+	/*! \details Returns the number of stages in the chain. */
+	u32 stages() const { return m_stages.count(); }
+
+	/*! \details Returns the number of samples the next call to process()
+	  * will produce for \a input_count samples.
+	  *
+	  * The result accounts for the samples that the decimation
+	  * stages are currently holding back.
+	  */
+	u32 output_count(u32 input_count) const {
+		for(u32 i=0; i < m_stages.count(); i++){
+			const stage_t & stage = m_stages.at(i);
+			if( stage.type == DECIMATE ){
+				input_count = (input_count + stage.pending) / stage.factor;
+			}
+		}
+		return input_count;
+	}
+
+	/*! \details Filters \a input and writes the result to \a output.
+	  *
+	  * @param input The next block of samples (any size)
+	  * @param output The filtered samples (resized to output_count())
+	  * @return The number of samples written to \a output or less than zero for an error
+	  *
+	  * \a output keeps its memory between calls so reusing the same
+	  * object allocates only until it has reached its largest size.
+	  *
+	  */
+	int process(const SignalType & input, SignalType & output){
+		output.resize( output_count(input.count()) );
+		return process(input.vector_data_const(), input.count(), output.vector_data());
+	}
+
+	/*! \details Filters \a count samples from \a input and writes the result to \a output.
+	  *
+	  * @param input A pointer to the next block of samples
+	  * @param count The number of samples in \a input
+	  * @param output Destination with room for at least output_count(\a count) samples
+	  * @return The number of samples written to \a output or less than zero for an error
+	  *
+	  * \a input and \a output must not overlap.
+	  *
+	  */
+	int process(const T * input, u32 count, T * output){
+		u32 result = 0;
+		if( m_block_size == 0 ){
+			set_error_number(ENOMEM);
+			return -1;
+		}
+		while( count ){
+			u32 chunk = count < m_block_size ? count : m_block_size;
+			result += process_block(input, chunk, output + result);
+			input += chunk;
+			count -= chunk;
+		}
+		return result;
+	}
+
+	/*! \details Clears the state of every stage as well as any
+	  * samples held back by decimation stages.
+	  */
+	void reset(){
+		for(u32 i=0; i < m_stages.count(); i++){
+			reset_filter(m_stages.at(i));
+			m_stages.at(i).pending = 0;
+		}
+	}
+
+protected:
+	/*! \cond */
+	enum {
+		FIR,
+		BIQUAD,
+		DECIMATE
+	};
+
+	typedef struct {
+		void * filter;
+		u32 limit; //largest block the filter accepts
+		u16 pending_offset; //location of held back samples in m_pending
+		u8 type;
+		u8 factor;
+		u8 pending; //number of samples held back for the next block
+	} stage_t;
+
+	FilterChain(u32 block_size){
+		m_block_size = block_size;
+		m_ping.resize(block_size);
+		m_pong.resize(block_size);
+		if( (m_ping.count() != block_size) || (m_pong.count() != block_size) ){
+			m_block_size = 0;
+		}
+	}
+
+	//runs a single filter on count samples (for decimation, count is a multiple of the factor)
+	virtual void execute(const stage_t & stage, const T * input, T * output, u32 count) = 0;
+	virtual void reset_filter(const stage_t & stage) = 0;
+
+	int add_stage(void * filter, u8 type, u32 limit, u8 factor = 1){
+		stage_t stage;
+		if( type != DECIMATE && limit < m_block_size ){
+			set_error_number(EINVAL);
+			return -1;
+		}
+
+		if( type == DECIMATE ){
+			if( (factor == 0) || (limit < factor) ){
+				set_error_number(EINVAL);
+				return -1;
+			}
+			//held back samples are merged with the next chunk
+			if( m_merge.count() < m_block_size + factor - 1 ){
+				m_merge.resize(m_block_size + factor - 1);
+			}
+			stage.pending_offset = m_pending.count();
+			m_pending.resize(m_pending.count() + factor - 1);
+		} else {
+			stage.pending_offset = 0;
+		}
+
+		stage.filter = filter;
+		stage.limit = limit;
+		stage.type = type;
+		stage.factor = factor;
+		stage.pending = 0;
+		m_stages.push_back(stage);
+		return 0;
+	}
+
+	/*! \endcond */
+
+private:
+
+	u32 process_block(const T * input, u32 count, T * output){
+		u32 n = m_stages.count();
+
+		if( n == 0 ){
+			::memcpy(output, input, count*sizeof(T));
+			return count;
+		}
+
+		for(u32 i=0; i < n; i++){
+			T * dest = (i == n-1) ? output : ((i & 1) ? m_pong.vector_data() : m_ping.vector_data());
+			stage_t & stage = m_stages.at(i);
+			if( stage.type == DECIMATE ){
+				count = decimate(stage, input, count, dest);
+				if( count == 0 ){ return 0; }
+			} else {
+				execute(stage, input, dest, count);
+			}
+			input = dest;
+		}
+
+		return count;
+	}
+
+	u32 decimate(stage_t & stage, const T * input, u32 count, T * output){
+		u32 result = 0;
+		u32 limit = (stage.limit / stage.factor) * stage.factor;
+
+		if( stage.pending ){
+			T * merge = m_merge.vector_data();
+			::memcpy(merge, m_pending.vector_data() + stage.pending_offset, stage.pending*sizeof(T));
+			::memcpy(merge + stage.pending, input, count*sizeof(T));
+			input = merge;
+			count += stage.pending;
+		}
+
+		while( count >= stage.factor ){
+			u32 step = (count / stage.factor) * stage.factor;
+			if( step > limit ){ step = limit; }
+			execute(stage, input, output + result, step);
+			result += step / stage.factor;
+			input += step;
+			count -= step;
+		}
+
+		stage.pending = count;
+		::memcpy(m_pending.vector_data() + stage.pending_offset, input, count*sizeof(T));
+		return result;
+	}
+
+	u32 m_block_size;
+	var::Vector<stage_t> m_stages;
+	SignalType m_ping;
+	SignalType m_pong;
+	SignalType m_merge;
+	SignalType m_pending;
+
+};
+
+/*! \brief Streaming Filter Chain for Fixed Point q1.15 format
+ * \details See FilterChain for details.
+ */
+class FilterChainQ15 : public FilterChain<SignalQ15, q15_t> {
+public:
+
+	/*! \details Constructs an empty chain.
+	  *
+	  * @param block_size The number of samples processed by each stage per call
+	  *
+	  * Every FIR filter added to the chain must have been constructed
+	  * with at least \a block_size samples.
+	  */
+	FilterChainQ15(u32 block_size) : FilterChain(block_size){}
+
+	/*! \details Appends a FIR stage to the chain. */
+	int add(FirFilterQ15 & filter){ return add_stage(&filter, FIR, filter.block_size()); }
+	/*! \details Appends a biquad cascade stage to the chain. */
+	int add(BiquadFilterQ15 & filter){ return add_stage(&filter, BIQUAD, block_size()); }
+
+private:
+	void execute(const stage_t & stage, const q15_t * input, q15_t * output, u32 count);
+	void reset_filter(const stage_t & stage);
+};
+
+/*! \brief Streaming Filter Chain for Fixed Point q1.31 format
+ * \details See FilterChain for details.
+ */
+class FilterChainQ31 : public FilterChain<SignalQ31, q31_t> {
+public:
+
+	/*! \details Constructs an empty chain.
+	  *
+	  * @param block_size The number of samples processed by each stage per call
+	  *
+	  * Every FIR filter added to the chain must have been constructed
+	  * with at least \a block_size samples.
+	  */
+	FilterChainQ31(u32 block_size) : FilterChain(block_size){}
+
+	/*! \details Appends a FIR stage to the chain. */
+	int add(FirFilterQ31 & filter){ return add_stage(&filter, FIR, filter.block_size()); }
+	/*! \details Appends a biquad cascade stage to the chain. */
+	int add(BiquadFilterQ31 & filter){ return add_stage(&filter, BIQUAD, block_size()); }
+
+	/*! \details Appends a FIR decimation stage to the chain.
+	  *
+	  * The decimator may have been constructed with any number of
+	  * samples that is a multiple of its factor; longer runs are split
+	  * to fit.
+	  */
+	int add(FirDecimateFilterQ31 & filter){ return add_stage(&filter, DECIMATE, filter.block_size(), filter.factor()); }
+
+private:
+	void execute(const stage_t & stage, const q31_t * input, q31_t * output, u32 count);
+	void reset_filter(const stage_t & stage);
+};
+
+/*! \brief Streaming Filter Chain for floating point
+ * \details See FilterChain for details.
+ */
+class FilterChainF32 : public FilterChain<SignalF32, float32_t> {
+public:
+
+	/*! \details Constructs an empty chain.
+	  *
+	  * @param block_size The number of samples processed by each stage per call
+	  *
+	  * Every FIR filter added to the chain must have been constructed
+	  * with at least \a block_size samples.
+	  */
+	FilterChainF32(u32 block_size) : FilterChain(block_size){}
+
+	/*! \details Appends a FIR stage to the chain. */
+	int add(FirFilterF32 & filter){ return add_stage(&filter, FIR, filter.block_size()); }
+	/*! \details Appends a biquad cascade stage to the chain. */
+	int add(BiquadFilterF32 & filter){ return add_stage(&filter, BIQUAD, block_size()); }
+
+private:
+	void execute(const stage_t & stage, const float32_t * input, float32_t * output, u32 count);
+	void reset_filter(const stage_t & stage);
+};
+
+}
+
+#endif // SAPI_DSP_FILTER_CHAIN_HPP_
@@ -0,0 +1,163 @@
+/*! \file */ //Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_DSP_HOST_DSP_HPP_
+#define SAPI_DSP_HOST_DSP_HPP_
+
+#if defined __link
+
+#include <mcu/types.h>
+#include "../api/InfoObject.hpp"
+
+/*! \cond */
+#if !defined __ARM_MATH_H
+typedef s8 q7_t;
+typedef s16 q15_t;
+typedef s32 q31_t;
+typedef s64 q63_t;
+typedef float float32_t;
+#endif
+
+/*
+ * These tables provide the subset of the arm_dsp_api_*_t
+ * functions that dsp::SignalData uses. The signatures
+ * match the CMSIS DSP functions so the same SignalData
+ * code is used on the device and on the host.
+ *
+ */
+typedef struct {
+	void (*mean)(q15_t * pSrc, u32 blockSize, q15_t * pResult);
+	void (*power)(q15_t * pSrc, u32 blockSize, q63_t * pResult);
+	void (*var)(q15_t * pSrc, u32 blockSize, q15_t * pResult);
+	void (*rms)(q15_t * pSrc, u32 blockSize, q15_t * pResult);
+	void (*std)(q15_t * pSrc, u32 blockSize, q15_t * pResult);
+	void (*min)(q15_t * pSrc, u32 blockSize, q15_t * pResult, u32 * pIndex);
+	void (*max)(q15_t * pSrc, u32 blockSize, q15_t * pResult, u32 * pIndex);
+	void (*abs)(q15_t * pSrc, q15_t * pDst, u32 blockSize);
+	void (*dot_prod)(q15_t * pSrcA, q15_t * pSrcB, u32 blockSize, q63_t * result);
+	void (*negate)(q15_t * pSrc, q15_t * pDst, u32 blockSize);
+	void (*shift)(q15_t * pSrc, s8 shiftBits, q15_t * pDst, u32 blockSize);
+	void (*scale)(q15_t * pSrc, q15_t scaleFract, s8 shift, q15_t * pDst, u32 blockSize);
+	void (*offset)(q15_t * pSrc, q15_t offset, q15_t * pDst, u32 blockSize);
+	void (*add)(q15_t * pSrcA, q15_t * pSrcB, q15_t * pDst, u32 blockSize);
+	void (*sub)(q15_t * pSrcA, q15_t * pSrcB, q15_t * pDst, u32 blockSize);
+	void (*mult)(q15_t * pSrcA, q15_t * pSrcB, q15_t * pDst, u32 blockSize);
+} host_dsp_api_q15_t;
+
+typedef struct {
+	void (*mean)(q31_t * pSrc, u32 blockSize, q31_t * pResult);
+	void (*power)(q31_t * pSrc, u32 blockSize, q63_t * pResult);
+	void (*var)(q31_t * pSrc, u32 blockSize, q31_t * pResult);
+	void (*rms)(q31_t * pSrc, u32 blockSize, q31_t * pResult);
+	void (*std)(q31_t * pSrc, u32 blockSize, q31_t * pResult);
+	void (*min)(q31_t * pSrc, u32 blockSize, q31_t * pResult, u32 * pIndex);
+	void (*max)(q31_t * pSrc, u32 blockSize, q31_t * pResult, u32 * pIndex);
+	void (*abs)(q31_t * pSrc, q31_t * pDst, u32 blockSize);
+	void (*dot_prod)(q31_t * pSrcA, q31_t * pSrcB, u32 blockSize, q63_t * result);
+	void (*negate)(q31_t * pSrc, q31_t * pDst, u32 blockSize);
+	void (*shift)(q31_t * pSrc, s8 shiftBits, q31_t * pDst, u32 blockSize);
+	void (*scale)(q31_t * pSrc, q31_t scaleFract, s8 shift, q31_t * pDst, u32 blockSize);
+	void (*offset)(q31_t * pSrc, q31_t offset, q31_t * pDst, u32 blockSize);
+	void (*add)(q31_t * pSrcA, q31_t * pSrcB, q31_t * pDst, u32 blockSize);
+	void (*sub)(q31_t * pSrcA, q31_t * pSrcB, q31_t * pDst, u32 blockSize);
+	void (*mult)(q31_t * pSrcA, q31_t * pSrcB, q31_t * pDst, u32 blockSize);
+} host_dsp_api_q31_t;
+
+typedef struct {
+	void (*mean)(float32_t * pSrc, u32 blockSize, float32_t * pResult);
+	void (*power)(float32_t * pSrc, u32 blockSize, float32_t * pResult);
+	void (*var)(float32_t * pSrc, u32 blockSize, float32_t * pResult);
+	void (*rms)(float32_t * pSrc, u32 blockSize, float32_t * pResult);
+	void (*std)(float32_t * pSrc, u32 blockSize, float32_t * pResult);
+	void (*min)(float32_t * pSrc, u32 blockSize, float32_t * pResult, u32 * pIndex);
+	void (*max)(float32_t * pSrc, u32 blockSize, float32_t * pResult, u32 * pIndex);
+	void (*abs)(float32_t * pSrc, float32_t * pDst, u32 blockSize);
+	void (*dot_prod)(float32_t * pSrcA, float32_t * pSrcB, u32 blockSize, float32_t * result);
+	void (*negate)(float32_t * pSrc, float32_t * pDst, u32 blockSize);
+	void (*scale)(float32_t * pSrc, float32_t scale, float32_t * pDst, u32 blockSize);
+	void (*offset)(float32_t * pSrc, float32_t offset, float32_t * pDst, u32 blockSize);
+	void (*add)(float32_t * pSrcA, float32_t * pSrcB, float32_t * pDst, u32 blockSize);
+	void (*sub)(float32_t * pSrcA, float32_t * pSrcB, float32_t * pDst, u32 blockSize);
+	void (*mult)(float32_t * pSrcA, float32_t * pSrcB, float32_t * pDst, u32 blockSize);
+} host_dsp_api_f32_t;
+
+extern const host_dsp_api_q15_t host_dsp_api_q15;
+extern const host_dsp_api_q31_t host_dsp_api_q31;
+extern const host_dsp_api_f32_t host_dsp_api_f32;
+/*! \endcond */
+
+namespace dsp {
+
+/*! \brief Host DSP Class
+ * \details The Host DSP class controls the kernels that
+ * implement the dsp::SignalData operations on the host (link) build.
+ *
+ * On the device, SignalQ15, SignalQ31 and SignalF32 call
+ * the CMSIS DSP library that the kernel provides. On the host,
+ * the same calls go to vectorized kernels. The kernels use SSE2 or AVX2 on x86
+ * and NEON on 64-bit ARM. The best backend for the CPU is chosen
+ * the first time a kernel runs.
+ *
+ * The Q15 and Q31 kernels match CMSIS DSP bit for bit, including
+ * saturation, truncation and the fixed-point square root used by
+ * rms() and std(). Data captured on a device can therefore be
+ * analyzed offline with the same results. The F32 element-wise
+ * operations are also exact. The F32 sums (mean(), power(), dot_product())
+ * add the values in a different order, so the last bits can differ.
+ *
+ * \code
+ * #include <sapi/dsp.hpp>
+ *
+ * printf("DSP backend is %s\n", HostDsp::backend_name());
+ *
+ * //compare against the reference implementation
+ * HostDsp::set_backend(HostDsp::BACKEND_SCALAR);
+ * q15_t reference = signal.rms();
+ * HostDsp::set_backend(HostDsp::BACKEND_AUTO);
+ * \endcode
+ *
+ */
+class HostDsp : public api::InfoObject {
+public:
+
+	enum backend {
+		BACKEND_AUTO /*! Select the fastest backend that the CPU supports */,
+		BACKEND_SCALAR /*! Portable C reference kernels */,
+		BACKEND_SSE2 /*! x86 SSE2 kernels */,
+		BACKEND_AVX2 /*! x86 AVX2 kernels */,
+		BACKEND_NEON /*! 64-bit ARM NEON kernels */
+	};
+
+	/*! \details Returns the backend the kernels are using.
+	 *
+	 * This is never BACKEND_AUTO. The CPU is checked the first time this is called.
+	 *
+	 */
+	static enum backend backend();
+
+	/*! \details Returns the name of the active backend (e.g. "avx2"). */
+	static const char * backend_name();
+
+	/*! \details Returns true if \a value can run on this CPU. */
+	static bool is_backend_supported(enum backend value);
+
+	/*! \details Selects the backend used by the kernels.
+	 *
+	 * @param value The backend to use (BACKEND_AUTO selects the fastest one)
+	 * @return Zero on success or less than zero if \a value isn't supported by the CPU
+	 *
+	 * The setting applies to all threads.
+	 *
+	 */
+	static int set_backend(enum backend value);
+
+private:
+	static enum backend detect_backend();
+	static enum backend m_backend;
+
+};
+
+}
+
+#endif
+
+#endif // SAPI_DSP_HOST_DSP_HPP_
@@ -143,6 +143,10 @@ public:
  * All signals are dynamically allocated using the var::Vector
  * class.
  *
+ * On the host (link) build, the operations use the kernels in
+ * dsp::HostDsp, which match the device results. Convolution,
+ * filters and transforms are only available on the device.
+ *
  */
 template<class Derived, typename T, typename BigType> class SignalData : public var::Vector<T>, public api::DspWorkObject {
 public:
@@ -494,7 +498,7 @@ public:
 	SignalQ15(){}
 
 	bool is_api_available() const {
-		return api_a7().is_valid();
+		return api_q15().is_valid();
 	}
 
 	q15_t mean() const;
@@ -511,8 +515,10 @@ public:
 	q63_t dot_product(const SignalQ15 & a) const;
 	SignalQ15 negate() const;
 	void negate(SignalQ15 & output) const;
+#if !defined __link
 	SignalQ15 convolve(const SignalQ15 & a) const ;
 	void convolve(SignalQ15 & output, const SignalQ15 & a) const ;
+#endif
 	void shift(SignalQ15 & output, s8 value) const;
 	SignalQ15 scale(q15_t scale_fraction, s8 shift = 0) const;
 	void scale(SignalQ15 & output, q15_t scale_fraction, s8 shift = 0) const;
@@ -532,6 +538,7 @@ public:
 	SignalQ15 & subtract_assign(const SignalQ15 & a);
 
 
+#if !defined __link
 	//Filters
 	SignalQ15 filter(const FirFilterQ15 & filter) const;
 	void filter(SignalQ15 & output, const FirFilterQ15 & filter) const;
@@ -543,6 +550,7 @@ public:
 	//void filter(SignalQ15 & output, const FirDecimateFilterQ15 & filter);
 
 	static SignalQ15 create_sin_wave(u32 wave_freauency, u32 sampling_frequency, u32 nsamples, q15_t phase = 0);
+#endif
 
 private:
 
@@ -568,9 +576,11 @@ public:
 		return api_q15().is_valid();
 	}
 
+#if !defined __link
 	SignalComplexQ15 transform(FftRealQ15 & fft, bool is_inverse = false);
 	void transform(SignalComplexQ15 & output, FftRealQ15 & fft, bool is_inverse = false);
 	void transform(FftComplexQ15 & fft, bool is_inverse = false, bool is_bit_reversal = false);
+#endif
 
 
 protected:
@@ -619,8 +629,10 @@ public:
 	q63_t dot_product(const SignalQ31 & a) const;
 	SignalQ31 negate() const ;
 	void negate(SignalQ31 & output) const ;
+#if !defined __link
 	SignalQ31 convolve(const SignalQ31 & a) const ;
 	void convolve(SignalQ31 & output, const SignalQ31 & a) const ;
+#endif
 	void shift(SignalQ31 & output, s8 value) const;
 	SignalQ31 scale(q31_t scale_fraction, s8 shift = 0) const;
 	void scale(SignalQ31 & output, q31_t scale_fraction, s8 shift = 0) const;
@@ -638,6 +650,7 @@ public:
 	SignalQ31 subtract(const SignalQ31 & a) const;
 	SignalQ31 & subtract_assign(const SignalQ31 & a);
 
+#if !defined __link
 	SignalQ31 filter(const FirFilterQ31 & filter) const;
 	void filter(SignalQ31 & output, const FirFilterQ31 & filter) const;
 	SignalQ31 filter(const BiquadFilterQ31 & filter) const;
@@ -653,6 +666,7 @@ public:
 	//void filter(const LmsNormalFilterQ31 & filter);
 
 	static SignalQ31 create_sin_wave(u32 wave_freauency, u32 sampling_frequency, u32 nsamples, q31_t phase = 0);
+#endif
 
 private:
 
@@ -679,10 +693,12 @@ public:
 
 	/*! \details Transforms this object and returns a new signal with the transformed data.
 	  */
+#if !defined __link
 	SignalComplexQ31 transform(FftRealQ31 & fft, bool is_inverse = false);
 	void transform(SignalComplexQ31 & output, FftRealQ31 & fft, bool is_inverse = false);
 
 	void transform(FftComplexQ31 & fft, bool is_inverse = false, bool is_bit_reversal = false);
+#endif
 
 
 protected:
@@ -737,8 +753,10 @@ public:
 	float32_t dot_product(const SignalF32 & a) const;
 	SignalF32 negate() const ;
 	void negate(SignalF32 & output) const ;
+#if !defined __link
 	SignalF32 convolve(const SignalF32 & a) const ;
 	void convolve(SignalF32 & output, const SignalF32 & a) const ;
+#endif
 	void shift(SignalF32 & output, s8 value) const;
 	SignalF32 scale(float32_t scale_fraction, s8 shift = 0) const;
 	void scale(SignalF32 & output, float32_t scale_fraction, s8 shift = 0) const;
@@ -756,6 +774,7 @@ public:
 	SignalF32 subtract(const SignalF32 & a) const;
 	SignalF32 & subtract_assign(const SignalF32 & a);
 
+#if !defined __link
 	//Filters
 	SignalF32 filter(const FirFilterF32 & filter) const;
 	void filter(SignalF32 & output, const FirFilterF32 & filter) const;
@@ -764,6 +783,7 @@ public:
 	void filter(SignalF32 & output, const BiquadFilterF32 & filter) const;
 
 	static SignalF32 create_sin_wave(float32_t wave_freauency, float32_t sampling_frequency, u32 nsamples, float32_t phase = 0);
+#endif
 
 private:
 
@@ -782,10 +802,12 @@ public:
 		return api_f32().is_valid();
 	}
 
+#if !defined __link
 	SignalComplexF32 transform(FftRealF32 & fft, bool is_inverse = false);
 	void transform(SignalComplexF32 & output, FftRealF32 & fft, bool is_inverse = false);
 
 	void transform(FftComplexF32 & fft, bool is_inverse = false, bool is_bit_reversal = false);
+#endif
 
 
 protected:
@@ -6,6 +6,14 @@
 
 namespace dsp {
 
+/*! \brief FFT Base Class
+ *
+ * \details The CMSIS initialization for each type and length
+ * is done once per process. Later objects of the same type and length
+ * copy the plan from a cache instead of initializing it again, so
+ * constructing a transform is cheap.
+ *
+ */
 template<typename T, typename SignalType> class Fft : public api::DspWorkObject {
 public:
 	const T * instance() const { return &m_instance; }
@@ -84,7 +92,28 @@ public:
 		return instance()->fftLenReal;
 	}
 
+	/*! \details Returns the number of values written for each frame by stft(). */
+	u32 spectrum_size() const { return samples()*2; }
+
+	/*! \details Computes a short-time Fourier transform of \a input.
+	  *
+	  * @param input The real input signal
+	  * @param window The analysis window (samples() values)
+	  * @param hop The number of samples between the start of each frame
+	  * @param frames The number of frames to compute (0 to compute as many as fit in \a input)
+	  * @param output Receives the spectra of all frames back to back (resized to frames * spectrum_size())
+	  * @return The number of frames computed or less than zero for an error
+	  *
+	  * Each frame of \a output holds the complex spectrum (samples()*2 values)
+	  * in natural order. The window is applied to a scratch buffer that
+	  * is allocated on the first call and then reused; no memory is
+	  * allocated per frame.
+	  *
+	  */
+	int stft(const SignalQ15 & input, const SignalQ15 & window, u32 hop, u32 frames, SignalQ15 & output);
+
 private:
+	SignalQ15 m_frame;
 };
 
 /*!
@@ -122,8 +151,28 @@ public:
 	/*! \details Returns the number of samples computed on each transform. */
 	u32 samples() const { return instance()->fftLenReal; }
 
+	/*! \details Returns the number of values written for each frame by stft(). */
+	u32 spectrum_size() const { return samples()*2; }
+
+	/*! \details Computes a short-time Fourier transform of \a input.
+	  *
+	  * @param input The real input signal
+	  * @param window The analysis window (samples() values)
+	  * @param hop The number of samples between the start of each frame
+	  * @param frames The number of frames to compute (0 to compute as many as fit in \a input)
+	  * @param output Receives the spectra of all frames back to back (resized to frames * spectrum_size())
+	  * @return The number of frames computed or less than zero for an error
+	  *
+	  * Each frame of \a output holds the complex spectrum (samples()*2 values)
+	  * in natural order. The window is applied to a scratch buffer that
+	  * is allocated on the first call and then reused; no memory is
+	  * allocated per frame.
+	  *
+	  */
+	int stft(const SignalQ31 & input, const SignalQ31 & window, u32 hop, u32 frames, SignalQ31 & output);
 
 private:
+	SignalQ31 m_frame;
 
 };
 
@@ -134,7 +183,28 @@ public:
 		return instance()->fftLenRFFT;
 	}
 
+	/*! \details Returns the number of values written for each frame by stft(). */
+	u32 spectrum_size() const { return samples(); }
+
+	/*! \details Computes a short-time Fourier transform of \a input.
+	  *
+	  * @param input The real input signal
+	  * @param window The analysis window (samples() values)
+	  * @param hop The number of samples between the start of each frame
+	  * @param frames The number of frames to compute (0 to compute as many as fit in \a input)
+	  * @param output Receives the spectra of all frames back to back (resized to frames * spectrum_size())
+	  * @return The number of frames computed or less than zero for an error
+	  *
+	  * Each frame of \a output holds the packed half spectrum (samples() values)
+	  * in natural order. The window is applied to a scratch buffer that
+	  * is allocated on the first call and then reused; no memory is
+	  * allocated per frame.
+	  *
+	  */
+	int stft(const SignalF32 & input, const SignalF32 & window, u32 hop, u32 frames, SignalF32 & output);
+
 private:
+	SignalF32 m_frame;
 
 };
 
@@ -7,12 +7,211 @@
 #include <unistd.h>
 #include "../var/String.hpp"
 #include "../var/ConstString.hpp"
+#include "../var/Vector.hpp"
 #include "../api/FmtObject.hpp"
 
 /*! \cond */
 
 namespace fmt {
 
+class XmlParser;
+
+/*! \brief XML Handler Class
+ * \details The XML Handler class receives events from
+ * fmt::XmlParser. Override the methods for the events
+ * that are needed. If a method returns a non-zero value,
+ * parsing stops and XmlParser::parse() returns that value.
+ *
+ * The strings passed to the handler are only valid during
+ * the call.
+ *
+ */
+class XmlHandler {
+public:
+	virtual ~XmlHandler(){}
+
+	/*! \details Called at the end of each start tag (or empty element tag). */
+	virtual int start_element(const XmlParser &, const var::ConstString & /*name*/){ return 0; }
+
+	/*! \details Called for each attribute of an element, right after start_element(). */
+	virtual int attribute(const XmlParser &, const var::ConstString & /*name*/, const var::ConstString & /*value*/){ return 0; }
+
+	/*! \details Called at the end of each end tag (and right after start_element() for empty element tags). */
+	virtual int end_element(const XmlParser &, const var::ConstString & /*name*/){ return 0; }
+
+	/*! \details Called with element text and with the contents of CDATA sections.
+	 *
+	 * Text that is only whitespace is not reported. Entities are not decoded.
+	 *
+	 */
+	virtual int cdata(const XmlParser &, const var::ConstString & /*text*/){ return 0; }
+};
+
+/*! \brief XML Parser Class
+ * \details The XML Parser class reads an XML file once, from
+ * start to end, through a read buffer and reports what it
+ * finds to an fmt::XmlHandler (a SAX-style parser).
+ *
+ * Unlike fmt::Xml, which reads and scans byte ranges again for each
+ * query, the parser reads each byte once and keeps only the
+ * current tag in memory.
+ *
+ * \code
+ * #include <sapi/fmt.hpp>
+ *
+ * class WaypointCounter : public XmlHandler {
+ * public:
+ *   int start_element(const XmlParser & parser, const ConstString & name){
+ *     if( name == "wpt" ){ count++; }
+ *     return 0;
+ *   }
+ *   int count = 0;
+ * };
+ *
+ * File file;
+ * file.open("/home/track.gpx", File::RDONLY);
+ * WaypointCounter counter;
+ * XmlParser().parse(file, counter);
+ * \endcode
+ *
+ */
+class XmlParser : public api::FmtWorkObject {
+public:
+
+	/*! \details Constructs a parser that reads \a buffer_size bytes at a time. */
+	XmlParser(u32 buffer_size = 512);
+
+	/*! \details Parses XML from \a file.
+	 *
+	 * @param file The file to read (must be open)
+	 * @param handler The object that receives events
+	 * @param offset The file offset to start parsing
+	 * @param size The maximum number of bytes to parse
+	 * @return Zero when the input is consumed, the non-zero value returned by a handler, or less than zero if the file could not be read
+	 *
+	 */
+	int parse(const sys::File & file, XmlHandler & handler, u32 offset = 0, u32 size = 0xffffffff);
+
+	/*! \details Returns the nesting depth of the element being reported (the root is zero). */
+	u32 depth() const { return m_depth; }
+
+	/*! \details Returns the file offset of the '<' of the tag being reported. */
+	u32 tag_offset() const { return m_tag_offset; }
+
+	/*! \details Returns the number of bytes in the tag being reported (including the brackets). */
+	u32 tag_size() const { return m_tag_size; }
+
+	/*! \details Returns true if the element being reported is an empty element tag. */
+	bool is_empty_element() const { return m_is_empty_element; }
+
+private:
+	int process(char c, u32 position);
+	int finish_start_tag(u32 position, bool is_empty);
+	int finish_end_tag(u32 position);
+	int flush_text();
+	void add_attribute();
+
+	enum {
+		STATE_TEXT,
+		STATE_TAG_OPEN,
+		STATE_START_NAME,
+		STATE_IN_TAG,
+		STATE_ATTRIBUTE_NAME,
+		STATE_AFTER_ATTRIBUTE_NAME,
+		STATE_BEFORE_VALUE,
+		STATE_QUOTED_VALUE,
+		STATE_VALUE,
+		STATE_EMPTY_TAG_CLOSE,
+		STATE_END_NAME,
+		STATE_PROCESSING_INSTRUCTION,
+		STATE_MARKUP,
+		STATE_DECLARATION,
+		STATE_COMMENT,
+		STATE_CDATA
+	};
+
+	XmlHandler * m_handler;
+	var::Data m_buffer;
+	var::StringBuilder m_name;
+	var::StringBuilder m_text;
+	var::StringBuilder m_attribute_name;
+	var::StringBuilder m_attribute_value;
+	var::StringBuilder m_attributes; //name and value pairs separated by zeros
+	u32 m_attribute_count;
+	u32 m_state;
+	u32 m_depth;
+	u32 m_tag_offset;
+	u32 m_tag_size;
+	u32 m_match_count; //closing characters seen so far for comments, CDATA and instructions
+	u32 m_bracket_depth;
+	char m_quote;
+	bool m_is_empty_element;
+};
+
+/*! \brief XML Index Class
+ * \details The XML Index class records the location of every
+ * element in an XML file in one pass with fmt::XmlParser.
+ *
+ * Paths in the format used by fmt::Xml::find() (such as "gpx.wpt[1].name")
+ * are then resolved by searching the index in memory rather than
+ * scanning the file. Each index entry uses 20 bytes.
+ *
+ */
+class XmlIndex : public XmlHandler {
+public:
+
+	/*! \details Holds the location of one element. */
+	typedef struct {
+		u32 offset /*! Offset of the start tag */;
+		u32 size /*! Size including the start and end tags */;
+		u16 start_tag_size /*! Size of the start tag */;
+		u16 end_tag_size /*! Size of the end tag (zero for an empty element) */;
+		u32 name_hash /*! Hash of the element name */;
+		u16 name_length /*! Length of the element name */;
+		u16 resd;
+	} entry_t;
+
+	/*! \details Builds the index for \a file (the previous index is discarded). */
+	int build(const sys::File & file);
+
+	/*! \details Discards the index. */
+	void clear(){ m_entries.free(); m_open.free(); }
+
+	/*! \details Returns the number of elements in the index. */
+	u32 count() const { return m_entries.count(); }
+
+	/*! \details Returns the entry at \a n. */
+	const entry_t & at(u32 n) const { return m_entries.at(n); }
+
+	/*! \details Finds the element described by \a path.
+	 *
+	 * @param file The file the index was built from (used to confirm names)
+	 * @param path The path to the element (like "gpx.wpt[1]")
+	 * @param parent The entry to search within or -1 for the whole document
+	 * @return The entry index or less than zero if the element doesn't exist
+	 *
+	 * Each path segment matches the first (or n-th for "name[n]") element with that name
+	 * anywhere inside the previous match, as fmt::Xml::find() does.
+	 *
+	 */
+	int find(const sys::File & file, const var::ConstString & path, int parent = -1) const;
+
+	/*! \details Returns the entry whose start tag is at \a offset or less than zero if there isn't one. */
+	int find_offset(u32 offset) const;
+
+	int start_element(const XmlParser & parser, const var::ConstString & name);
+	int end_element(const XmlParser & parser, const var::ConstString & name);
+
+	static u32 calculate_hash(const char * name, u32 length);
+
+private:
+	u32 next_outside(u32 entry) const;
+	bool is_name_match(const sys::File & file, u32 entry, const char * name, u32 length, u32 hash) const;
+
+	var::Vector<entry_t> m_entries;
+	var::Vector<u32> m_open;
+};
+
 /*! \brief XML Class
  * \details This class is used to read values from an XML file.  It can also be used to create
  * new XML files, but has limited ability to modify XML files.
@@ -68,9 +267,26 @@ public:
 
 	inline int close(){
 		file_size = 0;
+		m_index.clear();
 		return File::close();
 	}
 
+	/*! \details Builds an index of every element in the file.
+	 *
+	 * After the index is built, find(), find_next() and get_value()
+	 * use it to locate elements instead of scanning the file. The index
+	 * must be rebuilt (or freed) if the file is modified.
+	 *
+	 * @return Zero on success or less than zero if the file couldn't be parsed
+	 */
+	int build_index();
+
+	/*! \details Frees the memory used by the index. */
+	void free_index(){ m_index.clear(); }
+
+	/*! \details Returns true if an index has been built. */
+	bool is_indexed() const { return m_index.count() > 0; }
+
 	inline int exit(){ return close(); }
 
 	/*! \brief Get the value of the XML element
@@ -264,12 +480,14 @@ private:
 
 	context_t content;
 	s32 file_size;
+	XmlIndex m_index;
 
 	int indent;
 
 	void reset_context();
 
 	int find_context(const var::ConstString & str, const context_t & current, context_t & target) const;
+	int find_indexed_context(const var::ConstString & str, const context_t & current, context_t & target) const;
 
 	int check_string_for_open_bracket(var::String * src, var::String * cmp) const;
 
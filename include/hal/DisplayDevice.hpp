@@ -14,6 +14,22 @@ namespace hal {
  * both Display and Dev so that a display
  * found at, for example, "/dev/display0" can
  * be drawn on.
+ *
+ * By default, refresh() sends the entire bitmap to the display. On
+ * panels with a slow bus (such as SPI), set_refresh_mode() can
+ * limit each refresh to the regions that were drawn since the last one.
+ *
+ * \code
+ * #include <sapi/hal.hpp>
+ *
+ * DisplayDevice display;
+ * display.initialize("/dev/display0");
+ * display.set_refresh_mode(DisplayDevice::REFRESH_CHANGED);
+ *
+ * display.draw_rectangle(Point(0,0), Area(16,16));
+ * display.refresh(); //sends only the rows of the rectangle that changed
+ * \endcode
+ *
  */
 class DisplayDevice : public Display, public Device {
 public:
@@ -25,9 +41,38 @@ public:
 	 *
 	 * This method will cause the driver to write the
 	 * current video memory to the display.
+	 *
+	 * If refresh_mode() is not REFRESH_FULL, only the damaged regions
+	 * (see sgfx::Bitmap::damage_count()) are written, one window at a time,
+	 * and the damage list is cleared.
 	 */
 	void refresh() const;
 
+	/*! \details Display refresh strategies */
+	enum refresh_mode {
+		REFRESH_FULL /*! refresh() writes the entire bitmap (default) */,
+		REFRESH_DAMAGED /*! refresh() writes only the regions changed by draw calls */,
+		REFRESH_CHANGED /*! Like REFRESH_DAMAGED but rows that match the last frame written are skipped */
+	};
+
+	/*! \details Sets how refresh() writes the bitmap to the display.
+	 *
+	 * @param value The refresh strategy
+	 * @return Zero on success or less than zero if memory for the shadow frame could not be allocated
+	 *
+	 * REFRESH_DAMAGED and REFRESH_CHANGED turn on damage tracking for the
+	 * bitmap. REFRESH_CHANGED also keeps a copy of the last frame written
+	 * (the same size as the bitmap) and compares each damaged row against it.
+	 * If the bitmap hasn't been allocated yet (see initialize()), the copy
+	 * is allocated by the first refresh(). Until the copy is available,
+	 * refresh() writes the entire bitmap.
+	 *
+	 */
+	int set_refresh_mode(enum refresh_mode value);
+
+	/*! \details Returns the refresh strategy. */
+	enum refresh_mode refresh_mode() const { return m_refresh_mode; }
+
 	void clear();
 
 	int set_window(const sgfx::Region & region);
@@ -56,6 +101,16 @@ public:
 	int disable() const;
 
 	using Data::size;
+
+private:
+	/*! \cond */
+	int refresh_window(const sg_region_t & region) const;
+	void refresh_changed_rows(sg_region_t region) const;
+
+	enum refresh_mode m_refresh_mode;
+	mutable var::Data m_shadow;
+	mutable bool m_is_shadow_valid;
+	/*! \endcond */
 };
 
 } /* namespace hal */
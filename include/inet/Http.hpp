@@ -206,6 +206,7 @@ private:
 
 	/*! \cond */
 	SocketAddress m_address;
+	sys::BufferedFile m_socket_buffer; //reads header lines and data from socket()
 	var::String m_transfer_encoding;
 	var::Vector<HttpHeaderPair> m_header_request_pairs;
 	var::Vector<HttpHeaderPair> m_header_response_pairs;
@@ -50,6 +50,29 @@ private:
 /*! \brief Bitmap Class
  * \details This class implements a bitmap and is
  * powered by the sgfx library.
+ *
+ * A bitmap can keep a list of the regions that draw calls have changed
+ * (see set_damage_tracking()). Overlapping and touching regions are merged,
+ * and the list never has more than DAMAGE_REGION_MAX entries. A display can use
+ * the list to send only the changed parts of the bitmap to the panel.
+ *
+ * \code
+ * #include <sapi/sgfx.hpp>
+ *
+ * Bitmap bitmap(128,64);
+ * bitmap.set_damage_tracking();
+ * bitmap.draw_rectangle(Point(4,4), Area(10,10));
+ * bitmap.draw_line(Point(40,0), Point(40,20));
+ * for(u32 i=0; i < bitmap.damage_count(); i++){
+ *   Region region = bitmap.damage_at(i);
+ *   //copy region to the panel
+ * }
+ * bitmap.clear_damage();
+ * \endcode
+ *
+ * Code that changes the bitmap memory directly (for example, using bmap_data())
+ * should call add_damage() for the changed region.
+ *
  */
 class Bitmap : virtual public var::Data, public api::SgfxObject {
 public:
@@ -102,12 +125,14 @@ public:
 	Bitmap(const Bitmap & bitmap) : var::Data(bitmap){
 		m_bmap = bitmap.m_bmap;
 		m_bmap.data = to<sg_bmap_data_t>();
+		m_damage = 0;
 	}
 
 	Bitmap & operator = (const Bitmap & bitmap){
 		copy_contents(bitmap);
 		m_bmap = bitmap.m_bmap;
 		m_bmap.data = to<sg_bmap_data_t>();
+		damage_all();
 		return *this;
 	}
 
@@ -124,6 +149,8 @@ public:
 
 	Bitmap(Bitmap && bitmap): var::Data(bitmap){
 		m_bmap = bitmap.m_bmap;
+		m_damage = bitmap.m_damage;
+		bitmap.m_damage = 0;
 	}
 
 	/*! \details Returns a copy of the bitmap's pen. */
@@ -218,9 +245,9 @@ public:
 	/*! \details Free memory associated with bitmap (auto freed on ~Bitmap) */
 	int free();
 
-	void transform_flip_x() const { api()->transform_flip_x(bmap()); }
-	void transform_flip_y() const { api()->transform_flip_y(bmap()); }
-	void transform_flip_xy() const { api()->transform_flip_xy(bmap()); }
+	void transform_flip_x() const { api()->transform_flip_x(bmap()); damage_all(); }
+	void transform_flip_y() const { api()->transform_flip_y(bmap()); damage_all(); }
+	void transform_flip_xy() const { api()->transform_flip_xy(bmap()); damage_all(); }
 
 	/*! \details Performs a shift operation on an area of the bitmap.
 	 *
@@ -237,7 +264,13 @@ public:
 	 *
 	 *
 	 */
-	void transform_shift(sg_point_t shift, const sg_region_t & region) const { api()->transform_shift(bmap(), shift, &region); }
+	void transform_shift(sg_point_t shift, const sg_region_t & region) const {
+		api()->transform_shift(bmap(), shift, &region);
+		if( m_damage ){
+			add_damage(region);
+			add_damage(Region(Point(region.point.x + shift.x, region.point.y + shift.y), region.area));
+		}
+	}
 	void transform_shift(sg_point_t shift, sg_point_t p, sg_area_t d) const { transform_shift(shift, Region(p,d)); }
 
 
@@ -256,7 +289,7 @@ public:
 	 *
 	 * \sa set_pen_color()
 	 */
-	void draw_pixel(const Point & p) const { api()->draw_pixel(bmap(), p); }
+	void draw_pixel(const Point & p) const { api()->draw_pixel(bmap(), p); damage_points(p, p); }
 
 	/*! \details Draws a line on the bitmap.
 	 *
@@ -266,11 +299,18 @@ public:
 	 * The bitmap's pen will determine the color, thickness, and drawing mode.
 	 *
 	 */
-	void draw_line(const Point & p1, const Point & p2) const { api()->draw_line(bmap(), p1, p2); }
-	void draw_quadratic_bezier(const Point & p1, const Point & p2, const Point & p3, sg_point_t * corners = 0) const { api()->draw_quadratic_bezier(bmap(), p1, p2, p3, corners); }
-	void draw_cubic_bezier(const Point & p1, const Point & p2, const Point & p3, const Point & p4, sg_point_t * corners = 0) const { api()->draw_cubic_bezier(bmap(), p1, p2, p3, p4, corners); }
+	void draw_line(const Point & p1, const Point & p2) const { api()->draw_line(bmap(), p1, p2); damage_points(p1, p2); }
+	void draw_quadratic_bezier(const Point & p1, const Point & p2, const Point & p3, sg_point_t * corners = 0) const {
+		api()->draw_quadratic_bezier(bmap(), p1, p2, p3, corners);
+		damage_points(p1, p2, p3);
+	}
+	void draw_cubic_bezier(const Point & p1, const Point & p2, const Point & p3, const Point & p4, sg_point_t * corners = 0) const {
+		api()->draw_cubic_bezier(bmap(), p1, p2, p3, p4, corners);
+		damage_points(p1, p2, p3, p4);
+	}
 	void draw_arc(const Region & region, s16 start, s16 end, s16 rotation = 0, sg_point_t * corners = 0) const {
 		api()->draw_arc(bmap(), &region.region(), start, end, rotation, corners);
+		damage_points(region.point(), Point(region.point().x() + region.area().width() - 1, region.point().y() + region.area().height() - 1));
 	}
 	void draw_arc(const Point & p, const Area & d, s16 start, s16 end, s16 rotation = 0) const { draw_arc(Region(p,d), start, end, rotation); }
 
@@ -281,7 +321,7 @@ public:
 	 * The bitmap's pen color and drawing mode will affect how the rectangle is drawn. This method
 	 * affects every pixel in the rectangle not just the border.
 	 */
-	void draw_rectangle(const Region & region) const { api()->draw_rectangle(bmap(), &region.region()); }
+	void draw_rectangle(const Region & region) const { api()->draw_rectangle(bmap(), &region.region()); damage(region); }
 	void draw_rectangle(const Point & p, const Area & d) const { draw_rectangle(Region(p,d)); }
 
 	/*! \details Pours an area on the bitmap.
@@ -292,7 +332,7 @@ public:
 	 * The pour will seek boundaries going outward until it hits
 	 * a non-zero color or hits the bounding box.
 	 */
-	void draw_pour(const Point & point, const Region & bounds) const { api()->draw_pour(bmap(), point, &bounds.region()); }
+	void draw_pour(const Point & point, const Region & bounds) const { api()->draw_pour(bmap(), point, &bounds.region()); damage(bounds); }
 
 	/*! \details This function sets the pixels in a bitmap
 	 * based on the pixels of the source bitmap
@@ -303,6 +343,7 @@ public:
 	 */
 	void draw_bitmap(const Point & p_dest, const Bitmap & src) const {
 		api()->draw_bitmap(bmap(), p_dest, src.bmap());
+		damage(Region(p_dest, src.area()));
 	}
 
 	/*!
@@ -323,6 +364,7 @@ public:
 	 */
 	void draw_pattern(const Region & region, sg_bmap_data_t odd_pattern, sg_bmap_data_t even_pattern, sg_size_t pattern_height) const {
 		api()->draw_pattern(bmap(), &region.region(), odd_pattern, even_pattern, pattern_height);
+		damage(region);
 	}
 	void draw_pattern(const Point & p, const Area & d, sg_bmap_data_t odd_pattern, sg_bmap_data_t even_pattern, sg_size_t pattern_height) const {
 		draw_pattern(Region(p,d), odd_pattern, even_pattern, pattern_height);
@@ -338,6 +380,7 @@ public:
 	 */
 	void draw_sub_bitmap(const Point & p_dest, const Bitmap & src, const Region & region_src) const {
 		api()->draw_sub_bitmap(bmap(), p_dest, src.bmap(), &region_src.region());
+		damage(Region(p_dest, region_src.area()));
 	}
 
 
@@ -356,6 +399,7 @@ public:
 		m_bmap.pen.o_flags = SG_PEN_FLAG_IS_INVERT;
 		api()->draw_rectangle(bmap(), &region);
 		m_bmap.pen.o_flags = o_flags;
+		damage(region);
 	}
 
 	void clear_rectangle(const Point & p, const Area & d){
@@ -365,8 +409,49 @@ public:
 		m_bmap.pen.o_flags = SG_PEN_FLAG_IS_ERASE;
 		api()->draw_rectangle(bmap(), &region);
 		m_bmap.pen.o_flags = o_flags;
+		damage(region);
 	}
 
+	/*! \details Sets every pixel in the bitmap to zero. */
+	virtual void clear(){ Data::clear(); damage_all(); }
+
+	enum {
+		DAMAGE_REGION_MAX /*! Maximum number of damaged regions that are tracked before regions are merged */ = 8
+	};
+
+	/*! \details Enables or disables tracking of the regions changed by draw calls.
+	 *
+	 * @param value True to track damaged regions
+	 * @return Zero on success or less than zero if memory could not be allocated
+	 *
+	 * When tracking is enabled, the entire bitmap is marked as damaged.
+	 *
+	 */
+	int set_damage_tracking(bool value = true);
+
+	/*! \details Returns true if damaged regions are being tracked. */
+	bool is_damage_tracking() const { return m_damage != 0; }
+
+	/*! \details Returns the number of damaged regions. */
+	u32 damage_count() const { return m_damage ? m_damage->count : 0; }
+
+	/*! \details Returns the damaged region at \a i. */
+	Region damage_at(u32 i) const;
+
+	/*! \details Returns a region that contains every damaged region. */
+	Region damage_bounds() const;
+
+	/*! \details Adds \a region to the damaged regions (clipped to the bitmap).
+	 *
+	 * The region is merged with any region it overlaps or touches. If the
+	 * list is full, it is merged with the region whose bounds grow the least.
+	 *
+	 */
+	void add_damage(const Region & region) const;
+
+	/*! \details Clears the damaged regions (usually after they are sent to a display). */
+	void clear_damage() const { if( m_damage ){ m_damage->count = 0; } }
+
 
 	/*! \details This method is designated as an interface
 	 * for classes that inherit Bitmap to copy the bitmap to a physical
@@ -437,8 +522,24 @@ protected:
 
 private:
 
-	sg_color_t calculate_color_sum();
+	/*! \cond */
+	typedef struct {
+		u32 count;
+		sg_region_t region[DAMAGE_REGION_MAX];
+	} damage_t;
+	/*! \endcond */
+
+	void damage(const Region & region) const { if( m_damage ){ add_damage(region); } }
+	void damage_all() const { if( m_damage ){ add_damage(Region(Point(0,0), area())); } }
+	void damage_points(const Point & p1, const Point & p2) const { if( m_damage ){ add_damage_points(p1, p2, p2, p2); } }
+	void damage_points(const Point & p1, const Point & p2, const Point & p3) const { if( m_damage ){ add_damage_points(p1, p2, p3, p3); } }
+	void damage_points(const Point & p1, const Point & p2, const Point & p3, const Point & p4) const { if( m_damage ){ add_damage_points(p1, p2, p3, p4); } }
+	void add_damage_points(const Point & p1, const Point & p2, const Point & p3, const Point & p4) const;
+
+	sg_int_t find_pixel(sg_int_t y, sg_int_t x0, sg_int_t x1, bool is_reverse) const;
+	bool clip_region(sg_region_t & region) const;
 	sg_bmap_t m_bmap;
+	damage_t * m_damage;
 
 	void initialize_members();
 	void calculate_members(const Area & dim);
@@ -14,38 +14,62 @@
 
 namespace sgfx {
 
+/*! \brief Cursor Class
+ * \details The Cursor class walks the pixels of a bitmap.
+ *
+ * Pixels that are written with the cursor (draw_pixel(), draw_hline(),
+ * draw_cursor(), shift_right() and shift_left()) are added to the
+ * bitmap's damaged regions (see Bitmap::set_damage_tracking()). The damage
+ * starts at the column where the cursor was set and covers the rest of the row.
+ *
+ */
 class Cursor :	public api::SgfxWorkObject {
 public:
 	Cursor();
 	virtual ~Cursor();
 
 
-	void set(const Bitmap & bitmap, const Point & p){ api()->cursor_set(&m_cursor, bitmap.bmap(), p); }
-	void update(const Point & p){ api()->cursor_update(&m_cursor, p); }
-	void increment_x(){ api()->cursor_inc_x(&m_cursor); }
-	void decrement_x(){ api()->cursor_dec_x(&m_cursor); }
-	void increment_y(){ api()->cursor_inc_y(&m_cursor); }
-	void decrement_y(){ api()->cursor_dec_y(&m_cursor); }
+	void set(const Bitmap & bitmap, const Point & p){
+		api()->cursor_set(&m_cursor, bitmap.bmap(), p);
+		m_bitmap = &bitmap;
+		m_point = p;
+	}
+	void update(const Point & p){ api()->cursor_update(&m_cursor, p); m_point = p; }
+	void increment_x(){ api()->cursor_inc_x(&m_cursor); m_point.point().x++; }
+	void decrement_x(){ api()->cursor_dec_x(&m_cursor); m_point.point().x--; }
+	void increment_y(){ api()->cursor_inc_y(&m_cursor); m_point.point().y++; }
+	void decrement_y(){ api()->cursor_dec_y(&m_cursor); m_point.point().y--; }
 	sg_color_t get_pixel(){ return api()->cursor_get_pixel(&m_cursor); }
 	sg_color_t get_pixel(int x_direction, int y_direction){
 		return api()->cursor_get_pixel_increment(&m_cursor, x_direction, y_direction); }
-	void draw_pixel() { api()->cursor_draw_pixel(&m_cursor); }
-	void draw_hline(sg_size_t width){ api()->cursor_draw_hline(&m_cursor, width); }
-	void draw_cursor(const Cursor & src, sg_size_t width){ api()->cursor_draw_cursor(&m_cursor, &src.m_cursor, width); }
-	void shift_right(sg_size_t shift_width, sg_size_t shift_distance){ api()->cursor_shift_right(&m_cursor, shift_width, shift_distance); }
-	void shift_left(sg_size_t shift_width, sg_size_t shift_distance){ api()->cursor_shift_left(&m_cursor, shift_width, shift_distance); }
+	void draw_pixel() { api()->cursor_draw_pixel(&m_cursor); damage_row(); }
+	void draw_hline(sg_size_t width){ api()->cursor_draw_hline(&m_cursor, width); damage_row(); }
+	void draw_cursor(const Cursor & src, sg_size_t width){ api()->cursor_draw_cursor(&m_cursor, &src.m_cursor, width); damage_row(); }
+	void shift_right(sg_size_t shift_width, sg_size_t shift_distance){ api()->cursor_shift_right(&m_cursor, shift_width, shift_distance); damage_row(); }
+	void shift_left(sg_size_t shift_width, sg_size_t shift_distance){ api()->cursor_shift_left(&m_cursor, shift_width, shift_distance); damage_row(); }
 
-	void inc_x(){ api()->cursor_inc_x(&m_cursor); }
-	void dec_x(){ api()->cursor_dec_x(&m_cursor); }
-	void inc_y(){ api()->cursor_inc_y(&m_cursor); }
-	void dec_y(){ api()->cursor_dec_y(&m_cursor); }
+	void inc_x(){ increment_x(); }
+	void dec_x(){ decrement_x(); }
+	void inc_y(){ increment_y(); }
+	void dec_y(){ decrement_y(); }
 
 	sg_cursor_t & cursor() { return m_cursor; }
 	const sg_cursor_t & cursor() const { return m_cursor; }
 	operator const sg_cursor_t & () const { return m_cursor; }
 
 private:
+	/*! \cond */
+	//drawing advances the cursor without updating m_point so the damage runs to the end of the row
+	void damage_row() const {
+		if( m_bitmap && m_bitmap->is_damage_tracking() && (m_point.x() < m_bitmap->width()) ){
+			m_bitmap->add_damage(Region(m_point, Area(m_bitmap->width() - m_point.x(), 1)));
+		}
+	}
+
 	sg_cursor_t m_cursor;
+	const Bitmap * m_bitmap;
+	Point m_point;
+	/*! \endcond */
 };
 
 } /* namespace sgfx */
@@ -6,6 +6,7 @@
 #include "Font.hpp"
 #include "../sys/File.hpp"
 #include "../var/ConstString.hpp"
+#include "../var/Vector.hpp"
 
 namespace sgfx {
 
@@ -13,6 +14,23 @@ namespace sgfx {
  * \details The File Font class is used to access
  * fonts that are stored as files.
  *
+ * When the font is loaded, the character metrics table is read
+ * into memory with one read, and the kerning pairs are sorted
+ * so they can be searched with a binary search.
+ *
+ * Glyph bitmaps are cut out of the font canvas
+ * the first time they are drawn. They are kept in a
+ * least-recently-used cache that is limited to
+ * glyph_cache_size() bytes. Redrawing a cached glyph doesn't access the file.
+ *
+ * \code
+ * #include <sapi/sgfx.hpp>
+ *
+ * FileFont font("/home/fonts/sans-r-16.sbf");
+ * font.set_glyph_cache_size(8192);
+ * font.preload("0123456789:.%"); //glyphs used by the status screen
+ * \endcode
+ *
  */
 class FileFont : public Font {
 public:
@@ -20,23 +38,85 @@ public:
 	FileFont(const var::ConstString & name, int offset = 0);
 	~FileFont();
 
+	enum {
+		GLYPH_CACHE_SIZE_DEFAULT /*! Default number of bytes used to cache glyph bitmaps */ = 4096
+	};
+
 	int set_file(const var::ConstString & name, int offset = 0);
 
 	sg_size_t get_height() const;
 	sg_size_t get_width() const;
 
+	/*! \details Sets the number of bytes available for caching glyph bitmaps.
+	 *
+	 * @param value The cache budget in bytes (zero disables the cache)
+	 *
+	 * If the cache is already using more than \a value bytes, the least
+	 * recently used glyphs are removed.
+	 *
+	 */
+	void set_glyph_cache_size(u32 value);
+
+	/*! \details Returns the number of bytes available for caching glyph bitmaps. */
+	u32 glyph_cache_size() const { return m_glyph_cache_size; }
+
+	/*! \details Returns the number of bytes currently used by cached glyph bitmaps. */
+	u32 glyph_cache_used() const { return m_glyph_cache_used; }
+
+	/*! \details Loads the glyphs used by \a charset into the cache.
+	 *
+	 * @param charset A string that contains the (ASCII) characters to load
+	 * @return The number of glyphs that were added to the cache
+	 *
+	 * Glyphs are grouped by the canvas they are on so that each canvas is
+	 * read from the file only once. Characters whose glyphs don't fit in
+	 * glyph_cache_size() are skipped.
+	 *
+	 */
+	int preload(const var::ConstString & charset);
+
 protected:
 	void draw_char_on_bitmap(const sg_font_char_t & ch, Bitmap & dest, const Point & point) const;
 	int load_char(sg_font_char_t & ch, char c, bool ascii) const;
 	int load_kerning(u16 first, u16 second) const;
 
 private:
+
+	/*! \cond */
+	class Glyph {
+	public:
+		Glyph(){ m_key = 0; m_age = 0; m_is_valid = false; }
+		u32 m_key;
+		u32 m_age;
+		bool m_is_valid;
+		Bitmap m_bitmap;
+	};
+	/*! \endcond */
+
+	static u32 glyph_key(const sg_font_char_t & ch){
+		return ((u32)ch.canvas_idx << 24) | ((u32)(ch.canvas_x & 0xfff) << 12) | (ch.canvas_y & 0xfff);
+	}
+
+	static int compare_kerning_pairs(const void * a, const void * b);
+
+	int load_canvas(u8 canvas_idx) const;
+	const Glyph * find_glyph(const sg_font_char_t & ch) const;
+	const Glyph * add_glyph(const sg_font_char_t & ch) const;
+	void evict_glyph() const;
+	void clear_glyph_cache() const;
+
 	mutable sys::File m_file;
 	mutable Bitmap m_canvas;
 	mutable u8 m_current_canvas;
 	u32 m_canvas_start;
 	u32 m_canvas_size;
 	sg_font_kerning_pair_t * m_kerning_pairs;
+	var::Data m_characters;
+
+	mutable var::Vector<Glyph> m_glyphs;
+	mutable u32 m_glyph_cache_used;
+	mutable u32 m_glyph_age;
+	u32 m_glyph_cache_size;
 
 };
 
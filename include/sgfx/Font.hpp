@@ -146,6 +146,11 @@ public:
 
 	/*! \details Calculates the length (pixels on x-axis) of the specified string. */
 	int calculate_length(const var::ConstString & str) const;
+
+	/*! \details Calculates the length of the first \a length characters of \a str
+	  * (or up to the terminating zero if that comes first).
+	  */
+	int calculate_length(const char * str, u32 length) const;
 	/*! \cond */
 	int calc_len(const var::ConstString & str) const { return calculate_length(str); }
 	/*! \endcond */
@@ -8,6 +8,7 @@
 namespace sm {}
 
 #include "sm/StateMachine.hpp"
+#include "sm/EventStateMachine.hpp"
 
 using namespace sm;
 
@@ -0,0 +1,333 @@
+/*! \file */ //Copyright 2011-2019 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_SM_EVENT_STATE_MACHINE_HPP_
+#define SAPI_SM_EVENT_STATE_MACHINE_HPP_
+
+#if !defined __link
+
+#include <errno.h>
+#include <semaphore.h>
+#include "../api/SmObject.hpp"
+#include "../var/Data.hpp"
+#include "../sys/Mutex.hpp"
+#include "../sys/Sem.hpp"
+#include "../chrono/ClockTime.hpp"
+
+/*! \cond */
+typedef struct {
+	u32 entry_count; //number of times the state was entered
+	u32 event_count; //events dispatched while the state was active
+	u32 unhandled_count; //events that didn't match a transition (or whose guards all failed)
+	u64 microseconds; //total time the state has been active
+} sm_state_profile_t;
+/*! \endcond */
+
+namespace sm {
+
+/*! \brief Event Engine Class
+ * \details The Event Engine holds everything in an
+ * EventStateMachine that doesn't depend on the container class:
+ * the compiled (state, event) lookup table, the event queue,
+ * and the profile.
+ *
+ * Use EventStateMachine rather than this class directly.
+ *
+ */
+class EventEngine : public api::SmWorkObject {
+public:
+
+	enum {
+		NO_TRANSITION /*! Lookup table value for a (state, event) pair without a transition */ = 0xffff,
+		QUEUE_SIZE /*! Default number of events that can be pending */ = 16
+	};
+
+	/*! \details Constructs an engine.
+	 *
+	 * @param state_count The number of states (states are numbered from zero)
+	 * @param event_count The number of events (events are numbered from zero)
+	 * @param queue_size The number of events that can be pending
+	 *
+	 */
+	EventEngine(u16 state_count, u16 event_count, u16 queue_size = QUEUE_SIZE);
+	~EventEngine();
+
+	/*! \details Returns the active state. */
+	u16 state() const { return m_state; }
+
+	/*! \details Returns the number of states. */
+	u16 state_count() const { return m_state_count; }
+
+	/*! \details Returns the number of events. */
+	u16 event_count() const { return m_event_count; }
+
+	/*! \details Sets the active state without executing a transition.
+	 *
+	 * This is used to set the initial state. The state is recorded as
+	 * entered if profiling is enabled.
+	 *
+	 */
+	int set_state(u16 state);
+
+	/*! \details Adds an event to the queue.
+	 *
+	 * @param event The event to dispatch
+	 * @return Zero on success or less than zero if the queue is full (or \a event is invalid)
+	 *
+	 * This can be called from any thread. The thread in execute() wakes up
+	 * and dispatches the event.
+	 *
+	 */
+	int post(u16 event);
+
+	/*! \details Returns the number of events waiting in the queue. */
+	u16 pending_count() const { return m_queue_count; }
+
+	/*! \details Returns the number of events that were discarded because the queue was full. */
+	u32 overflow_count() const { return m_overflow_count; }
+
+	/*! \details Dispatches events as they are posted until stop() is called.
+	 *
+	 * The calling thread sleeps while the queue is empty.
+	 *
+	 * @return Zero when stopped or less than zero if waiting for an event fails
+	 *
+	 */
+	int execute();
+
+	/*! \details Dispatches the events that are already in the queue and returns.
+	 *
+	 * @return The number of events that were dispatched
+	 *
+	 * Use this instead of execute() to run the machine within another loop.
+	 *
+	 */
+	int process_events();
+
+	/*! \details Makes execute() return after the event that is being dispatched.
+	 *
+	 * If execute() isn't running, the next call to execute() returns immediately.
+	 *
+	 */
+	void stop();
+
+	/*! \details Dispatches \a event in the calling thread without using the queue.
+	 *
+	 * @return 1 if a transition executed, zero if the event was ignored, or less than zero for an invalid event
+	 *
+	 */
+	virtual int dispatch(u16 event) = 0;
+
+	/*! \details Enables or disables profiling.
+	 *
+	 * @return Zero on success or less than zero if the profile could not be allocated
+	 *
+	 * When profiling is enabled, the engine counts the entries, events, and unhandled
+	 * events of each state and measures how long each state is active. Enabling
+	 * profiling clears the profile.
+	 *
+	 */
+	int set_profiling_enabled(bool value = true);
+
+	/*! \details Returns true if profiling is enabled. */
+	bool is_profiling_enabled() const { return m_profile.size() != 0; }
+
+	/*! \details Returns the profile of \a state.
+	 *
+	 * The time for the active state includes the time it has been active so far.
+	 * The profile is all zeros if profiling isn't enabled.
+	 *
+	 */
+	sm_state_profile_t profile(u16 state) const;
+
+	/*! \details Returns the total number of transitions since profiling was enabled. */
+	u32 transition_count() const { return m_transition_count; }
+
+	/*! \details Clears the profile. */
+	void reset_profile();
+
+protected:
+
+	/*! \details Allocates the lookup table for \a transition_count transitions.
+	 *
+	 * Every (state, event) pair starts without a transition.
+	 *
+	 */
+	int allocate_table(u16 transition_count);
+
+	/*! \details Adds transition number \a transition to the lookup table.
+	 *
+	 * Transitions with the same state and event are checked in the
+	 * order they are added.
+	 *
+	 * @return Zero on success or less than zero if \a state, \a event, or \a next_state is out of range
+	 *
+	 */
+	int add_transition(u16 transition, u16 state, u16 event, u16 next_state);
+
+	/*! \details Returns the first transition for \a event in the active state (or NO_TRANSITION). */
+	u16 first_transition(u16 event) const {
+		return lookup()[m_state * m_event_count + event];
+	}
+
+	/*! \details Returns the transition to check after \a transition if its guard fails (or NO_TRANSITION). */
+	u16 next_transition(u16 transition) const {
+		return lookup()[m_state_count * m_event_count + transition];
+	}
+
+	/*! \details Changes the active state after the action of a transition has executed. */
+	void complete_transition(u16 next_state);
+
+	/*! \details Records an event that didn't cause a transition. */
+	void ignore_event();
+
+private:
+	/*! \cond */
+	u16 * lookup() const { return (u16*)m_table.data(); }
+	u16 * queue() const { return (u16*)m_queue.data(); }
+	sm_state_profile_t * profile_list() const { return (sm_state_profile_t*)m_profile.data(); }
+	int pop_event(u16 * event);
+	void enter_state(u16 state);
+
+	var::Data m_table; //(state, event) lookup followed by the guard chain of each transition
+	var::Data m_queue;
+	var::Data m_profile;
+	sys::Mutex m_mutex;
+	sys::Sem m_sem;
+	sem_t m_sem_handle;
+	chrono::ClockTime m_entry_time;
+	u32 m_overflow_count;
+	u32 m_transition_count;
+	u16 m_state;
+	u16 m_state_count;
+	u16 m_event_count;
+	u16 m_transition_limit;
+	u16 m_queue_size;
+	u16 m_queue_head;
+	volatile u16 m_queue_count;
+	volatile bool m_is_running;
+	/*! \endcond */
+
+};
+
+/*! \brief Event State Machine Class
+ * \details This class implements an event-driven state machine.
+ *
+ * The transitions are listed in a table. Each transition has a state,
+ * an event, a next state, an optional guard, and an optional action.
+ * compile() builds a lookup table so dispatching an event is a single
+ * index of (state, event) rather than a search or polling the conditions.
+ * The guard and action are methods of \a container_class.
+ *
+ * \code
+ * #include <sapi/sm.hpp>
+ *
+ * class Door : public EventStateMachine<Door> {
+ * public:
+ *   enum { CLOSED, OPEN, LOCKED, STATE_COUNT };
+ *   enum { PUSH, PULL, LOCK, UNLOCK, EVENT_COUNT };
+ *
+ *   Door() : EventStateMachine<Door>(STATE_COUNT, EVENT_COUNT){
+ *     static const transition_t table[] = {
+ *       { CLOSED, PULL, OPEN, 0, &Door::open_latch },
+ *       { OPEN, PUSH, CLOSED, &Door::is_clear, 0 },
+ *       { CLOSED, LOCK, LOCKED, 0, 0 },
+ *       { LOCKED, UNLOCK, CLOSED, &Door::is_key_valid, 0 }
+ *     };
+ *     compile(table, sizeof(table)/sizeof(transition_t));
+ *     set_state(CLOSED);
+ *   }
+ *
+ * private:
+ *   bool is_clear(u16 event);
+ *   bool is_key_valid(u16 event);
+ *   void open_latch(u16 event);
+ * };
+ *
+ * Door door;
+ * door.set_profiling_enabled();
+ * //another thread calls door.post(Door::PULL)
+ * door.execute(); //sleeps until an event is posted
+ * \endcode
+ *
+ * If more than one transition has the same state and event, the guards are
+ * checked in table order and the first transition whose guard is true (or that
+ * has no guard) executes. An event without a matching transition is ignored.
+ *
+ */
+template<class container_class> class EventStateMachine : public EventEngine {
+public:
+
+	/*! \details Defines the method type of a guard. */
+	typedef bool (container_class::*guard_t)(u16 event);
+
+	/*! \details Defines the method type of an action. */
+	typedef void (container_class::*action_t)(u16 event);
+
+	/*! \details Defines a transition. */
+	typedef struct {
+		u16 state /*! The state where the transition starts */;
+		u16 event /*! The event that triggers the transition */;
+		u16 next_state /*! The state after the transition */;
+		guard_t guard /*! A method that must return true for the transition to execute (zero for none) */;
+		action_t action /*! A method to execute during the transition (zero for none) */;
+	} transition_t;
+
+	EventStateMachine(u16 state_count, u16 event_count, u16 queue_size = QUEUE_SIZE) :
+		EventEngine(state_count, event_count, queue_size){
+		m_transition_table = 0;
+	}
+
+	/*! \details Builds the lookup table from a list of transitions.
+	 *
+	 * @param table The transitions (must stay valid for the life of the machine)
+	 * @param count The number of transitions in \a table
+	 * @return Zero on success or less than zero if a transition is invalid or memory isn't available
+	 *
+	 * This is called once (usually in the constructor of \a container_class).
+	 *
+	 */
+	int compile(const transition_t * table, u16 count){
+		if( allocate_table(count) < 0 ){
+			return -1;
+		}
+		for(u16 i=0; i < count; i++){
+			if( add_transition(i, table[i].state, table[i].event, table[i].next_state) < 0 ){
+				return -1;
+			}
+		}
+		m_transition_table = table;
+		return 0;
+	}
+
+	int dispatch(u16 event){
+		if( (event >= event_count()) || (m_transition_table == 0) ){
+			set_error_number(EINVAL);
+			return -1;
+		}
+
+		for(u16 i = first_transition(event); i != NO_TRANSITION; i = next_transition(i)){
+			const transition_t & transition = m_transition_table[i];
+			if( transition.guard && ((((container_class*)this)->*transition.guard)(event) == false) ){
+				continue;
+			}
+			if( transition.action ){
+				(((container_class*)this)->*transition.action)(event);
+			}
+			complete_transition(transition.next_state);
+			return 1;
+		}
+
+		ignore_event();
+		return 0;
+	}
+
+private:
+	const transition_t * m_transition_table;
+
+};
+
+}
+
+#endif
+
+#endif // SAPI_SM_EVENT_STATE_MACHINE_HPP_
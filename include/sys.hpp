@@ -24,6 +24,7 @@ namespace sys {}
 #include "sys/Trace.hpp"
 #else
 #include "sys/Link.hpp"
+#include "sys/LinkBatch.hpp"
 #endif
 
 #include "sys/Mutex.hpp"
@@ -31,11 +32,13 @@ namespace sys {}
 #include "sys/TaskManager.hpp"
 #include "sys/Cli.hpp"
 #include "sys/Printer.hpp"
+#include "sys/LogPrinter.hpp"
 #include "sys/Sys.hpp"
 #include "sys/Appfs.hpp"
 #include "sys/Dir.hpp"
 #include "sys/File.hpp"
 #include "sys/FileInfo.hpp"
+#include "sys/FileTransfer.hpp"
 
 using namespace sys;
 
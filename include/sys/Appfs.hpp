@@ -10,6 +10,7 @@
 #include "../var/ConstString.hpp"
 #include "ProgressCallback.hpp"
 #include "File.hpp"
+#include "../calc/Crc.hpp"
 
 namespace sys {
 
@@ -234,6 +235,107 @@ private:
 	u16 m_version;
 };
 
+/*! \brief Appfs Install File Class
+ * \details The Appfs Install File class writes an image
+ * to /app/.install.
+ *
+ * The appfs driver accepts exactly one page (APPFS_PAGE_SIZE bytes)
+ * per ioctl(). Writes of any size are split into pages here, so a
+ * sys::FileTransfer can read large chunks of the source (on a background
+ * thread) while the pages are sent to the device.
+ *
+ * \code
+ * #include <sapi/sys.hpp>
+ *
+ * AppfsInstallFile install_file(AppfsInstallFile::INSTALL, link.driver());
+ * install_file.open();
+ *
+ * FileTransfer transfer;
+ * transfer.transfer(image, install_file, image.size());
+ * install_file.close(); //sends the last (partial) page
+ * \endcode
+ *
+ * A CRC32 of the data that is written (see crc()) is kept so
+ * the result can be verified without comparing every page.
+ *
+ */
+class AppfsInstallFile : public File {
+public:
+
+	enum request {
+		CREATE /*! Create a data file (I_APPFS_CREATE) */,
+		INSTALL /*! Install an executable (I_APPFS_INSTALL) */
+	};
+
+#if defined __link
+	AppfsInstallFile(enum request request, link_transport_mdriver_t * driver = 0);
+#else
+	AppfsInstallFile(enum request request);
+#endif
+
+	/*! \details Closes the file with discard() if close() wasn't called. */
+	~AppfsInstallFile();
+
+	/*! \details Opens the install file (/app/.install by default). */
+	int open(const var::ConstString & name = "/app/.install", int flags = File::WRONLY);
+
+	/*! \details Sends the last page and closes the file. */
+	int close();
+
+	/*! \details Closes the file without sending the last page.
+	 *
+	 * Use this when the install is aborted so a truncated image
+	 * isn't written to the device.
+	 *
+	 */
+	int discard();
+
+	/*! \details Writes \a nbyte bytes of the image.
+	 *
+	 * @return \a nbyte on success or less than zero if a page could not be sent
+	 *
+	 * Each page is sent to the driver as soon as it is full.
+	 *
+	 */
+	int write(const void * buf, int nbyte) const;
+
+	/*! \details Writes \a size bytes of the image without adding them to crc().
+	 *
+	 * Appfs::create() uses this for the header that precedes the data.
+	 *
+	 */
+	int write_header(const void * header, u32 size) const;
+
+	/*! \details Sends the last page if it is partially filled. */
+	int flush() const;
+
+	/*! \details Returns the value returned by the last ioctl().
+	 *
+	 * When an install fails, this is less than -1 if a symbol
+	 * is missing on the device.
+	 *
+	 */
+	int request_result() const { return m_request_result; }
+
+	/*! \details Returns the number of bytes sent to the driver. */
+	u32 location() const { return m_location; }
+
+	/*! \details Returns the CRC32 of the bytes passed to write(). */
+	u32 crc() const { return m_crc.value(); }
+
+private:
+	int write_page() const;
+	int copy(const void * buf, u32 nbyte) const;
+
+	enum request m_request;
+	//appfs_createattr_t has the same layout
+	mutable appfs_installattr_t m_attr;
+	mutable u32 m_page_size; //bytes waiting in m_attr
+	mutable u32 m_location;
+	mutable int m_request_result;
+	mutable calc::Crc m_crc;
+};
+
 /*! \brief Application File System Class
  * \details This class provides an interface for creating data files in flash
  * memory.
@@ -272,6 +374,15 @@ private:
 class Appfs : public api::SysInfoObject {
 public:
 
+	enum {
+		INSTALL_CHUNK_SIZE /*! Largest chunk read from the source while pages are written */ =
+#if defined __link
+		APPFS_PAGE_SIZE*64
+#else
+		APPFS_PAGE_SIZE*2
+#endif
+	};
+
 	/*! \details Creates a file in flash memory consisting
 	 * of the data specified.
 	 *
@@ -281,20 +392,27 @@ public:
 	 * @param mount The mount path (default is /app)
 	 * @param update A callback that is executed after each page write
 	 * @param context The first argument passed to the \a update callback
-	 * @return Zero on success or -1 with errno set accordingly
+	 * @param is_verify If true, the file is read back and its CRC32 is compared to the source
+	 * @return The number of bytes in the file on success or -1 with errno set accordingly
+	 *
+	 * The source is read in chunks of up to INSTALL_CHUNK_SIZE bytes while the
+	 * pages are being written (see AppfsInstallFile). If the
+	 * verification fails, errno is set to EIO.
 	 *
 	 */
 #if !defined __link
 	static int create(const var::ConstString & name,
 							const sys::File & source_data,
 							const var::ConstString & mount = "/app",
-							const ProgressCallback * progress_callback = 0);
+							const ProgressCallback * progress_callback = 0,
+							bool is_verify = false);
 #else
 	static int create(const var::ConstString & name,
 							const sys::File & source_data,
 							const var::ConstString & mount = "/app",
 							const ProgressCallback * progress_callback = 0,
-							link_transport_mdriver_t * driver = 0);
+							link_transport_mdriver_t * driver = 0,
+							bool is_verify = false);
 #endif
 
 
@@ -68,10 +68,32 @@ public:
 		return m_vector_path_list;
 	}
 
+	/*! \details Returns the vector path of the icon named \a name.
+	 *
+	 * The icon names are indexed by hash when the assets are initialized
+	 * so finding an icon doesn't scan every icon file.
+	 *
+	 * @return The vector path or an invalid path if \a name is not installed
+	 */
 	static sgfx::VectorPath find_vector_path(const var::ConstString & name);
 
+	/*! \details Returns the hash used to index icons by name. */
+	static u32 calculate_hash(const var::ConstString & name);
+
 private:
 
+	/*! \cond */
+	typedef struct {
+		u32 hash;
+		u16 svic;
+		u16 icon;
+	} icon_index_t;
+	/*! \endcond */
+
+	static var::Vector<icon_index_t> m_icon_index;
+	static void build_icon_index();
+	static int compare_icon_index(const void * a, const void * b);
+
 	static bool m_is_initialized;
 	static var::Vector<sgfx::FontInfo> m_font_info_list;
 	static var::Vector<fmt::Svic> m_vector_path_list;
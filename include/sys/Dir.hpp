@@ -49,6 +49,19 @@ public:
 	static bool exists(const var::ConstString & path, link_transport_mdriver_t * driver = 0);
 	static var::Vector<var::String> read_list(const var::ConstString & path, link_transport_mdriver_t * driver = 0);
 
+	/*! \details Returns the paths of every entry below \a path (recursively).
+	 *
+	 * @param path The directory to walk
+	 * @param driver The link driver (null for the host file system)
+	 *
+	 * The "." and ".." entries are not included. Each returned path
+	 * starts with \a path. For a device, each level of the tree is read
+	 * with two sys::LinkBatch requests (one to read the directories and
+	 * one to stat the entries) instead of one request per entry.
+	 *
+	 */
+	static var::Vector<var::String> read_tree(const var::ConstString & path, link_transport_mdriver_t * driver = 0);
+
 #else
 	Dir();
 
@@ -58,6 +71,14 @@ public:
 	/*! \details Returns true if the directory exists. */
 	static bool exists(const var::ConstString & path);
 	static var::Vector<var::String> read_list(const var::ConstString & path);
+
+	/*! \details Returns the paths of every entry below \a path (recursively).
+	 *
+	 * The "." and ".." entries are not included. Each returned path
+	 * starts with \a path.
+	 *
+	 */
+	static var::Vector<var::String> read_tree(const var::ConstString & path);
 #endif
 
 	~Dir();
@@ -426,6 +426,17 @@ public:
 
 	int write(int loc, const api::InfoObject & info) const { return write(loc, info.info_to_void(), info.info_size()); }
 
+	/*! \details Writes the contents of \a source_file to this file.
+	 *
+	 * @param source_file The file to read (must already be open)
+	 * @param chunk_size The number of bytes to read/write at a time
+	 * @param size The maximum number of bytes to write
+	 * @return The number of bytes written
+	 *
+	 * Each chunk is read then written before the next chunk is read.
+	 * Use sys::FileTransfer to read ahead while writing.
+	 *
+	 */
 	int write(const sys::File & source_file, u32 chunk_size, u32 size = 0xffffffff) const;
 	int write(int loc, const sys::File & source_file, u32 chunk_size, u32 size = 0xffffffff) const {
 		seek(loc);
@@ -687,6 +698,155 @@ private:
 
 };
 
+/*! \brief BufferedFile Class
+ * \details The BufferedFile class adds a read-ahead
+ * buffer to another sys::File object.
+ *
+ * Reading a line with sys::File::gets() or sys::File::readline()
+ * takes one read() call per character. That is slow when each
+ * read() is a system call, a socket receive, or a round trip
+ * on a link driver. BufferedFile reads up to buffer_size() bytes
+ * at a time and serves gets(), readline(), peek() and small
+ * read() calls from the buffer.
+ *
+ * \code
+ * #include <sapi/sys.hpp>
+ *
+ * File file;
+ * file.open("/home/settings.txt", File::RDONLY);
+ *
+ * BufferedFile buffered_file(file, 256);
+ * String line;
+ * while( buffered_file.gets(line) ){
+ *   printf("%s", line.cstring());
+ * }
+ * \endcode
+ *
+ * The wrapped file is read ahead of what has been consumed. seek() and
+ * close() discard the buffer and move the wrapped file back to the
+ * position of the last byte consumed, so the wrapped file can keep being used
+ * directly. Streams that can't seek (such as sockets) lose any buffered
+ * bytes at that point, so they should keep reading through
+ * the BufferedFile object.
+ *
+ * BufferedFile doesn't open or close the wrapped file.
+ *
+ */
+class BufferedFile : public sys::File {
+public:
+
+	/*! \details Constructs a buffered file.
+	 *
+	 * @param file The file to read (must stay valid for the life of this object)
+	 * @param buffer_size The number of bytes to read ahead
+	 *
+	 */
+	BufferedFile(const File & file, u32 buffer_size = GETS_BUFFER_SIZE*4);
+	~BufferedFile();
+
+	/*! \details Sets the read-ahead buffer size.
+	 *
+	 * Any buffered data is discarded (see close()).
+	 *
+	 */
+	int set_buffer_size(u32 value);
+
+	/*! \details Returns the read-ahead buffer size. */
+	u32 buffer_size() const { return m_buffer.size(); }
+
+	/*! \details Returns the number of bytes that are buffered but not yet consumed. */
+	u32 available() const { return m_tail - m_head; }
+
+	/*! \details Returns the wrapped file. */
+	const File & file() const { return m_file; }
+
+	/*! \details Drops any buffered data without moving the wrapped file.
+	 *
+	 * Use this when the wrapped stream is reset (for example, when a
+	 * socket is closed and reconnected).
+	 *
+	 */
+	void clear(){ m_head = 0; m_tail = 0; }
+
+	/*! \details Returns an error because the wrapped file is opened by the caller. */
+	int open(const var::ConstString & name, int flags = File::RDWR);
+
+	/*! \details Discards the buffer and moves the wrapped file
+	 * to the position of the last byte consumed.
+	 *
+	 * The wrapped file is not closed.
+	 *
+	 */
+	int close();
+
+	/*! \details Reads from the buffer and then from the wrapped file.
+	 *
+	 * If data is already buffered, only that data is returned so that
+	 * reading a stream (like a socket) doesn't block when data is available.
+	 * Requests that are larger than the buffer bypass the buffer.
+	 *
+	 */
+	int read(void * buf, int nbyte) const;
+
+	/*! \details Writes to the wrapped file.
+	 *
+	 * The buffer is discarded first so that the data is written at the
+	 * position of the last byte consumed.
+	 *
+	 */
+	int write(const void * buf, int nbyte) const;
+
+	/*! \details Seeks the wrapped file.
+	 *
+	 * The buffer is discarded. File::CURRENT is relative to the
+	 * last byte consumed rather than the last byte read ahead.
+	 *
+	 */
+	int seek(int loc, int whence = LINK_SEEK_SET) const;
+
+	/*! \details Executes an ioctl() on the wrapped file. */
+	int ioctl(int req, void * arg) const { return m_file.ioctl(req, arg); }
+
+	/*! \details Returns the size of the wrapped file. */
+	u32 size() const { return m_file.size(); }
+
+	/*! \details Copies up to \a nbyte bytes without consuming them.
+	 *
+	 * @param buf Destination buffer
+	 * @param nbyte Number of bytes to look at (limited to buffer_size())
+	 * @return The number of bytes copied to \a buf
+	 *
+	 * The buffer is filled from the wrapped file if fewer than \a nbyte bytes
+	 * are available.
+	 *
+	 */
+	int peek(void * buf, int nbyte) const;
+
+	/*! \details Returns the next byte without consuming it or -1 if no more data is available. */
+	int peek() const;
+
+	/*! \details Reads a line into \a s from the buffer (see sys::File::gets()). */
+	char * gets(var::String & s, char term = '\n') const;
+
+	/*! \details Reads a line from the buffer (see sys::File::gets()). */
+	var::String gets(char term = '\n') const;
+
+	/*! \details Reads a line from the buffer (see sys::File::readline()). */
+	int readline(char * buf, int nbyte, int timeout_msec, char terminator = '\n') const;
+
+	using File::read;
+	using File::write;
+
+private:
+	int fill() const;
+	void discard() const;
+
+	const File & m_file;
+	mutable var::Data m_buffer;
+	mutable u32 m_head; //offset of the next byte to consume
+	mutable u32 m_tail; //offset after the last byte read ahead
+};
+
 class NullFile : public sys::File {
 public:
 
@@ -0,0 +1,157 @@
+/*! \file */ //Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_SYS_FILETRANSFER_HPP_
+#define SAPI_SYS_FILETRANSFER_HPP_
+
+#include "../api/SysObject.hpp"
+#include "../chrono/MicroTime.hpp"
+#include "../var/Data.hpp"
+#include "File.hpp"
+#include "Mutex.hpp"
+#include "ProgressCallback.hpp"
+
+namespace sys {
+
+/*! \brief FileTransfer Class
+ * \details The FileTransfer class copies data from one
+ * sys::File to another using a bounded window of chunks.
+ *
+ * A background thread reads the source file into the window
+ * while the calling thread writes completed chunks to the
+ * destination. When the destination is a device accessed
+ * over a link driver, the next chunks are read from the host
+ * while the current chunk is making its round trip.
+ *
+ * The chunk size and window depth adapt as the transfer runs.
+ * If a write completes faster than half the target round
+ * trip time, the chunk size doubles (up to the maximum). If it
+ * takes longer than the target, the chunk size is halved (down
+ * to the minimum). If the writer finds the window empty,
+ * the window depth is increased (up to the maximum).
+ *
+ * \code
+ * #include <sapi/sys.hpp>
+ *
+ * File source;
+ * File dest(link.driver());
+ * source.open("firmware.bin", File::RDONLY);
+ * dest.create("/home/firmware.bin");
+ *
+ * FileTransfer transfer;
+ * transfer.set_chunk_size(1024, 16*1024);
+ * transfer.transfer(source, dest, source.size(), progress_callback);
+ * \endcode
+ *
+ * If the source and destination share the same link driver,
+ * the transfer runs sequentially on the calling thread because
+ * the driver can only carry one transaction at a time.
+ *
+ */
+class FileTransfer : public api::SysWorkObject {
+public:
+
+	enum {
+		WINDOW_DEPTH_MAX /*! Maximum number of chunks that can be in flight */ = 8
+	};
+
+	/*! \details Constructs a new transfer object with default settings.
+	 *
+	 * The default minimum chunk size is 256 bytes, the default
+	 * maximum chunk size is 16KB, the initial window depth is 2
+	 * and the target round trip time is 20ms.
+	 *
+	 */
+	FileTransfer();
+
+	/*! \details Sets the range of chunk sizes.
+	 *
+	 * @param minimum The smallest chunk size that will be used (also the starting size)
+	 * @param maximum The largest chunk size that will be used
+	 *
+	 * Passing the same value for both arguments disables chunk
+	 * size adaptation.
+	 *
+	 */
+	void set_chunk_size(u32 minimum, u32 maximum);
+
+	/*! \details Sets the range of window depths.
+	 *
+	 * @param initial The number of chunks that may be read ahead when the transfer starts
+	 * @param maximum The largest number of chunks that may be read ahead (limited to WINDOW_DEPTH_MAX)
+	 *
+	 */
+	void set_window_depth(u32 initial, u32 maximum = WINDOW_DEPTH_MAX);
+
+	/*! \details Sets the round trip time the chunk size adapts towards. */
+	void set_target_round_trip(const chrono::MicroTime & value){ m_target_round_trip = value; }
+
+	/*! \details Transfers data from \a source to \a dest.
+	 *
+	 * @param source The file to read (must already be open)
+	 * @param dest The file to write (must already be open)
+	 * @param size The maximum number of bytes to transfer
+	 * @param progress_callback Callback executed after each chunk is written (can be null)
+	 * @return The number of bytes transferred or less than zero if no bytes could be transferred
+	 *
+	 * The \a progress_callback is executed with the same values as
+	 * sys::File::write(const File &, u32, u32, const ProgressCallback*). If
+	 * the callback returns true, the transfer is aborted. When the transfer
+	 * terminates, the callback is executed with (0,0).
+	 *
+	 */
+	int transfer(const File & source, const File & dest, u32 size = 0xffffffff, const ProgressCallback * progress_callback = 0);
+
+	/*! \details Returns the chunk size used by the last write. */
+	u32 chunk_size() const { return m_chunk_size; }
+
+	/*! \details Returns the window depth at the end of the last transfer. */
+	u32 window_depth() const { return m_window_depth; }
+
+	/*! \details Returns the round trip time of the last write. */
+	const chrono::MicroTime & round_trip() const { return m_round_trip; }
+
+	/*! \details Returns the number of times the writer had to wait on the reader. */
+	u32 stall_count() const { return m_stall_count; }
+
+private:
+
+	static void * read_worker(void * args){
+		((FileTransfer*)args)->read_source();
+		return 0;
+	}
+
+	void read_source();
+	int transfer_sequential(const File & source, const File & dest, u32 size, const ProgressCallback * progress_callback);
+	void adapt_chunk_size();
+	bool is_shared_driver(const File & source, const File & dest) const;
+
+	u32 pending_count();
+
+	//configuration
+	u32 m_chunk_size_minimum;
+	u32 m_chunk_size_maximum;
+	u32 m_window_depth_initial;
+	u32 m_window_depth_maximum;
+	chrono::MicroTime m_target_round_trip;
+
+	//state of the current transfer
+	const File * m_source;
+	u32 m_size;
+	var::Data m_window;
+	int m_slot_bytes[WINDOW_DEPTH_MAX];
+	Mutex m_mutex;
+	volatile u32 m_head; //next slot the reader fills
+	volatile u32 m_tail; //next slot the writer drains
+	volatile u32 m_chunk_size;
+	volatile u32 m_window_depth;
+	volatile bool m_is_read_complete;
+	volatile bool m_is_abort;
+
+	chrono::MicroTime m_round_trip;
+	u32 m_stall_count;
+
+};
+
+}
+
+#endif // SAPI_SYS_FILETRANSFER_HPP_
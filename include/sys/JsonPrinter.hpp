@@ -5,13 +5,89 @@
 #define SAPI_SYS_JSON_PRINTER_HPP_
 
 #include "../var/String.hpp"
+#include "../var/Data.hpp"
+#include "File.hpp"
 
 namespace sys {
 
+/*! \brief JSON Printer Class
+ * \details The JSON Printer class writes a JSON document
+ * one value at a time.
+ *
+ * By default, the document is appended to the printer (which is a var::String).
+ * If the printer is constructed with a sys::File (including sys::DataFile and
+ * inet::Socket), the document is written to the file through a BUFFER_SIZE
+ * buffer, so it never has to fit in memory. Keys and strings are
+ * escaped, and numbers are formatted without printf().
+ *
+ * \code
+ * #include <sapi/sys.hpp>
+ *
+ * File file;
+ * file.create("/home/trace.json");
+ *
+ * JsonPrinter printer(file);
+ * printer.set_indent(2); //pretty print (0 is compact)
+ * printer.append_string("name", "trace");
+ * printer.append_array("samples");
+ * for(u32 i=0; i < count; i++){
+ *   printer.append_float(samples[i]);
+ * }
+ * printer.end_array();
+ * printer.end(); //closes the document and flushes the buffer
+ * \endcode
+ *
+ * Containers opened with append_object() and append_array() must be closed
+ * with end_object() and end_array(). end() closes the top level object or array.
+ *
+ */
 class JsonPrinter : public var::String {
 public:
+
+	enum {
+		BUFFER_SIZE /*! Number of bytes buffered before they are written to the file */ =
+#if defined __link
+		4096
+#else
+		256
+#endif
+	};
+
+	/*! \details Constructs a printer that appends the document to this string.
+	 *
+	 * @param is_object True if the top level value is an object (false for an array)
+	 *
+	 */
 	JsonPrinter(bool is_object = true);
 
+	/*! \details Constructs a printer that writes the document to \a file.
+	 *
+	 * @param file The destination (must stay valid for the life of the printer)
+	 * @param is_object True if the top level value is an object (false for an array)
+	 *
+	 */
+	JsonPrinter(const File & file, bool is_object = true);
+
+	~JsonPrinter();
+
+	/*! \details Sets the number of spaces used for each level of indentation.
+	 *
+	 * Zero (the default) prints compact JSON with no whitespace.
+	 *
+	 */
+	void set_indent(u8 value){ m_indent = value; }
+
+	/*! \details Returns the number of spaces used for each level of indentation. */
+	u8 indent() const { return m_indent; }
+
+	/*! \details Writes any buffered output to the file.
+	 *
+	 * @return Zero on success or less than zero if the file could not be written
+	 *
+	 * Nothing is buffered when printing to the string.
+	 *
+	 */
+	int flush();
 
 	void end();
 	void end_object();
@@ -42,7 +118,23 @@ public:
 
 private:
 
-	void append_separator();
+	void start();
+	void append_separator(const var::ConstString * key = 0);
+	void open_container(const var::ConstString * key, char bracket);
+	void close_container(char bracket);
+	void write(const char * data, u32 size);
+	int write_output(const void * data, u32 size);
+	void write_string(const var::ConstString & value);
+	void write_newline();
+	void write_integer(int number);
+	void write_float(float number);
+
+	const File * m_file;
+	var::Data m_buffer;
+	u32 m_buffer_size; //bytes waiting in m_buffer
+	u32 m_length; //length of the document when printing to the string
+	u16 m_depth;
+	u8 m_indent;
 	bool m_is_first;
 	bool m_is_object;
 
@@ -15,6 +15,7 @@
 #include "Appfs.hpp"
 #include "Sys.hpp"
 #include "ProgressCallback.hpp"
+#include "LinkBatch.hpp"
 
 namespace sys {
 
@@ -166,6 +167,16 @@ public:
 	/*! \details Loads the entries of a directory. */
 	var::Vector<var::String> get_dir_list(const var::ConstString & directory);
 
+	/*! \details Executes a batch of file system operations on the device.
+	 *
+	 * @param batch The operations to execute (results are stored in \a batch)
+	 * @return The number of operations that failed or less than zero if the connection failed
+	 *
+	 * The device is locked once for the whole batch. See sys::LinkBatch.
+	 *
+	 */
+	int execute(LinkBatch & batch);
+
 	/*! \details Converts the permissions to a
 	  * string of the format:
 	  *
@@ -457,6 +468,27 @@ public:
 	  */
 	int update_os(const sys::File & image, bool verify, const ProgressCallback * progress_callback = 0, u32 bootloader_retry_total = 20);
 
+	/*! \details Updates the operating system only if it differs from the image.
+	  *
+	  * \param image The new binary image on the host
+	  * \param verify true to read back the installation
+	  * \param progress_callback Callback to execute as the update is in progress
+	  * \param bootloader_retry_total Number of times to ping the bootloader after erasing
+	  * \return Zero on success or less than zero on an error or if \a progress_callback aborts
+	  *
+	  * The flash contents are read back and compared with the image one
+	  * 1024-byte block at a time. If no block differs, the
+	  * flash is not erased or written and status_message() reports that
+	  * the OS is up to date.
+	  *
+	  * The bootloader only supports erasing the entire flash, so if
+	  * any block differs, the image is installed using update_os().
+	  * update_os() skips blocks that are entirely 0xFF because they
+	  * are already in the erased state.
+	  *
+	  */
+	int update_os_delta(const sys::File & image, bool verify, const ProgressCallback * progress_callback = 0, u32 bootloader_retry_total = 20);
+
 	/*! \details Returns the driver needed by other API objects.
 	  *
 	  * Other objects need the link driver in order to operate correctly.
@@ -559,6 +591,7 @@ public:
 private:
 
 	int check_error(int err);
+	static bool is_erased(const void * buffer, u32 size);
 	int lock_device();
 	int unlock_device();
 	void reset_progress();
@@ -0,0 +1,193 @@
+/*! \file */ //Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_SYS_LINKBATCH_HPP_
+#define SAPI_SYS_LINKBATCH_HPP_
+
+#if defined __link
+
+#include <sos/link.h>
+#include "../api/SysObject.hpp"
+#include "../var/String.hpp"
+#include "../var/Vector.hpp"
+#include "../var/Data.hpp"
+
+namespace sys {
+
+/*! \brief Link Operation Class
+ * \details The Link Operation class holds one request in a
+ * sys::LinkBatch and, after the batch is executed, its result.
+ *
+ */
+class LinkOperation {
+public:
+
+	enum type {
+		STAT /*! Get the link_stat of a path */,
+		READ_DIR /*! Read all entries of a directory */,
+		UNLINK /*! Remove a file */,
+		MKDIR /*! Create a directory */,
+		READ /*! Read up to size() bytes of a file from offset() */
+	};
+
+	LinkOperation(){
+		m_type = STAT;
+		m_mode = 0;
+		m_offset = 0;
+		m_size = 0;
+		m_result = -1;
+		m_error_number = 0;
+		memset(&m_stat, 0, sizeof(m_stat));
+	}
+
+	LinkOperation(enum type type, const var::ConstString & path){
+		m_type = type;
+		m_path = path;
+		m_mode = 0;
+		m_offset = 0;
+		m_size = 0;
+		m_result = -1;
+		m_error_number = 0;
+		memset(&m_stat, 0, sizeof(m_stat));
+	}
+
+	/*! \details Returns the type of the operation. */
+	enum type type() const { return m_type; }
+	/*! \details Returns the path the operation applies to. */
+	const var::String & path() const { return m_path; }
+
+	/*! \details Returns the result of the operation (less than zero on failure).
+	 *
+	 * For READ_DIR this is the number of entries and for READ the number of bytes read.
+	 *
+	 */
+	int result() const { return m_result; }
+
+	/*! \details Returns the device errno if the operation failed. */
+	int error_number() const { return m_error_number; }
+
+	/*! \details Returns true if the operation succeeded. */
+	bool is_success() const { return m_result >= 0; }
+
+	/*! \details Returns the link_stat from a STAT operation. */
+	const struct link_stat & stat() const { return m_stat; }
+
+	/*! \details Returns true if a STAT operation found a directory. */
+	bool is_directory() const { return (m_stat.st_mode & LINK_S_IFMT) == LINK_S_IFDIR; }
+
+	/*! \details Returns the names read by a READ_DIR operation. */
+	const var::Vector<var::String> & entries() const { return m_entries; }
+
+	/*! \details Returns the bytes read by a READ operation. */
+	const var::Data & data() const { return m_data; }
+
+	/*! \cond */
+	link_mode_t mode() const { return m_mode; }
+	u32 offset() const { return m_offset; }
+	u32 size() const { return m_size; }
+	void set_mode(link_mode_t mode){ m_mode = mode; }
+	void set_offset(u32 offset){ m_offset = offset; }
+	void set_size(u32 size){ m_size = size; }
+	/*! \endcond */
+
+private:
+	friend class LinkBatch;
+	enum type m_type;
+	var::String m_path;
+	link_mode_t m_mode;
+	u32 m_offset;
+	u32 m_size;
+	int m_result;
+	int m_error_number;
+	struct link_stat m_stat;
+	var::Vector<var::String> m_entries;
+	var::Data m_data;
+};
+
+/*! \brief Link Batch Class
+ * \details The Link Batch class queues file system operations
+ * for a device and executes them together.
+ *
+ * The whole batch runs while holding the device lock once.
+ * Errors are recorded per operation rather than turned into
+ * messages, and a protocol error retries only the operation
+ * that failed. Directory reads collect every entry in one pass.
+ *
+ * \code
+ * #include <sapi/sys.hpp>
+ *
+ * LinkBatch batch;
+ * batch.add_read_dir("/app/flash");
+ * batch.add_stat("/app/flash/hello");
+ * batch.add_read("/home/settings.json", 0, 256);
+ * link.execute(batch);
+ *
+ * for(u32 i=0; i < batch.count(); i++){
+ *   if( batch.at(i).is_success() ){ ... }
+ * }
+ * \endcode
+ *
+ */
+class LinkBatch : public api::SysWorkObject {
+public:
+
+	enum {
+		RETRY_COUNT /*! Number of times an operation is retried after a protocol error */ = 3,
+		READ_SIZE_MAX /*! Largest number of bytes a READ operation can request */ = 64*1024
+	};
+
+	/*! \details Queues a stat() of \a path. */
+	int add_stat(const var::ConstString & path){
+		return add(LinkOperation(LinkOperation::STAT, path));
+	}
+
+	/*! \details Queues a read of all entries in the directory \a path. */
+	int add_read_dir(const var::ConstString & path){
+		return add(LinkOperation(LinkOperation::READ_DIR, path));
+	}
+
+	/*! \details Queues removing the file \a path. */
+	int add_unlink(const var::ConstString & path){
+		return add(LinkOperation(LinkOperation::UNLINK, path));
+	}
+
+	/*! \details Queues creating the directory \a path. */
+	int add_mkdir(const var::ConstString & path, link_mode_t mode = 0777);
+
+	/*! \details Queues reading up to \a size bytes of \a path starting at \a offset. */
+	int add_read(const var::ConstString & path, u32 offset, u32 size);
+
+	/*! \details Returns the number of queued operations. */
+	u32 count() const { return m_operations.count(); }
+
+	/*! \details Returns the operation (and its result) at \a n. */
+	const LinkOperation & at(u32 n) const { return m_operations.at(n); }
+
+	/*! \details Returns all operations. */
+	const var::Vector<LinkOperation> & operations() const { return m_operations; }
+
+	/*! \details Removes all operations. */
+	void clear(){ m_operations.clear(); }
+
+	/*! \details Executes the queued operations.
+	 *
+	 * @param driver The link driver for the device
+	 * @return The number of operations that failed or less than zero if the connection failed
+	 *
+	 * The caller is responsible for locking the device (sys::Link::execute() does this).
+	 * If a physical connection error occurs, the remaining operations are not executed.
+	 *
+	 */
+	int execute(link_transport_mdriver_t * driver);
+
+private:
+	int add(const LinkOperation & operation);
+	int execute_operation(link_transport_mdriver_t * driver, LinkOperation & operation);
+
+	var::Vector<LinkOperation> m_operations;
+};
+
+}
+
+#endif
+
+#endif // SAPI_SYS_LINKBATCH_HPP_
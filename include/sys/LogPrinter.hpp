@@ -0,0 +1,214 @@
+/*! \file */ //Copyright 2011-2019 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_SYS_LOG_PRINTER_HPP_
+#define SAPI_SYS_LOG_PRINTER_HPP_
+
+#include <pthread.h>
+#include "Printer.hpp"
+#include "File.hpp"
+#include "Mutex.hpp"
+#include "Thread.hpp"
+
+/*! \cond */
+typedef struct {
+	const char * format;
+	u32 id;
+} log_printer_format_t;
+
+typedef struct {
+	pthread_t thread;
+	u8 * buffer;
+	log_printer_format_t * format_list; //binary mode only
+	volatile u32 head; //written by the thread that owns the slot
+	volatile u32 tail; //written while holding the write mutex
+	u32 pending; //bytes after head that are not published yet
+	u32 depth;
+	u32 stall_count;
+} log_printer_slot_t;
+/*! \endcond */
+
+namespace sys {
+
+/*! \brief Log Printer Class
+ * \details The Log Printer class is a Printer that doesn't
+ * block on the output.
+ *
+ * Each thread that prints gets its own ring buffer. Messages are formatted
+ * into the calling thread's buffer (without any locking) and a background
+ * thread writes the buffers to a file, the standard output, or a socket
+ * every FLUSH_INTERVAL milliseconds. An indented key/value (including its
+ * indentation and color codes) is published as one entry so entries from
+ * different threads are never mixed. Entries from one thread are written
+ * in order.
+ *
+ * \code
+ * #include <sapi/sys.hpp>
+ *
+ * File file;
+ * file.create("/home/trace.log");
+ *
+ * LogPrinter printer(file);
+ * printer.set_verbose_level(Printer::DEBUG);
+ * printer.debug("sample %d is %0.3f", i, value); //returns without writing to the file
+ * \endcode
+ *
+ * In MODE_BINARY, the message isn't formatted at all. The printer records
+ * an ID for the format string along with the raw arguments (strings are
+ * copied). Each format string is recorded once per thread. Use expand() to
+ * convert the log to text offline.
+ *
+ * \code
+ * LogPrinter printer(file, LogPrinter::MODE_BINARY);
+ * ...
+ * //later (on the host)
+ * LogPrinter::expand(binary_log_file, text_file);
+ * \endcode
+ *
+ * Each of the first THREAD_LIMIT threads that print keeps its buffer for the life
+ * of the printer. Any other thread writes to the output directly. If a buffer
+ * is full, the thread writes the buffers to the output itself
+ * (see stall_count()).
+ *
+ */
+class LogPrinter : public Printer {
+public:
+
+	enum mode {
+		MODE_TEXT /*! Format messages as text when they are printed */,
+		MODE_BINARY /*! Record format string IDs and raw arguments (see expand()) */
+	};
+
+	enum {
+		BUFFER_SIZE /*! Default size of each thread's buffer */ =
+#if defined __link
+		16384,
+#else
+		512,
+#endif
+		THREAD_LIMIT /*! Maximum number of threads with a buffer */ =
+#if defined __link
+		16,
+#else
+		4,
+#endif
+		LINE_SIZE /*! Bytes formatted on the stack (larger messages use the heap) */ =
+#if defined __link
+		512,
+#else
+		128,
+#endif
+		FORMAT_CACHE_SIZE /*! Number of format strings each thread remembers in MODE_BINARY */ =
+#if defined __link
+		128,
+#else
+		16,
+#endif
+		FLUSH_INTERVAL /*! Milliseconds between writes to the output */ = 20,
+		STACK_SIZE /*! Stack size of the writer thread */ =
+#if defined __link
+		65536
+#else
+		1024
+#endif
+	};
+
+	/*! \details Constructs a printer that writes to the standard output.
+	 *
+	 * @param mode MODE_TEXT or MODE_BINARY
+	 * @param buffer_size The size of each thread's buffer
+	 *
+	 */
+	LogPrinter(enum mode mode = MODE_TEXT, u32 buffer_size = BUFFER_SIZE);
+
+	/*! \details Constructs a printer that writes to \a file.
+	 *
+	 * @param file The output (must stay valid for the life of the printer)
+	 * @param mode MODE_TEXT or MODE_BINARY
+	 * @param buffer_size The size of each thread's buffer
+	 *
+	 */
+	LogPrinter(const File & file, enum mode mode = MODE_TEXT, u32 buffer_size = BUFFER_SIZE);
+
+	/*! \details Stops the writer thread and writes anything that is left. */
+	~LogPrinter();
+
+	/*! \details Returns the output mode. */
+	enum mode mode() const { return m_mode; }
+
+	/*! \details Returns the size of each thread's buffer. */
+	u32 buffer_size() const { return m_buffer_size; }
+
+	/*! \details Writes all of the buffers to the output now.
+	 *
+	 * @return Zero on success or less than zero if the output could not be written
+	 *
+	 * This can be called from any thread.
+	 *
+	 */
+	int flush();
+
+	/*! \details Returns the number of times a thread had to write to the output
+	 * itself because its buffer was full.
+	 *
+	 * If this keeps increasing, use a bigger buffer.
+	 *
+	 */
+	u32 stall_count() const;
+
+	/*! \details Converts a log written in MODE_BINARY to text.
+	 *
+	 * @param input The binary log (read from the current location)
+	 * @param output The destination for the text
+	 * @return Zero on success or less than zero if \a input isn't a valid log
+	 *
+	 * The log must be expanded on a machine with the same byte order as the one
+	 * that wrote it.
+	 *
+	 */
+	static int expand(const File & input, const File & output);
+
+protected:
+
+	void vprint(const char * fmt, va_list list);
+	void vprint_indented(const var::ConstString & key, const char * fmt, va_list list);
+
+private:
+
+	/*! \cond */
+	void init(const File & file, enum mode mode, u32 buffer_size);
+	static void * writer_thread(void * args);
+	void * run();
+
+	log_printer_slot_t * slot();
+	log_printer_slot_t * register_slot(pthread_t thread);
+	u32 free_size(const log_printer_slot_t * slot) const;
+	bool reserve(log_printer_slot_t * slot, u32 size);
+	void copy(log_printer_slot_t * slot, const void * data, u32 size);
+	void commit(log_printer_slot_t * slot);
+	void write(log_printer_slot_t * slot, const void * data, u32 size);
+	void write_text(log_printer_slot_t * slot, const char * text, u32 length);
+	void write_direct(const void * data, u32 size);
+	void format(log_printer_slot_t * slot, const char * fmt, va_list list);
+	void encode(log_printer_slot_t * slot, const char * fmt, va_list list);
+	int format_id(log_printer_slot_t * slot, const char * fmt, u32 * id);
+	int drain();
+	int write_output(const void * data, u32 size);
+
+	File m_stdout;
+	const File * m_file;
+	Mutex m_mutex; //registers slots and assigns format IDs
+	Mutex m_write_mutex; //held while the buffers are written to the output
+	Thread m_thread;
+	log_printer_slot_t m_slot[THREAD_LIMIT];
+	volatile u32 m_slot_count;
+	u32 m_buffer_size;
+	u32 m_format_count;
+	enum mode m_mode;
+	volatile bool m_is_running;
+	/*! \endcond */
+
+};
+
+}
+
+#endif // SAPI_SYS_LOG_PRINTER_HPP_
@@ -15,6 +15,7 @@
 
 namespace var {
 class DataInfo;
+class AllocatorInfo;
 class Data;
 class Datum;
 class String;
@@ -150,6 +151,9 @@ public:
 	Printer & operator << (const var::DataInfo & a);
 #endif
 
+	/*! \details Prints a var::AllocatorInfo object. */
+	Printer & operator << (const var::AllocatorInfo & a);
+
 	/*! \details Prints a var::String object. */
 	Printer & operator << (const var::String & a);
 	/*! \details Prints a var::Tokenizer object. */
@@ -42,7 +42,10 @@ enum {
 #else
 
 #define SAPI_API_REQUEST_MBEDTLS &mbedtls_api
-//SAPI_API_REQUEST_ARM_DSP_* not available on Link
+//SAPI_API_REQUEST_ARM_DSP_Q7 and SAPI_API_REQUEST_ARM_DSP_CONVERSION not available on Link
+#define SAPI_API_REQUEST_ARM_DSP_Q15 &host_dsp_api_q15
+#define SAPI_API_REQUEST_ARM_DSP_Q31 &host_dsp_api_q31
+#define SAPI_API_REQUEST_ARM_DSP_F32 &host_dsp_api_f32
 #define SAPI_API_REQUEST_SGFX &sg_api
 #define SAPI_API_REQUEST_SON &son_api
 #define SAPI_API_REQUEST_JSON &jansson_api
@@ -11,6 +11,7 @@
  * Here is a brief summary of the most commonly used classes:
  *
  * - Data: manages static and dynamic allocation of memory ensuring no memory leaks
+ * - Allocator: arena and pool allocators that Data, String, Vector and LinkedList can use instead of malloc()
  * - String: An embedded friendly String object that implements many methods from std::string
  * - Queue: similar to std::queue (inherits LinkedList)
  * - Vector: similar to std::vector (inherits Data)
@@ -22,6 +23,7 @@
  */
 namespace var {}
 
+#include "var/Allocator.hpp"
 #include "var/Data.hpp"
 #include "var/Flags.hpp"
 #include "var/Item.hpp"
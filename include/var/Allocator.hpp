@@ -0,0 +1,241 @@
+/*! \file */ //Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_VAR_ALLOCATOR_HPP_
+#define SAPI_VAR_ALLOCATOR_HPP_
+
+#include "../api/VarObject.hpp"
+
+namespace var {
+
+/*! \brief Allocator Information Class
+ * \details The Allocator Information class holds the usage
+ * statistics of a var::Allocator. The accessors match
+ * var::DataInfo so the same reporting code can be used for
+ * the heap and for arenas and pools.
+ *
+ */
+class AllocatorInfo : public api::VarInfoObject {
+public:
+	AllocatorInfo(){
+		m_arena = 0;
+		m_free_block_count = 0;
+		m_free_size = 0;
+		m_used_size = 0;
+		m_allocation_count = 0;
+		m_failure_count = 0;
+		m_peak_used_size = 0;
+	}
+
+	/*! \details Returns the total number of bytes managed by the allocator. */
+	u32 arena() const { return m_arena; }
+	/*! \details Returns the number of free blocks (one for an arena). */
+	u32 free_block_count() const { return m_free_block_count; }
+	/*! \details Returns the number of bytes that are free. */
+	u32 free_size() const { return m_free_size; }
+	/*! \details Returns the number of bytes in use. */
+	u32 used_size() const { return m_used_size; }
+	/*! \details Returns the number of successful allocations since the allocator was created. */
+	u32 allocation_count() const { return m_allocation_count; }
+	/*! \details Returns the number of allocations that failed. */
+	u32 failure_count() const { return m_failure_count; }
+	/*! \details Returns the largest value used_size() has reached. */
+	u32 peak_used_size() const { return m_peak_used_size; }
+
+	/*! \cond */
+	u32 m_arena;
+	u32 m_free_block_count;
+	u32 m_free_size;
+	u32 m_used_size;
+	u32 m_allocation_count;
+	u32 m_failure_count;
+	u32 m_peak_used_size;
+	/*! \endcond */
+};
+
+/*! \brief Allocator Class
+ * \details The Allocator class is the interface that var::Data
+ * (and the containers built on it such as var::String and
+ * var::Vector) and var::LinkedList use to get memory.
+ *
+ * Objects use malloc() and free() unless an allocator is assigned
+ * with set_allocator(). The allocator must outlive every object
+ * that uses it.
+ *
+ * Allocators are not thread safe. Use one allocator per thread
+ * or protect access with a sys::Mutex.
+ *
+ * \code
+ * #include <sapi/var.hpp>
+ *
+ * ArenaAllocator frame_arena(4096);
+ *
+ * while(1){
+ *   {
+ *     String line;
+ *     line.set_allocator(&frame_arena);
+ *     line << "status: " << status;
+ *     display(line);
+ *   }
+ *   frame_arena.reset(); //all memory from the frame is reclaimed at once
+ * }
+ * \endcode
+ *
+ */
+class Allocator : public api::VarWorkObject {
+public:
+	virtual ~Allocator(){}
+
+	/*! \details Allocates \a size bytes.
+	 *
+	 * @return A pointer to the memory or null with error_number() set to ENOMEM
+	 */
+	virtual void * allocate(u32 size) = 0;
+
+	/*! \details Returns memory that was allocated with allocate(). */
+	virtual void deallocate(void * mem) = 0;
+
+	/*! \details Changes the size of \a mem without moving it.
+	 *
+	 * @param mem Memory that was allocated with allocate()
+	 * @param size The new size in bytes
+	 * @return Zero if \a mem now holds \a size bytes or less than zero if it can't be resized in place
+	 *
+	 * var::Data calls this before it allocates a new block and copies. The
+	 * default implementation never resizes.
+	 *
+	 */
+	virtual int resize(void *, u32){ return -1; }
+
+	/*! \details Returns the usage statistics of the allocator. */
+	const AllocatorInfo & info() const { return m_info; }
+
+protected:
+	/*! \cond */
+	void update_used_size(u32 used_size, u32 free_size, u32 free_block_count){
+		m_info.m_used_size = used_size;
+		m_info.m_free_size = free_size;
+		m_info.m_free_block_count = free_block_count;
+		if( used_size > m_info.m_peak_used_size ){
+			m_info.m_peak_used_size = used_size;
+		}
+	}
+
+	AllocatorInfo m_info;
+	/*! \endcond */
+
+};
+
+/*! \brief Arena Allocator Class
+ * \details The Arena Allocator class hands out memory from
+ * one buffer by moving a pointer forward (a bump allocator).
+ *
+ * Freeing memory doesn't make it available again, except for the most
+ * recent allocation, which is rolled back. The most recent allocation
+ * can also grow or shrink in place with resize(), so a var::Data or
+ * var::String that is growing at the end of the arena doesn't leave
+ * its old buffer behind. Any other block stays in use until
+ * all memory is reclaimed at once with reset(), typically at the end of a
+ * frame or a request.
+ *
+ * Because the arena never returns memory to the heap piece by piece,
+ * short-lived objects that use it don't fragment the heap.
+ *
+ */
+class ArenaAllocator : public Allocator {
+public:
+
+	/*! \details Constructs an arena that allocates \a size bytes from the heap. */
+	ArenaAllocator(u32 size);
+
+	/*! \details Constructs an arena that uses \a mem (not freed by the arena). */
+	ArenaAllocator(void * mem, u32 size);
+
+	~ArenaAllocator();
+
+	void * allocate(u32 size);
+	void deallocate(void * mem);
+	int resize(void * mem, u32 size);
+
+	/*! \details Makes all memory in the arena available again.
+	 *
+	 * Any object still using memory from the arena must not
+	 * be accessed after reset() is called.
+	 *
+	 */
+	void reset();
+
+	/*! \details Returns the number of bytes handed out since the last reset(). */
+	u32 used_size() const { return m_offset; }
+
+private:
+	ArenaAllocator(const ArenaAllocator & a);
+	ArenaAllocator & operator = (const ArenaAllocator & a);
+
+	void update_info();
+
+	u8 * m_mem;
+	u32 m_size;
+	u32 m_offset;
+	u32 m_last_offset;
+	bool m_is_internally_managed;
+};
+
+/*! \brief Pool Allocator Class
+ * \details The Pool Allocator class hands out blocks of one fixed size
+ * from a buffer that is allocated once.
+ *
+ * Allocation and deallocation are O(1) and never fragment the heap.
+ * Requests larger than block_size() fail. The pool is a good fit for
+ * var::LinkedList items and for containers whose
+ * maximum size is known.
+ *
+ */
+class PoolAllocator : public Allocator {
+public:
+
+	/*! \details Constructs a pool of \a block_count blocks of \a block_size bytes from the heap. */
+	PoolAllocator(u32 block_size, u32 block_count);
+
+	/*! \details Constructs a pool that uses \a mem (not freed by the pool).
+	 *
+	 * @param block_size The number of bytes in each block
+	 * @param mem A pointer to the memory for the pool
+	 * @param size The number of bytes at \a mem
+	 *
+	 */
+	PoolAllocator(u32 block_size, void * mem, u32 size);
+
+	~PoolAllocator();
+
+	void * allocate(u32 size);
+	void deallocate(void * mem);
+	int resize(void *, u32 size){ return size <= m_block_size ? 0 : -1; }
+
+	/*! \details Returns the number of bytes in each block. */
+	u32 block_size() const { return m_block_size; }
+
+	/*! \details Returns the number of blocks in the pool. */
+	u32 block_count() const { return m_block_count; }
+
+private:
+	PoolAllocator(const PoolAllocator & a);
+	PoolAllocator & operator = (const PoolAllocator & a);
+
+	void initialize(u32 block_size, void * mem, u32 size);
+	void update_info();
+
+	typedef struct pool_block {
+		struct pool_block * next;
+	} pool_block_t;
+
+	u8 * m_mem;
+	pool_block_t * m_free_list;
+	u32 m_block_size;
+	u32 m_block_count;
+	u32 m_free_count;
+	bool m_is_internally_managed;
+};
+
+}
+
+#endif // SAPI_VAR_ALLOCATOR_HPP_
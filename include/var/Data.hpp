@@ -6,6 +6,7 @@
 #include <cstring>
 #include <cstdio>
 #include "../api/VarObject.hpp"
+#include "Allocator.hpp"
 
 #if !defined __link
 #include <malloc.h>
@@ -159,6 +160,21 @@ public:
 	 */
 	virtual ~Data();
 
+	/*! \details Sets the allocator used for dynamic memory.
+	 *
+	 * @param allocator The allocator to use (null to use malloc() and free())
+	 * @return Zero on success or -1 if the object already holds dynamically allocated memory
+	 *
+	 * The allocator must outlive the object (or the object must be freed
+	 * before the allocator is reset). When an allocator is used, allocations
+	 * are not rounded up to minimum_size() and block_size().
+	 *
+	 */
+	int set_allocator(Allocator * allocator);
+
+	/*! \details Returns the allocator used for dynamic memory (null for malloc() and free()). */
+	Allocator * allocator() const { return m_allocator; }
+
 	/*! \details Returns the minimum data storage size of any Data object. */
 	static u32 minimum_size();
 	static u32 block_size();
@@ -219,7 +235,10 @@ public:
 	 * this will return an error.
 	 *
 	 * If the current capacity is less than \a s, the object will
-	 * be resized and possibly copied to a new location.
+	 * be resized and possibly copied to a new location. The new
+	 * capacity is at least growth_factor_percent() of the old capacity
+	 * so that growing the data a few bytes at a time costs
+	 * O(n) copying rather than O(n^2).
 	 *
 	 * If the capacity is more than \a s, the effective size
 	 * will be updated to \a s.
@@ -230,6 +249,41 @@ public:
 	//doesn't really make sense to set the capacity because it will always jump to the next largest block
 	int set_capacity(u32 s){ return set_size(s); }
 
+	/*! \details Makes sure the capacity is at least \a s bytes without changing size().
+	 *
+	 * @param s The number of bytes to reserve
+	 * @return Zero on success or -1 if memory could not be allocated
+	 *
+	 * The capacity is set to exactly \a s bytes (rounded up to a block),
+	 * rather than grown geometrically. Use this when the final size is known.
+	 *
+	 */
+	int reserve(u32 s);
+
+	/*! \details Frees capacity that isn't needed to hold size() bytes.
+	 *
+	 * @return Zero on success or -1 if memory could not be allocated
+	 *
+	 * Data that isn't internally managed is not affected.
+	 *
+	 */
+	int shrink_to_fit();
+
+	/*! \details Returns the capacity to use when growing from \a capacity to hold \a size bytes.
+	 *
+	 * The result is the larger of \a size and \a capacity times
+	 * growth_factor_percent().
+	 *
+	 */
+	static u32 calculate_growth(u32 capacity, u32 size);
+
+	/*! \details Returns the percentage of the current capacity that data grows to.
+	 *
+	 * This can be changed at build time by defining SAPI_DATA_GROWTH_FACTOR_PERCENT.
+	 *
+	 */
+	static u32 growth_factor_percent();
+
 
 	/*!
 	 * \details Returns the effective size of the data.
@@ -598,6 +652,7 @@ private:
 
 	static const int m_zero_value;
 
+	Allocator * m_allocator;
 	const void * m_mem;
 	void * m_mem_write;
 	u32 m_capacity;
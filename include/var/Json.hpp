@@ -14,6 +14,9 @@ namespace var {
 #undef FALSE
 
 class JsonDocument;
+/*! \cond */
+class JsonLazyDocument;
+/*! \endcond */
 
 class JsonError : public api::VarInfoObject {
 public:
@@ -71,7 +74,7 @@ public:
 	  * \endcode
 	  *
 	  */
-	bool is_valid() const{ return m_value != 0; }
+	bool is_valid() const{ return (m_value != 0) || (m_document != 0); }
 
 	enum type {
 		INVALID = -1,
@@ -89,9 +92,24 @@ public:
 		if( m_value ){
 			return (enum type)json_typeof(m_value);
 		}
+		if( m_document ){
+			return lazy_type();
+		}
 		return INVALID;
 	}
 
+	/*! \details Returns true if the value refers to a document that
+	 * was loaded using JsonDocument::LAZY.
+	 *
+	 * Lazy values are read directly from the document text when
+	 * they are accessed. Modifying a lazy value (or inserting it into
+	 * another object or array) converts it to a regular value first.
+	 * The conversion applies only to the value being modified (the
+	 * document it came from is not changed).
+	 *
+	 */
+	bool is_lazy() const { return m_document != 0; }
+
 	bool is_object() const { return type() == OBJECT; }
 	bool is_array() const { return type() == ARRAY; }
 	bool is_string() const { return type() == STRING; }
@@ -228,6 +246,8 @@ public:
 
 protected:
 	int create_if_not_valid();
+	int materialize();
+	JsonValue to_regular() const;
 	virtual json_t * create(){
 		printf("create JSON Value -- 0\n");
 		return 0;
@@ -247,8 +267,14 @@ private:
 	friend class JsonString;
 	friend class JsonNull;
 	json_t * m_value;
+	JsonLazyDocument * m_document;
+	u32 m_token;
 
+	JsonValue(JsonLazyDocument * document, u32 token);
 	void add_reference(json_t * value);
+	void add_reference(const JsonValue & value);
+	void release();
+	enum type lazy_type() const;
 
 	static JsonApi m_api;
 
@@ -418,6 +444,26 @@ private:
  * that can be loaded and saved from
  * either memory or the filesystem.
  *
+ * By default, the entire document is parsed when it is loaded. For
+ * large documents where only a few values are needed, add the LAZY flag.
+ * The document is then indexed once (the location of each bracket,
+ * separator and value is recorded and the structure is checked), and values
+ * are only parsed when they are accessed. The index and the lookup tables
+ * built for accessed objects and arrays are allocated from one arena that is
+ * freed in one step when the last value referring to the document is destroyed.
+ *
+ * In lazy mode, brackets, separators, literals and numbers are checked when the
+ * document is loaded. String contents (escapes) are checked when they are read.
+ * Duplicate keys are kept (JsonObject::at() returns the last one). Values
+ * from one lazy document should not be accessed from more than one
+ * thread at a time because the lookup tables are built on first access.
+ *
+ * \code
+ * JsonDocument document(JsonDocument::LAZY);
+ * JsonObject manifest = document.load_from_file("/home/manifest.json").to_object();
+ * String version = manifest.at("version").to_string(); //only "version" is parsed
+ * \endcode
+ *
  */
 class JsonDocument : public api::VarWorkObject {
 public:
@@ -467,6 +513,18 @@ public:
 
 	int save_to_file(const JsonValue & value, const var::ConstString & path) const;
 	var::String stringify(const JsonValue & value) const;
+
+	/*! \details Writes \a value to \a file.
+	 *
+	 * @param value The value to write
+	 * @param file The destination (any sys::File including sys::DataFile and inet::Socket)
+	 * @return Zero on success
+	 *
+	 * The output is collected in a SAVE_BUFFER_SIZE buffer so the file is written
+	 * in large pieces rather than one token at a time. To write a large document
+	 * without building it in memory first, use sys::JsonPrinter.
+	 *
+	 */
 	int save_to_file(const JsonValue & value, const sys::File & file) const;
 	int save(const JsonValue & value, json_dump_callback_t callback, void * context) const;
 
@@ -489,7 +547,17 @@ public:
 		ENCODE_ANY = JSON_ENCODE_ANY,
 		PRESERVE_ORDER = JSON_PRESERVE_ORDER,
 		ESCAPE_SLASH = JSON_ESCAPE_SLASH,
-		EMBED = JSON_EMBED
+		EMBED = JSON_EMBED,
+		LAZY /*! Index the document when it is loaded and parse values when they are accessed */ = 0x40000000
+	};
+
+	enum {
+		SAVE_BUFFER_SIZE /*! Number of bytes buffered by save_to_file(const JsonValue&, const sys::File&) */ =
+#if defined __link
+		4096
+#else
+		256
+#endif
 	};
 
 	const JsonError & error() const { return m_error; }
@@ -500,6 +568,8 @@ private:
 	JsonError m_error;
 
 	static size_t load_file_data(void *buffer, size_t buflen, void *data);
+	u32 jansson_flags() const { return m_flags & ~LAZY; }
+	JsonValue load_lazy(json_load_callback_t callback, void * context, u32 size_hint);
 
 };
 
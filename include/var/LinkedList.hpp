@@ -3,6 +3,7 @@
 
 #include <cstdlib>
 #include "../api/VarObject.hpp"
+#include "Allocator.hpp"
 
 namespace var {
 
@@ -23,6 +24,23 @@ public:
 	LinkedList(LinkedList && list);
 	LinkedList & operator=(LinkedList && list);
 
+	/*! \details Sets the allocator used for list items.
+	 *
+	 * @param allocator The allocator to use (null to use malloc() and free())
+	 * @return Zero on success or -1 if the list is not empty
+	 *
+	 * All items are the same size, so a var::PoolAllocator with
+	 * a block size of item_size() is a good fit.
+	 *
+	 */
+	int set_allocator(Allocator * allocator);
+
+	/*! \details Returns the allocator used for list items (null for malloc() and free()). */
+	Allocator * allocator() const { return m_allocator; }
+
+	/*! \details Returns the number of bytes allocated for each item (including the links). */
+	u32 item_size() const { return calc_item_size(); }
+
 	/*! \details Returns a pointer to the data
 	 * stored in the back list element.
 	 */
@@ -90,6 +108,7 @@ private:
 	u16 m_list_size;
 	item_t * m_front;
 	item_t * m_back;
+	Allocator * m_allocator;
 
 	static void * data(const item_t * item){
 		if( item ){
@@ -108,9 +127,8 @@ private:
 		return 0;
 	}
 
-	item_t * new_item(){
-		return (item_t*)malloc(calc_item_size());
-	}
+	item_t * new_item();
+	void delete_item(item_t * item);
 
 	u16 calc_item_size() const { return sizeof(item_t) + m_list_size; }
 	/*! \endcond */
@@ -9,6 +9,7 @@
 #include <cstdarg>
 #include <cstdlib>
 #include <cstdio>
+#include <utility>
 
 #include "Data.hpp"
 #include "ConstString.hpp"
@@ -97,10 +98,29 @@ public:
 	String(const String & a) : Data(a), ConstString(cdata_const()){
 		set_string_pointer(cdata_const());
 	}
-	String(String && a) : Data(a), ConstString(Data::to_char()){
+
+	/*! \details Constructs a string by taking the memory of \a a.
+	  *
+	  * If \a a is dynamically allocated, no memory is allocated
+	  * or copied.
+	  *
+	  */
+	String(String && a) : Data(std::move(a)), ConstString(Data::to_char()){
 		set_string_pointer(Data::to_char());
 	}
 
+	/*! \details Constructs a string that uses \a mem for storage.
+	  *
+	  * @param mem A pointer to the memory that holds the string
+	  * @param capacity The number of bytes available at \a mem (including the zero terminator)
+	  * @param is_read_only True if \a mem is in read-only memory
+	  *
+	  * The memory is not managed by the String. The string can't
+	  * grow beyond \a capacity-1 characters.
+	  *
+	  */
+	String(char * mem, u32 capacity, bool is_read_only = false);
+
 	/*! \details Declares a string and initialize to \a s. */
 	String(const ConstString & s);
 
@@ -199,13 +219,30 @@ public:
 	String& operator<<(char c){ append(c); return *this; }
 
 
-	/*! \details Appends a string to this string and returns a new string. */
-	String operator + (const ConstString & a){
-		String ret = *this;
+	/*! \details Appends a string to this string and returns a new string.
+	  *
+	  * The new string is allocated once, with enough capacity for both strings.
+	  *
+	  */
+	String operator + (const ConstString & a) const & {
+		String ret;
+		ret.set_capacity(length() + a.length());
+		ret.assign(*this);
 		ret.append(a);
 		return ret;
 	}
 
+	/*! \details Appends a string to a temporary string and returns it.
+	  *
+	  * This is used for chains such as `String(a) + b + c`. The temporary's
+	  * memory is reused, so each step only allocates if it needs more capacity.
+	  *
+	  */
+	String operator + (const ConstString & a) && {
+		append(a);
+		return std::move(*this);
+	}
+
 	~String(){}
 
 	//these are both implemented in Data and ConstString -- need to be disambiguated
@@ -228,6 +265,12 @@ public:
 	int set_size(u32 s);
 	int set_capacity(u32 s){ return set_size(s); }
 
+	/*! \details Makes room for \a s characters (plus a zero terminator) without growing geometrically. */
+	int reserve(u32 s);
+
+	/*! \details Frees capacity that isn't needed to hold the current string. */
+	int shrink_to_fit();
+
 
 	/*! \details Gets a sub string of the string.
 	  *
@@ -379,6 +422,94 @@ private:
 };
 
 
+/*! \brief String Builder Class
+ * \details The String Builder class builds a string
+ * from a sequence of appends using one buffer.
+ *
+ * Strings up to INLINE_CAPACITY characters are built in
+ * memory inside the object, so no dynamic memory is allocated.
+ * Longer strings move to the heap the first time they don't fit.
+ * After that the capacity at least doubles each time it grows.
+ * Numbers are formatted straight into the buffer rather
+ * than into a temporary String.
+ *
+ * \code
+ * #include <sapi/var.hpp>
+ *
+ * StringBuilder line;
+ * line << "Value is 0x";
+ * line.append_format("%08lX", value);
+ * line << " at " << name << '\n';
+ * printf("%s", line.cstring());
+ * \endcode
+ *
+ * Use reserve() if the final length is known, so the buffer
+ * is allocated only once.
+ *
+ */
+class StringBuilder : public api::VarWorkObject {
+public:
+
+	enum {
+		INLINE_CAPACITY /*! Number of characters that can be built without dynamic memory allocation */ = 63
+	};
+
+	/*! \details Constructs an empty string builder.
+	 *
+	 * @param capacity The number of characters to reserve (no allocation if less than INLINE_CAPACITY)
+	 *
+	 */
+	StringBuilder(u32 capacity = 0);
+
+	/*! \details Makes sure at least \a capacity characters fit without another allocation.
+	 *
+	 * @return Zero on success or less than zero if memory could not be allocated
+	 */
+	int reserve(u32 capacity);
+
+	/*! \details Appends \a a to the string. */
+	StringBuilder & operator << (const ConstString & a){ append(a.cstring(), a.length()); return *this; }
+	/*! \details Appends \a c to the string. */
+	StringBuilder & operator << (char c){ append(&c, 1); return *this; }
+
+	/*! \details Appends \a length bytes of \a a to the string. */
+	int append(const char * a, u32 length);
+
+	/*! \details Appends a printf() style formatted string to the string. */
+	StringBuilder & append_format(const char * format, ...);
+
+	/*! \details Sets the length to zero (the capacity is not changed). */
+	void clear();
+
+	/*! \details Returns the length of the string. */
+	u32 length() const { return m_length; }
+
+	/*! \details Returns the number of characters that fit in the current buffer. */
+	u32 capacity() const { return m_string.capacity(); }
+
+	/*! \details Returns true if the string is still stored inside the object. */
+	bool is_inline() const { return m_string.cstring() == m_inline; }
+
+	/*! \details Returns a pointer to the zero terminated string. */
+	const char * cstring() const { return m_string.cstring(); }
+
+	/*! \details Returns a read-only reference to the string. */
+	const String & string() const { return m_string; }
+
+	/*! \details Returns a copy of the string that can outlive the builder. */
+	String to_string() const { return String(ConstString(cstring()), m_length); }
+
+private:
+	//builders refer to their own memory -- copying would share it
+	StringBuilder(const StringBuilder & a);
+	StringBuilder & operator = (const StringBuilder & a);
+
+	String m_string;
+	u32 m_length;
+	char m_inline[INLINE_CAPACITY+1];
+};
+
+
 template <unsigned int arraysize>
 class StaticString : public String {
 public:
@@ -4,9 +4,164 @@
 #define SAPI_VAR_TOKENIZER_HPP_
 
 #include "String.hpp"
+#include "Vector.hpp"
 
 namespace var {
 
+/*! \brief Character Set Class
+ * \details The Character Set class is a 256-bit lookup table
+ * used to test whether a character is a delimiter (or an ignore character)
+ * in constant time.
+ *
+ */
+class CharacterSet {
+public:
+	/*! \details Constructs a set containing each character of \a characters. */
+	CharacterSet(const ConstString & characters);
+
+	/*! \details Returns true if \a c is in the set. */
+	bool is_member(char c) const {
+		return (m_table[(u8)c >> 5] & (1UL << ((u8)c & 0x1f))) != 0;
+	}
+
+	/*! \details Returns true if the set has no members. */
+	bool is_empty() const { return m_is_empty; }
+
+private:
+	u32 m_table[8];
+	bool m_is_empty;
+};
+
+/*! \brief Token View Class
+ * \details The Token View class refers to a token inside
+ * a string that belongs to someone else. The token is not
+ * zero terminated. Use to_string() to get a copy that is.
+ *
+ */
+class TokenView {
+public:
+	TokenView(){ m_data = ""; m_length = 0; }
+	TokenView(const char * data, u32 length){ m_data = data; m_length = length; }
+
+	/*! \details Returns a pointer to the first character of the token (not zero terminated). */
+	const char * data() const { return m_data; }
+
+	/*! \details Returns the number of characters in the token. */
+	u32 length() const { return m_length; }
+
+	/*! \details Returns true if the token has no characters. */
+	bool is_empty() const { return m_length == 0; }
+
+	/*! \details Returns the character at \a pos (zero if \a pos is past the end). */
+	char at(u32 pos) const { return pos < m_length ? m_data[pos] : 0; }
+
+	/*! \details Returns true if the token matches \a a exactly. */
+	bool operator == (const ConstString & a) const {
+		return (strncmp(m_data, a.cstring(), m_length) == 0) && (a.cstring()[m_length] == 0);
+	}
+
+	bool operator != (const ConstString & a) const { return !(*this == a); }
+
+	/*! \details Returns a zero terminated copy of the token. */
+	String to_string() const { return String(ConstString(m_data), m_length); }
+
+private:
+	const char * m_data;
+	u32 m_length;
+};
+
+/*! \brief Constant Tokenizer Class
+ * \details The Constant Tokenizer class splits a string into tokens
+ * without copying or modifying it (see var::Tokenizer for a version that
+ * does copy and modify).
+ *
+ * One pass over the source records the offset and length of
+ * each token. at() is O(1), and the tokens can be walked with an iterator.
+ * The source must stay valid (and unchanged) while the tokens are used.
+ *
+ * The delimiter, ignore and count empty options work the same
+ * as var::Tokenizer::parse().
+ *
+ * \code
+ * #include <sapi/var.hpp>
+ *
+ * ConstTokenizer fields(line, ",");
+ * for(ConstTokenizer::Iterator it = fields.begin(); it != fields.end(); ++it){
+ *   if( *it == "ERROR" ){ error_count++; }
+ * }
+ * \endcode
+ *
+ */
+class ConstTokenizer : public api::VarWorkObject {
+public:
+
+	/*! \details Iterates over the tokens in order. */
+	class Iterator {
+	public:
+		Iterator(const ConstTokenizer * tokenizer, u32 index){ m_tokenizer = tokenizer; m_index = index; }
+		TokenView operator*() const { return m_tokenizer->at(m_index); }
+		Iterator & operator++(){ m_index++; return *this; }
+		bool operator == (const Iterator & a) const { return m_index == a.m_index; }
+		bool operator != (const Iterator & a) const { return m_index != a.m_index; }
+		u32 index() const { return m_index; }
+	private:
+		const ConstTokenizer * m_tokenizer;
+		u32 m_index;
+	};
+
+	ConstTokenizer(){ m_source = ""; }
+
+	/*! \details Constructs and parses a new tokenizer.
+	 *
+	 * @param src The source string (not copied)
+	 * @param delim Delimiter string
+	 * @param ignore Ignore string
+	 * @param count_empty Create empty tokens
+	 * @param max_delim The maximum number of delimiters to parse before giving up (0 for no limit)
+	 *
+	 */
+	ConstTokenizer(const ConstString & src, const ConstString & delim, const ConstString & ignore = "", bool count_empty = false, u32 max_delim = 0);
+
+	/*! \details Parses \a src into tokens.
+	 *
+	 * @return The number of tokens or less than zero if memory for the index could not be allocated
+	 *
+	 * See Tokenizer::parse() for details about \a delim, \a ignore and \a max_delim.
+	 *
+	 */
+	int parse(const ConstString & src, const ConstString & delim, const ConstString & ignore = "", bool count_empty = false, u32 max_delim = 0);
+
+	/*! \details Returns the total number of tokens. */
+	u32 count() const { return m_tokens.count(); }
+
+	/*! \details Returns the token at \a n (an empty token if \a n is out of range). */
+	TokenView at(u32 n) const {
+		if( n < m_tokens.count() ){
+			return TokenView(m_source + m_tokens.at(n).offset, m_tokens.at(n).length);
+		}
+		return TokenView();
+	}
+
+	/*! \details Returns the offset of token \a n in the source string. */
+	u32 offset(u32 n) const { return n < m_tokens.count() ? m_tokens.at(n).offset : 0; }
+
+	Iterator begin() const { return Iterator(this, 0); }
+	Iterator end() const { return Iterator(this, count()); }
+
+private:
+	/*! \cond */
+	typedef struct {
+		u32 offset;
+		u32 length;
+	} token_t;
+	/*! \endcond */
+
+	int add_token(u32 offset, u32 length);
+
+	const char * m_source;
+	Vector<token_t> m_tokens;
+};
+
 /*! \brief Tokenize a String
  * \details The Token Class can convert any String into a list of tokens.  The
  * class is similar to STDC strtok().
@@ -65,7 +220,12 @@ public:
 	/*! \details Returns the total number of tokens. */
 	u32 count() const { return m_num_tokens; }
 
-	/*! \details Returns a pointer to the token specified by offset. */
+	/*! \details Returns a pointer to the token specified by offset.
+	 *
+	 * The start of each token is recorded when the string is parsed,
+	 * so this is O(1).
+	 *
+	 */
 	const ConstString at(u32 n) const;
 
 	static bool belongs_to(const char c, const ConstString & str, unsigned int len);
@@ -87,6 +247,9 @@ protected:
 
 private:
 	void init_members();
+	void parse_tokens(const ConstString & delim, const ConstString & ignore, u32 max_delim);
+	void index_tokens();
+	Vector<u32> m_offsets;
 	unsigned int m_num_tokens;
 	unsigned int m_string_size;
 	bool m_is_count_empty_tokens;
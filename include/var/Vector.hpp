@@ -68,14 +68,20 @@ public:
 	  * that is no longer valid.
 	  *
 	  */
-	T & at(u32 pos){ return Data::at<T>(pos); }
+	T & at(u32 pos){
+		if( pos >= m_count ){ pos = 0; }
+		return vector_data()[pos];
+	}
 
 	/*! \details Provides a read-only reference to an element in the Vector.
 	  *
 	  * The same limitations apply to this method as apply to the read-write version.
 	  *
 	  */
-	const T & at(u32 pos) const { return Data::at<T>(pos); }
+	const T & at(u32 pos) const {
+		if( pos >= m_count ){ pos = 0; }
+		return vector_data_const()[pos];
+	}
 
 	/*! \details Provides un-bounded access to the specified element (read-only).
 	  *
@@ -178,7 +184,9 @@ public:
 
 	/*! \details Frees unused memory that is reserved for this Vector. */
 	void shrink_to_fit(){
-		Data::resize(m_count*sizeof(T));
+		//only the elements in use are kept
+		Data::set_size(m_count*sizeof(T));
+		Data::shrink_to_fit();
 	}
 
 	/*! \details Resizes the vector.
@@ -228,9 +236,7 @@ public:
 	  *
 	  */
 	void reserve(u32 new_capacity){
-		if( Data::capacity() < new_capacity*sizeof(T) ){
-			Data::resize(new_capacity*sizeof(T));
-		}
+		Data::reserve(new_capacity*sizeof(T));
 	}
 
 	/*! \details Removes all elements from the vector.
@@ -428,9 +434,13 @@ private:
 
 	int add_space(){
 		if( (capacity() == 0) || (count() >= capacity()-1) ){
-			if( Data::resize((m_count + jump_size()) * sizeof(T)) < 0 ){
+			//grow geometrically so push_back() in a loop is amortized O(1)
+			u32 new_capacity = Data::calculate_growth(Data::capacity(), (m_count + jump_size()) * sizeof(T));
+			if( Data::reserve(new_capacity) < 0 ){
 				return -1;
 			}
+			//keep the Data size in step with the element storage
+			Data::set_size(Data::capacity());
 		}
 		return 0;
 	}
@@ -7,183 +7,259 @@
 
 using namespace calc;
 
+static const char encode_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+//0xff marks characters that are not part of the base64 alphabet
+static const u8 decode_table[256] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+//reads until size bytes are read or the end of the file is reached
+static int read_chunk(const sys::File & input, char * buffer, u32 size){
+	u32 total = 0;
+	int result;
+	while( total < size ){
+		result = input.read(buffer + total, size - total);
+		if( result < 0 ){ return -1; }
+		if( result == 0 ){ break; }
+		total += result;
+	}
+	return total;
+}
+
 int Base64::encode(const sys::File & input, sys::File & output, u32 size){
-	u32 chunk_size = 96;
-	const u32 output_buffer_size = calc_encoded_size(chunk_size);
-	char input_buffer[chunk_size];
-	char output_buffer[output_buffer_size];
+	var::Data input_buffer(STREAM_CHUNK_SIZE);
+	var::Data output_buffer(calc_encoded_size(STREAM_CHUNK_SIZE) + 1);
 	u32 size_processed = 0;
 	int result;
+
+	if( (input_buffer.size() != STREAM_CHUNK_SIZE) || (output_buffer.size() == 0) ){
+		return -1;
+	}
+
 	do {
-		if( size - size_processed < chunk_size ){ chunk_size = size - size_processed; }
-		result = input.read(input_buffer, chunk_size);
+		u32 chunk_size = STREAM_CHUNK_SIZE;
+		if( size && (size - size_processed < chunk_size) ){ chunk_size = size - size_processed; }
+
+		//only the last chunk can have a length that isn't a multiple of 3 (padding)
+		result = read_chunk(input, input_buffer.to_char(), chunk_size);
+		if( result < 0 ){ return -1; }
 		if( result > 0 ){
 			size_processed += result;
-			int len = encode(output_buffer, input_buffer, result);
-			if( output.write(output_buffer, len) != len ){
-				result = 0;
+			int len = encode(output_buffer.to_char(), input_buffer.to_void(), result);
+			if( output.write(output_buffer.to_void(), len) != len ){
+				return -1;
 			}
 		}
-	} while( (result > 0) && (size > size_processed) );
+		if( (u32)result < chunk_size ){ break; }
+	} while( (size == 0) || (size > size_processed) );
 	return size_processed;
 }
 
 int Base64::decode(const sys::File & input, sys::File & output, u32 size){
-	u32 chunk_size = 96;
-	const u32 output_buffer_size = calc_decoded_size(chunk_size);
-	char input_buffer[chunk_size];
-	char output_buffer[output_buffer_size];
+	const u32 chunk_capacity = calc_encoded_size(STREAM_CHUNK_SIZE);
+	var::Data input_buffer(chunk_capacity);
+	var::Data output_buffer(STREAM_CHUNK_SIZE);
 	u32 size_processed = 0;
+	bool is_padded = false;
 	int result;
 
+	if( (input_buffer.size() != chunk_capacity) || (output_buffer.size() != STREAM_CHUNK_SIZE) ){
+		return -1;
+	}
+
 	do {
-		if( size - size_processed < chunk_size ){ chunk_size = size - size_processed; }
-		result = input.read(input_buffer, chunk_size);
+		u32 chunk_size = chunk_capacity;
+		if( size && (size - size_processed < chunk_size) ){ chunk_size = size - size_processed; }
+
+		result = read_chunk(input, input_buffer.to_char(), chunk_size);
+		if( result < 0 ){ return -1; }
 		if( result > 0 ){
+			//padding is only valid in the last group of the input
+			if( is_padded ){ return -1; }
 			size_processed += result;
-			int len = calc_decoded_size(result);
-			decode(output_buffer, input_buffer, result);
-			if( output.write(output_buffer, len) != len ){
-				result = 0;
+			int len = decode(output_buffer.to_void(), input_buffer.to_char(), result);
+			if( len < 0 ){ return -1; }
+			is_padded = (u32)len < calc_decoded_size(result);
+			if( output.write(output_buffer.to_void(), len) != len ){
+				return -1;
 			}
-
 		}
-	} while( (result > 0) && (size > size_processed) );
+		if( (u32)result < chunk_size ){ break; }
+	} while( (size == 0) || (size > size_processed) );
 
 	return size_processed;
 }
 
 var::String Base64::encode(const var::Data & input){
 	var::String result;
-
-	if( result.set_capacity( calc_encoded_size(input.size()) ) < 0 ){
+	if( encode(input, result) < 0 ){
 		return var::String();
 	}
-
-	encode(result.to<char>(), input.to_void(), input.size());
 	return result;
 }
 
+int Base64::encode(const var::Data & input, var::String & output){
+	u32 len = calc_encoded_size(input.size());
+
+	//an empty string may not have memory for the terminator
+	if( ((output.capacity() < len) || (output.to<char>() == 0)) && (output.set_capacity(len) < 0) ){
+		return -1;
+	}
+
+	return encode(output.to<char>(), input.to_void(), input.size());
+}
+
 var::Data Base64::decode(const var::String & input){
 	var::Data result;
 	if( result.set_size( calc_decoded_size( input.length() ) ) < 0 ){
 		return var::Data();
 	}
 
-	decode(result.to_void(), input.to_char(), input.length());
+	int len = decode(result.to_void(), input.to_char(), input.length());
+	if( len < 0 ){
+		return var::Data();
+	}
+
+	//drop the bytes reserved for padding characters
+	result.set_size(len);
 	return result;
 }
 
 int Base64::encode(char * dest, const void * src, int nbyte){
-	int i;
-	int j;
-	int k;
-	int len;
-	u8 six_bits[4];
-	len = nbyte;
-	const char * data;
-	data = (const char *)src;
-
-	k = 0;
-	//We need to encode three bytes at a time in to four encoded bytes
-	for(i=0; i < len; i+=3){
-		//First the thress bytes are broken down into six-bit sections
-		six_bits[0] = (data[i] >> 2) & 0x3F;
-		six_bits[1] = ((data[i] << 4) & 0x30) + ((data[i+1]>>4) & 0x0F);
-		six_bits[2] = ((data[i+1] << 2) & 0x3C) + ((data[i+2]>>6) & 0x03);
-		six_bits[3] = data[i+2] & 0x3F;
-		//now we use the helper function to convert from six-bits to base64
-		for(j=0; j < 4; j++){
-			dest[k+j] = encode_six(six_bits[j]);
+	const u8 * data = (const u8*)src;
+	char * start = dest;
+	u32 group;
+
+	//12 bytes (4 groups of 3) are encoded per step
+	while( nbyte >= 12 ){
+		for(int i=0; i < 12; i+=3){
+			group = (data[i] << 16) | (data[i+1] << 8) | data[i+2];
+			dest[0] = encode_table[group >> 18];
+			dest[1] = encode_table[(group >> 12) & 0x3f];
+			dest[2] = encode_table[(group >> 6) & 0x3f];
+			dest[3] = encode_table[group & 0x3f];
+			dest += 4;
 		}
-		k+=4;
+		data += 12;
+		nbyte -= 12;
+	}
+
+	while( nbyte >= 3 ){
+		group = (data[0] << 16) | (data[1] << 8) | data[2];
+		dest[0] = encode_table[group >> 18];
+		dest[1] = encode_table[(group >> 12) & 0x3f];
+		dest[2] = encode_table[(group >> 6) & 0x3f];
+		dest[3] = encode_table[group & 0x3f];
+		dest += 4;
+		data += 3;
+		nbyte -= 3;
 	}
 
 	//at the end, we add = if the input is not divisible by 3
-	if( (len % 3) == 1 ){
-		//two equals at end
-		dest[k-2] = '=';
-		dest[k-1] = '=';
-	} else if ( (len % 3) == 2 ){
-		dest[k-1] = '=';
+	if( nbyte ){
+		group = data[0] << 16;
+		if( nbyte == 2 ){ group |= data[1] << 8; }
+		dest[0] = encode_table[group >> 18];
+		dest[1] = encode_table[(group >> 12) & 0x3f];
+		dest[2] = nbyte == 2 ? encode_table[(group >> 6) & 0x3f] : '=';
+		dest[3] = '=';
+		dest += 4;
 	}
 
 	//finally, zero terminate the output string
-	dest[k] = 0;
+	*dest = 0;
 
-	return strlen(dest);
-}
-
-int Base64::calc_encoded_size(int nbyte){
-	return ((((nbyte*4+2)/3) + 3)/4)*4;
+	return dest - start;
 }
 
 int Base64::decode(void * dest, const char * src, int nbyte){
-	char * data = (char *)dest;
-	int i;
-	int j;
-
-	uint8_t eight_bits[4];
-
-	for(i=0,j=0; j < nbyte; i+=3,j+=4){
-		eight_bits[0] = decode_eigth(src[j]);
-		eight_bits[1] = decode_eigth(src[j+1]);
-		eight_bits[2] = decode_eigth(src[j+2]);
-		eight_bits[3] = decode_eigth(src[j+3]);
-		data[i] = (eight_bits[0] << 2) | (eight_bits[1] >> 4);
-		data[i+1] = (eight_bits[1] << 4) | (eight_bits[2] >> 2);
-		data[i+2] = (eight_bits[2] << 6) | (eight_bits[3]);
-	}
+	const u8 * data = (const u8*)src;
+	u8 * out = (u8*)dest;
+	u8 * start = out;
+	u32 a, b, c, d;
 
-	return 0;
-}
-
-int Base64::calc_decoded_size(int nbyte){
-	return (nbyte*3+3)/4;
-}
-
-//This is a helper function to convert a six-bit value to base64
-char Base64::encode_six(uint8_t six_bit_value){
-	uint8_t x;
-	char c = -1;
-	x = six_bit_value & ~0xC0; //remove top two bits (should be zero anyway)
-	if( x < 26 ){
-		c = 'A' + x;
-	} else if ( x < 52 ){
-		c = 'a' + (x - 26);
-	} else if( x < 62 ){
-		c = '0' + (x - 52);
-	} else if( x == 62 ){
-		c = '+';
-	} else if (x == 63 ){
-		c = '/';
+	if( nbyte % 4 ){
+		return -1;
 	}
-	return c;
-}
 
-char Base64::decode_eigth(uint8_t eight_bit_value){
-	uint8_t x;
-	x = eight_bit_value;
-	if( (x >= 'A') && (x <= 'Z') ){
-		return x - 'A';
+	if( nbyte == 0 ){
+		return 0;
 	}
 
-	if( (x >= 'a') && (x <= 'z') ){
-		return x - 'a' + 26;
-	}
+	//the last group is decoded separately because it may be padded
+	nbyte -= 4;
 
-	if( (x >= '0') && (x <= '9') ){
-		return x - '0' + 52;
+	//16 characters (12 bytes) are decoded per step; invalid characters set bit 7
+	while( nbyte >= 16 ){
+		u32 invalid = 0;
+		for(int i=0; i < 16; i+=4){
+			a = decode_table[data[i]];
+			b = decode_table[data[i+1]];
+			c = decode_table[data[i+2]];
+			d = decode_table[data[i+3]];
+			invalid |= a | b | c | d;
+			u32 group = (a << 18) | (b << 12) | (c << 6) | d;
+			out[0] = group >> 16;
+			out[1] = group >> 8;
+			out[2] = group;
+			out += 3;
+		}
+		if( invalid & 0x80 ){
+			return -1;
+		}
+		data += 16;
+		nbyte -= 16;
 	}
 
-	if( x == '+' ){
-		return 62;
+	while( nbyte ){
+		a = decode_table[data[0]];
+		b = decode_table[data[1]];
+		c = decode_table[data[2]];
+		d = decode_table[data[3]];
+		if( (a | b | c | d) & 0x80 ){
+			return -1;
+		}
+		u32 group = (a << 18) | (b << 12) | (c << 6) | d;
+		out[0] = group >> 16;
+		out[1] = group >> 8;
+		out[2] = group;
+		out += 3;
+		data += 4;
+		nbyte -= 4;
 	}
 
-	if( x == '/' ){
-		return 63;
+	a = decode_table[data[0]];
+	b = decode_table[data[1]];
+	c = data[2] == '=' ? 0 : decode_table[data[2]];
+	d = data[3] == '=' ? 0 : decode_table[data[3]];
+	if( ((a | b | c | d) & 0x80) || ((data[2] == '=') && (data[3] != '=')) ){
+		return -1;
 	}
 
-	return 0;
+	u32 group = (a << 18) | (b << 12) | (c << 6) | d;
+	*out++ = group >> 16;
+	if( data[2] != '=' ){ *out++ = group >> 8; }
+	if( data[3] != '=' ){ *out++ = group; }
+
+	return out - start;
 }
 
+u32 Base64::calc_decoded_size(u32 nbyte){
+	return (nbyte*3+3)/4;
+}
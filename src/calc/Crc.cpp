@@ -0,0 +1,291 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include "calc/Crc.hpp"
+
+#if defined __link
+#if defined __x86_64__ || defined __i386__
+#define CRC_X86 1
+#include <nmmintrin.h>
+#define CRC_SSE42_FUNCTION __attribute__((target("sse4.2")))
+#elif defined __aarch64__ && (defined __linux__ || defined __APPLE__)
+#define CRC_ARMV8 1
+#include <arm_acle.h>
+#define CRC_ARMV8_FUNCTION __attribute__((target("+crc")))
+#if defined __linux__
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+#endif
+
+using namespace calc;
+
+/*
+ * Each type has 8 tables of 256 entries. Table 0 is the
+ * classic byte-at-a-time table. Table k gives the effect of a byte
+ * followed by k zero bytes so that eight bytes are folded into
+ * the state with eight independent lookups.
+ *
+ */
+enum {
+	TABLE_ENTRIES = 256,
+	TABLE_COUNT = 8
+};
+
+static u32 * crc_table[3];
+
+static u32 * build_table(enum Crc::type type){
+	u32 * table = (u32*)malloc(TABLE_COUNT * TABLE_ENTRIES * sizeof(u32));
+	if( table == 0 ){
+		return 0;
+	}
+
+	for(u32 i=0; i < TABLE_ENTRIES; i++){
+		u32 value;
+		if( type == Crc::CRC16_CCITT ){
+			value = i << 8;
+			for(u32 j=0; j < 8; j++){
+				value = (value & 0x8000) ? (value << 1) ^ 0x1021 : (value << 1);
+			}
+			value &= 0xffff;
+		} else {
+			u32 polynomial = type == Crc::CRC32 ? 0xedb88320 : 0x82f63b78;
+			value = i;
+			for(u32 j=0; j < 8; j++){
+				value = (value & 1) ? (value >> 1) ^ polynomial : (value >> 1);
+			}
+		}
+		table[i] = value;
+	}
+
+	for(u32 k=1; k < TABLE_COUNT; k++){
+		const u32 * previous = table + (k-1)*TABLE_ENTRIES;
+		u32 * current = table + k*TABLE_ENTRIES;
+		for(u32 i=0; i < TABLE_ENTRIES; i++){
+			if( type == Crc::CRC16_CCITT ){
+				current[i] = ((previous[i] << 8) ^ table[previous[i] >> 8]) & 0xffff;
+			} else {
+				current[i] = (previous[i] >> 8) ^ table[previous[i] & 0xff];
+			}
+		}
+	}
+
+	return table;
+}
+
+const u32 * Crc::tables(enum type type){
+	if( crc_table[type] == 0 ){
+		//the table is complete before it is published
+		crc_table[type] = build_table(type);
+	}
+	return crc_table[type];
+}
+
+static u32 update_reflected(const u32 * table, u32 state, const u8 * data, u32 size){
+	while( size >= TABLE_COUNT ){
+		u32 low = state ^ (data[0] | (data[1] << 8) | (data[2] << 16) | ((u32)data[3] << 24));
+		state = table[7*TABLE_ENTRIES + (low & 0xff)] ^
+				table[6*TABLE_ENTRIES + ((low >> 8) & 0xff)] ^
+				table[5*TABLE_ENTRIES + ((low >> 16) & 0xff)] ^
+				table[4*TABLE_ENTRIES + (low >> 24)] ^
+				table[3*TABLE_ENTRIES + data[4]] ^
+				table[2*TABLE_ENTRIES + data[5]] ^
+				table[1*TABLE_ENTRIES + data[6]] ^
+				table[data[7]];
+		data += TABLE_COUNT;
+		size -= TABLE_COUNT;
+	}
+
+	while( size-- ){
+		state = (state >> 8) ^ table[(state ^ *data++) & 0xff];
+	}
+	return state;
+}
+
+static u32 update_crc16(const u32 * table, u32 state, const u8 * data, u32 size){
+	while( size >= TABLE_COUNT ){
+		state = table[7*TABLE_ENTRIES + (data[0] ^ (state >> 8))] ^
+				table[6*TABLE_ENTRIES + (data[1] ^ (state & 0xff))] ^
+				table[5*TABLE_ENTRIES + data[2]] ^
+				table[4*TABLE_ENTRIES + data[3]] ^
+				table[3*TABLE_ENTRIES + data[4]] ^
+				table[2*TABLE_ENTRIES + data[5]] ^
+				table[1*TABLE_ENTRIES + data[6]] ^
+				table[data[7]];
+		data += TABLE_COUNT;
+		size -= TABLE_COUNT;
+	}
+
+	while( size-- ){
+		state = ((state << 8) ^ table[(state >> 8) ^ *data++]) & 0xffff;
+	}
+	return state;
+}
+
+//used if the tables can't be allocated
+static u32 update_bitwise(enum Crc::type type, u32 state, const u8 * data, u32 size){
+	while( size-- ){
+		if( type == Crc::CRC16_CCITT ){
+			state ^= (u32)*data++ << 8;
+			for(u32 j=0; j < 8; j++){
+				state = (state & 0x8000) ? ((state << 1) ^ 0x1021) & 0xffff : (state << 1) & 0xffff;
+			}
+		} else {
+			u32 polynomial = type == Crc::CRC32 ? 0xedb88320 : 0x82f63b78;
+			state ^= *data++;
+			for(u32 j=0; j < 8; j++){
+				state = (state & 1) ? (state >> 1) ^ polynomial : (state >> 1);
+			}
+		}
+	}
+	return state;
+}
+
+#if defined CRC_X86
+CRC_SSE42_FUNCTION static u32 update_crc32c_sse42(u32 state, const u8 * data, u32 size){
+#if defined __x86_64__
+	u64 value = state;
+	while( size >= sizeof(u64) ){
+		u64 word;
+		memcpy(&word, data, sizeof(word));
+		value = _mm_crc32_u64(value, word);
+		data += sizeof(u64);
+		size -= sizeof(u64);
+	}
+	state = (u32)value;
+#endif
+	while( size-- ){
+		state = _mm_crc32_u8(state, *data++);
+	}
+	return state;
+}
+#endif
+
+#if defined CRC_ARMV8
+CRC_ARMV8_FUNCTION static u32 update_armv8(enum Crc::type type, u32 state, const u8 * data, u32 size){
+	if( type == Crc::CRC32 ){
+		while( size >= sizeof(u64) ){
+			u64 word;
+			memcpy(&word, data, sizeof(word));
+			state = __crc32d(state, word);
+			data += sizeof(u64);
+			size -= sizeof(u64);
+		}
+		while( size-- ){ state = __crc32b(state, *data++); }
+	} else {
+		while( size >= sizeof(u64) ){
+			u64 word;
+			memcpy(&word, data, sizeof(word));
+			state = __crc32cd(state, word);
+			data += sizeof(u64);
+			size -= sizeof(u64);
+		}
+		while( size-- ){ state = __crc32cb(state, *data++); }
+	}
+	return state;
+}
+#endif
+
+bool Crc::is_accelerated(enum type type){
+#if defined CRC_X86
+	if( type == CRC32C ){
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse4.2");
+	}
+#elif defined CRC_ARMV8
+	if( type != CRC16_CCITT ){
+#if defined __linux__
+		return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+		return true;
+#endif
+	}
+#endif
+	return false;
+}
+
+u32 Crc::update_state(enum type type, u32 state, const u8 * data, u32 size){
+#if defined CRC_X86 || defined CRC_ARMV8
+	static s8 is_hardware[3] = { -1, -1, -1 };
+	if( is_hardware[type] < 0 ){
+		is_hardware[type] = is_accelerated(type);
+	}
+	if( is_hardware[type] ){
+#if defined CRC_X86
+		return update_crc32c_sse42(state, data, size);
+#else
+		return update_armv8(type, state, data, size);
+#endif
+	}
+#endif
+
+	const u32 * table = tables(type);
+	if( table == 0 ){
+		return update_bitwise(type, state, data, size);
+	}
+
+	if( type == CRC16_CCITT ){
+		return update_crc16(table, state, data, size);
+	}
+	return update_reflected(table, state, data, size);
+}
+
+Crc::Crc(enum type type){
+	m_type = type;
+	start();
+}
+
+void Crc::start(){
+	m_state = initial_state(m_type);
+}
+
+Crc & Crc::update(const void * data, u32 size){
+	m_state = update_state(m_type, m_state, (const u8*)data, size);
+	return *this;
+}
+
+int Crc::update(const sys::File & file, u32 size){
+	var::Data buffer(FILE_CHUNK_SIZE);
+	int total = 0;
+	int result;
+
+	if( buffer.size() != FILE_CHUNK_SIZE ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	while( size ){
+		u32 page = size < FILE_CHUNK_SIZE ? size : FILE_CHUNK_SIZE;
+		result = file.read(buffer.to_void(), page);
+		if( result < 0 ){
+			set_error_number(file.error_number());
+			return -1;
+		}
+		if( result == 0 ){
+			break;
+		}
+		update(buffer.to_void(), result);
+		total += result;
+		size -= result;
+	}
+
+	return total;
+}
+
+u32 Crc::value() const {
+	if( m_type == CRC16_CCITT ){
+		return m_state;
+	}
+	return m_state ^ 0xffffffff;
+}
+
+u32 Crc::calculate(enum type type, const void * data, u32 size){
+	u32 state = update_state(type, initial_state(type), (const u8*)data, size);
+	if( type == CRC16_CCITT ){
+		return state;
+	}
+	return state ^ 0xffffffff;
+}
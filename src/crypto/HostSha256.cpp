@@ -0,0 +1,280 @@
+//Copyright 2011-2019 Tyler Gilbert; All Rights Reserved
+
+#include <cstring>
+#include "crypto/HostSha256.hpp"
+
+#if defined __x86_64__ || defined __i386__
+#define HOST_SHA256_X86 1
+#include <immintrin.h>
+#define HOST_SHA256_SHA_NI_FUNCTION __attribute__((target("sha,sse4.1,ssse3")))
+#elif defined __aarch64__ && (defined __linux__ || defined __APPLE__)
+#define HOST_SHA256_ARMV8 1
+#include <arm_neon.h>
+#if defined __clang__
+#define HOST_SHA256_ARMV8_FUNCTION __attribute__((target("crypto")))
+#else
+#define HOST_SHA256_ARMV8_FUNCTION __attribute__((target("+crypto")))
+#endif
+#if defined __linux__
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+using namespace crypto;
+
+static const u32 sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline u32 rotate_right(u32 value, int bits){
+	return (value >> bits) | (value << (32 - bits));
+}
+
+static void compress_scalar(u32 * state, const u8 * blocks, u32 count){
+	u32 w[64];
+
+	while( count-- ){
+		for(u32 t=0; t < 16; t++){
+			w[t] = ((u32)blocks[t*4] << 24) | (blocks[t*4+1] << 16) | (blocks[t*4+2] << 8) | blocks[t*4+3];
+		}
+		for(u32 t=16; t < 64; t++){
+			u32 s0 = rotate_right(w[t-15], 7) ^ rotate_right(w[t-15], 18) ^ (w[t-15] >> 3);
+			u32 s1 = rotate_right(w[t-2], 17) ^ rotate_right(w[t-2], 19) ^ (w[t-2] >> 10);
+			w[t] = w[t-16] + s0 + w[t-7] + s1;
+		}
+
+		u32 a = state[0], b = state[1], c = state[2], d = state[3];
+		u32 e = state[4], f = state[5], g = state[6], h = state[7];
+		for(u32 t=0; t < 64; t++){
+			u32 t1 = h + (rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25)) +
+					((e & f) ^ (~e & g)) + sha256_k[t] + w[t];
+			u32 t2 = (rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22)) +
+					((a & b) ^ (a & c) ^ (b & c));
+			h = g; g = f; f = e; e = d + t1;
+			d = c; c = b; b = a; a = t1 + t2;
+		}
+
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+		blocks += 64;
+	}
+}
+
+#if defined HOST_SHA256_X86
+HOST_SHA256_SHA_NI_FUNCTION static void compress_sha_ni(u32 * state, const u8 * blocks, u32 count){
+	const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i state0, state1, abef_save, cdgh_save, message, w[4];
+
+	//the instructions use the state in ABEF and CDGH order
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xb1);
+	state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1b);
+	state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+	while( count-- ){
+		abef_save = state0;
+		cdgh_save = state1;
+
+		//16 groups of 4 rounds; w[] holds the last 16 words of the message schedule
+		for(u32 i=0; i < 16; i++){
+			if( i < 4 ){
+				w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + i*16)), byte_swap);
+			} else {
+				__m128i next = _mm_sha256msg1_epu32(w[i & 3], w[(i+1) & 3]);
+				next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i+3) & 3], w[(i+2) & 3], 4));
+				w[i & 3] = _mm_sha256msg2_epu32(next, w[(i+3) & 3]);
+			}
+			message = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i*)&sha256_k[i*4]));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+			message = _mm_shuffle_epi32(message, 0x0e);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+		}
+
+		state0 = _mm_add_epi32(state0, abef_save);
+		state1 = _mm_add_epi32(state1, cdgh_save);
+		blocks += 64;
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b);
+	state1 = _mm_shuffle_epi32(state1, 0xb1);
+	state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+	state1 = _mm_alignr_epi8(state1, tmp, 8);
+	_mm_storeu_si128((__m128i*)&state[0], state0);
+	_mm_storeu_si128((__m128i*)&state[4], state1);
+}
+#endif
+
+#if defined HOST_SHA256_ARMV8
+HOST_SHA256_ARMV8_FUNCTION static void compress_armv8(u32 * state, const u8 * blocks, u32 count){
+	uint32x4_t state0 = vld1q_u32(&state[0]);
+	uint32x4_t state1 = vld1q_u32(&state[4]);
+	uint32x4_t abcd_save, efgh_save, message, previous, w[4];
+
+	while( count-- ){
+		abcd_save = state0;
+		efgh_save = state1;
+
+		//16 groups of 4 rounds; w[] holds the last 16 words of the message schedule
+		for(u32 i=0; i < 16; i++){
+			if( i < 4 ){
+				w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + i*16)));
+			} else {
+				w[i & 3] = vsha256su1q_u32(vsha256su0q_u32(w[i & 3], w[(i+1) & 3]), w[(i+2) & 3], w[(i+3) & 3]);
+			}
+			message = vaddq_u32(w[i & 3], vld1q_u32(&sha256_k[i*4]));
+			previous = state0;
+			state0 = vsha256hq_u32(state0, state1, message);
+			state1 = vsha256h2q_u32(state1, previous, message);
+		}
+
+		state0 = vaddq_u32(state0, abcd_save);
+		state1 = vaddq_u32(state1, efgh_save);
+		blocks += 64;
+	}
+
+	vst1q_u32(&state[0], state0);
+	vst1q_u32(&state[4], state1);
+}
+#endif
+
+enum HostSha256::backend HostSha256::m_backend = HostSha256::BACKEND_AUTO;
+
+enum HostSha256::backend HostSha256::backend(){
+	if( m_backend == BACKEND_AUTO ){
+		m_backend = detect_backend();
+	}
+	return m_backend;
+}
+
+const char * HostSha256::backend_name(){
+	switch(backend()){
+		case BACKEND_SHA_NI: return "sha-ni";
+		case BACKEND_ARMV8: return "armv8";
+		default: break;
+	}
+	return "scalar";
+}
+
+bool HostSha256::is_backend_supported(enum backend value){
+	switch(value){
+		case BACKEND_AUTO:
+		case BACKEND_SCALAR:
+			return true;
+#if defined HOST_SHA256_X86
+		case BACKEND_SHA_NI:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("sha");
+#endif
+#if defined HOST_SHA256_ARMV8
+		case BACKEND_ARMV8:
+#if defined __linux__
+			return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#else
+			return true;
+#endif
+#endif
+		default:
+			break;
+	}
+	return false;
+}
+
+int HostSha256::set_backend(enum backend value){
+	if( is_backend_supported(value) == false ){
+		return -1;
+	}
+	if( value == BACKEND_AUTO ){
+		value = detect_backend();
+	}
+	m_backend = value;
+	return 0;
+}
+
+enum HostSha256::backend HostSha256::detect_backend(){
+	if( is_backend_supported(BACKEND_SHA_NI) ){ return BACKEND_SHA_NI; }
+	if( is_backend_supported(BACKEND_ARMV8) ){ return BACKEND_ARMV8; }
+	return BACKEND_SCALAR;
+}
+
+void HostSha256::compress(u32 * state, const u8 * blocks, u32 count){
+	switch(backend()){
+#if defined HOST_SHA256_X86
+		case BACKEND_SHA_NI: compress_sha_ni(state, blocks, count); return;
+#endif
+#if defined HOST_SHA256_ARMV8
+		case BACKEND_ARMV8: compress_armv8(state, blocks, count); return;
+#endif
+		default: break;
+	}
+	compress_scalar(state, blocks, count);
+}
+
+void HostSha256::start(host_sha256_context_t * context){
+	static const u32 initial_state[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+	memcpy(context->state, initial_state, sizeof(initial_state));
+	context->length = 0;
+	context->buffer_size = 0;
+}
+
+void HostSha256::update(host_sha256_context_t * context, const u8 * input, u32 size){
+	context->length += size;
+
+	if( context->buffer_size ){
+		u32 page = 64 - context->buffer_size;
+		if( page > size ){ page = size; }
+		memcpy(context->buffer + context->buffer_size, input, page);
+		context->buffer_size += page;
+		input += page;
+		size -= page;
+		if( context->buffer_size < 64 ){
+			return;
+		}
+		compress(context->state, context->buffer, 1);
+		context->buffer_size = 0;
+	}
+
+	//whole blocks are compressed directly from the input
+	if( size >= 64 ){
+		compress(context->state, input, size / 64);
+		input += size & ~63;
+		size &= 63;
+	}
+
+	memcpy(context->buffer, input, size);
+	context->buffer_size = size;
+}
+
+void HostSha256::finish(host_sha256_context_t * context, u8 * output){
+	u64 bits = context->length * 8;
+	u8 * buffer = context->buffer;
+	u32 size = context->buffer_size;
+
+	buffer[size++] = 0x80;
+	if( size > 56 ){
+		memset(buffer + size, 0, 64 - size);
+		compress(context->state, buffer, 1);
+		size = 0;
+	}
+	memset(buffer + size, 0, 56 - size);
+	for(u32 i=0; i < 8; i++){
+		buffer[56 + i] = bits >> (56 - i*8);
+	}
+	compress(context->state, buffer, 1);
+
+	for(u32 i=0; i < 8; i++){
+		output[i*4] = context->state[i] >> 24;
+		output[i*4+1] = context->state[i] >> 16;
+		output[i*4+2] = context->state[i] >> 8;
+		output[i*4+3] = context->state[i];
+	}
+}
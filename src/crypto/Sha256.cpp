@@ -1,11 +1,19 @@
+#include <cstdlib>
+#include <errno.h>
+#if defined __link
+#include <thread>
+#endif
+#include "sys/Thread.hpp"
 #include "crypto/Sha256.hpp"
 
 using namespace crypto;
 
 Sha256::Sha256(){
+#if !defined __link
 	if( sha256_api().is_valid() == false ){
 		exit_fatal("sha256_api api missing");
 	}
+#endif
 	m_context = 0;
 	m_is_finished = true;
 }
@@ -31,7 +39,16 @@ Sha256 & Sha256::operator << ( const var::String & a){
 
 int Sha256::initialize(){
 	finalize();
+#if defined __link
+	m_context = malloc(sizeof(host_sha256_context_t));
+	if( m_context == 0 ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+	return 0;
+#else
 	return set_error_number_if_error(sha256_api()->init(&m_context));
+#endif
 }
 
 var::String Sha256::stringify(){
@@ -50,32 +67,171 @@ const var::Array<u8, 32> & Sha256::output(){
 
 int Sha256::finalize(){
 	if( m_context != 0 ){
+#if defined __link
+		free(m_context);
+		m_context = 0;
+#else
 		sha256_api()->deinit(&m_context);
+#endif
 	}
 	return 0;
 }
 
 int Sha256::start(){
 	m_is_finished = false;
+#if defined __link
+	HostSha256::start((host_sha256_context_t*)m_context);
+	return 0;
+#else
 	return set_error_number_if_error(sha256_api()->start(m_context));
+#endif
 }
 
 int Sha256::update(const char * input, u32 len){
-	if( is_initialized() == false ){
-		initialize();
+	if( (is_initialized() == false) && (initialize() < 0) ){
+		return -1;
 	}
 
 	if( m_is_finished ){
 		start();
 	}
 
+#if defined __link
+	HostSha256::update((host_sha256_context_t*)m_context, (const u8*)input, len);
+	return 0;
+#else
 	return set_error_number_if_error(sha256_api()->update(m_context, (const unsigned char*)input, len));
+#endif
 }
 
 int Sha256::finish(){
 	if( m_is_finished == false){
 		m_is_finished = true;
+#if defined __link
+		HostSha256::finish((host_sha256_context_t*)m_context, (u8*)m_output.data());
+		return 0;
+#else
 		return set_error_number_if_error(sha256_api()->finish(m_context, (unsigned char*)m_output.data(), m_output.size()));
+#endif
+	}
+	return 0;
+}
+
+int Sha256::update(const sys::File & file, u32 size){
+	var::Data buffer(FILE_CHUNK_SIZE);
+	int total = 0;
+	int result;
+
+	if( buffer.size() != FILE_CHUNK_SIZE ){
+		set_error_number(ENOMEM);
+		return -1;
 	}
+
+	while( size ){
+		u32 page = size < FILE_CHUNK_SIZE ? size : FILE_CHUNK_SIZE;
+		result = file.read(buffer.to_void(), page);
+		if( result < 0 ){
+			set_error_number(file.error_number());
+			return -1;
+		}
+		if( result == 0 ){
+			break;
+		}
+		if( update(buffer.to_char(), result) < 0 ){
+			return -1;
+		}
+		total += result;
+		size -= result;
+	}
+
+	return total;
+}
+
+void * Sha256::work(void * args){
+	job_t * job = (job_t*)args;
+	u32 i;
+
+	//each thread takes the next input until none are left
+	while( (i = __sync_fetch_and_add(&job->next, 1)) < job->count ){
+		Sha256 hash;
+		bool is_ok = true;
+
+		if( job->inputs ){
+			is_ok = hash.update(job->inputs[i].to_char(), job->inputs[i].size()) == 0;
+		} else {
+			sys::File file;
+			is_ok = (file.open(job->paths->at(i), sys::File::RDONLY) >= 0) && (hash.update(file) >= 0);
+		}
+
+		if( is_ok ){
+			job->outputs[i] = hash.output();
+		} else {
+			job->outputs[i].fill(0);
+			__sync_fetch_and_add(&job->failures, 1);
+		}
+	}
+
 	return 0;
 }
+
+int Sha256::run(job_t & job, u32 thread_count){
+	var::Vector<sys::Thread*> threads;
+
+	job.next = 0;
+	job.failures = 0;
+
+#if defined __link
+	if( thread_count == 0 ){
+		thread_count = std::thread::hardware_concurrency();
+	}
+#else
+	//the device has one core
+	thread_count = 1;
+#endif
+
+	if( thread_count > job.count ){ thread_count = job.count; }
+
+	//the calling thread is one of the workers
+	for(u32 i=1; i < thread_count; i++){
+		sys::Thread * thread = new sys::Thread(65536, false);
+		if( thread->create(work, &job) < 0 ){
+			delete thread;
+			break;
+		}
+		threads.push_back(thread);
+	}
+
+	work(&job);
+
+	//join() rather than wait(): the job is on this stack so every worker must have exited
+	for(u32 i=0; i < threads.count(); i++){
+		threads.at(i)->join();
+		delete threads.at(i);
+	}
+
+	return job.failures ? -1 : 0;
+}
+
+int Sha256::calculate(const var::Data * inputs, var::Array<u8, 32> * outputs, u32 count, u32 thread_count){
+	job_t job;
+	job.inputs = inputs;
+	job.paths = 0;
+	job.outputs = outputs;
+	job.count = count;
+	return run(job, thread_count);
+}
+
+int Sha256::calculate_files(const var::Vector<var::String> & paths, var::Vector< var::Array<u8, 32> > & outputs, u32 thread_count){
+	job_t job;
+
+	outputs.resize(paths.count());
+	if( outputs.count() != paths.count() ){
+		return -1;
+	}
+
+	job.inputs = 0;
+	job.paths = &paths;
+	job.outputs = outputs.vector_data();
+	job.count = paths.count();
+	return run(job, thread_count);
+}
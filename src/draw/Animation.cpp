@@ -130,6 +130,9 @@ int Animation::animate_frame(void (*draw)(void*,int,int), void * obj){
 									data());
 
 	m_drawing_attr->bitmap() << m_drawing_attr->bitmap().pen().set_flags(o_flags);
+
+	//the frame is written to the bitmap memory directly
+	m_drawing_attr->bitmap().add_damage(sgfx::Region(data()->region));
 	m_drawing_attr->bitmap().refresh();
 	Timer::wait_milliseconds(frame_delay());
 
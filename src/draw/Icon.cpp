@@ -8,11 +8,126 @@
 
 using namespace draw;
 
+var::Vector<Icon::CachedIcon> Icon::m_cache;
+u32 Icon::m_cache_used = 0;
+u32 Icon::m_cache_size = Icon::CACHE_SIZE_DEFAULT;
+u32 Icon::m_cache_age = 0;
+
 Icon::Icon(){
 	m_rotation = RIGHT;
 }
 
+void Icon::set_cache_size(u32 value){
+	m_cache_size = value;
+	while( m_cache_used > m_cache_size ){
+		evict_cached();
+	}
+	if( m_cache_size == 0 ){
+		clear_cache();
+	}
+}
+
+void Icon::clear_cache(){
+	m_cache.free();
+	m_cache_used = 0;
+}
+
+void Icon::render(Bitmap & bitmap, VectorPath & vector_path, s16 rotation, const Pen & pen){
+	bitmap.clear();
+	bitmap.set_pen(pen);
+	VectorMap map(bitmap, rotation);
+	sgfx::Vector::draw(bitmap, vector_path, map);
+}
+
+const Bitmap * Icon::find_cached(const DrawingScaledAttr & attr) const {
+	u32 hash = sys::Assets::calculate_hash(name());
+	Area area = attr.area();
+	u8 bits_per_pixel = attr.bitmap().bits_per_pixel();
+	sg_pen_t pen = attr.bitmap().pen();
+
+	for(u32 i=0; i < m_cache.count(); i++){
+		CachedIcon & cached = m_cache.at(i);
+		if( cached.m_is_valid &&
+			 (cached.m_hash == hash) &&
+			 (cached.m_rotation == rotation()) &&
+			 (cached.m_bitmap.width() == area.width()) &&
+			 (cached.m_bitmap.height() == area.height()) &&
+			 (cached.m_bitmap.bits_per_pixel() == bits_per_pixel) &&
+			 (memcmp(&cached.m_pen, &pen, sizeof(pen)) == 0) &&
+			 (cached.m_name == name()) ){
+			cached.m_age = ++m_cache_age;
+			return &cached.m_bitmap;
+		}
+	}
+	return 0;
+}
+
+const Bitmap * Icon::add_cached(const DrawingScaledAttr & attr, VectorPath & vector_path) const {
+	u32 i;
+	Bitmap bitmap;
+	u32 need;
+
+	bitmap.set_bits_per_pixel(attr.bitmap().bits_per_pixel());
+	need = bitmap.calculate_size(attr.area());
+	if( (need == 0) || (need > m_cache_size) ){
+		return 0;
+	}
+
+	while( m_cache_used && (m_cache_used + need > m_cache_size) ){
+		evict_cached();
+	}
+
+	//reuse an evicted entry if there is one
+	for(i=0; i < m_cache.count(); i++){
+		if( m_cache.at(i).m_is_valid == false ){
+			break;
+		}
+	}
+
+	if( i == m_cache.count() ){
+		if( m_cache.push_back(CachedIcon()) < 0 ){
+			return 0;
+		}
+	}
+
+	CachedIcon & cached = m_cache.at(i);
+	cached.m_bitmap.set_bits_per_pixel(attr.bitmap().bits_per_pixel());
+	if( cached.m_bitmap.allocate(attr.area()) < 0 ){
+		return 0;
+	}
+	render(cached.m_bitmap, vector_path, rotation(), attr.bitmap().pen());
+	cached.m_hash = sys::Assets::calculate_hash(name());
+	cached.m_name = name();
+	cached.m_rotation = rotation();
+	cached.m_pen = attr.bitmap().pen();
+	cached.m_age = ++m_cache_age;
+	cached.m_is_valid = true;
+	//charged the same size that was checked against the limit
+	m_cache_used += cached.m_bitmap.calculate_size();
+
+	return &cached.m_bitmap;
+}
+
+void Icon::evict_cached(){
+	u32 i;
+	u32 oldest = m_cache.count();
+	for(i=0; i < m_cache.count(); i++){
+		if( m_cache.at(i).m_is_valid ){
+			if( (oldest == m_cache.count()) || (m_cache.at(i).m_age < m_cache.at(oldest).m_age) ){
+				oldest = i;
+			}
+		}
+	}
 
+	if( oldest < m_cache.count() ){
+		CachedIcon & cached = m_cache.at(oldest);
+		m_cache_used -= cached.m_bitmap.calculate_size();
+		cached.m_bitmap.free();
+		cached.m_is_valid = false;
+	} else {
+		m_cache_used = 0;
+	}
+}
 
 void Icon::draw_to_scale(const DrawingScaledAttr & attr){
 	sg_point_t p = attr.point();
@@ -23,31 +138,41 @@ void Icon::draw_to_scale(const DrawingScaledAttr & attr){
 	}
 #endif
 
+	//rasterizing is only needed on a cache miss
+	Bitmap scratch;
+	const Bitmap * bitmap = find_cached(attr);
 
-	VectorPath vector_path = sys::Assets::find_vector_path(name());
-
-	if( vector_path.is_valid() ){
-		Bitmap bitmap(attr.area(), attr.bitmap().bits_per_pixel());
-		bitmap.clear();
-		bitmap.set_pen( attr.bitmap().pen() );
-
-		VectorMap map(bitmap, rotation());
-		sgfx::Vector::draw(bitmap, vector_path, map);
-
-		//check for alignment values left/right/top/bottom
-		if( is_align_top() ){
-			p.y -= m_bounds.point.y;
-		} else if( is_align_bottom() ){
-			p.y += bitmap.height() - (m_bounds.point.y + m_bounds.area.height);
+	if( bitmap == 0 ){
+		VectorPath vector_path = sys::Assets::find_vector_path(name());
+		if( vector_path.is_valid() == false ){
+			return;
 		}
 
-		if( is_align_left() ){
-			p.x -= m_bounds.point.x;
-		} else if( is_align_right() ){
-			p.y += bitmap.width() - (m_bounds.point.x + m_bounds.area.width);
+		bitmap = add_cached(attr, vector_path);
+		if( bitmap == 0 ){
+			//too big for the cache
+			scratch.set_bits_per_pixel(attr.bitmap().bits_per_pixel());
+			if( scratch.allocate(attr.area()) < 0 ){
+				return;
+			}
+			render(scratch, vector_path, rotation(), attr.bitmap().pen());
+			bitmap = &scratch;
 		}
+	}
 
-		//now draw on the bitmap
-		attr.bitmap().draw_bitmap(p, bitmap);
+	//check for alignment values left/right/top/bottom
+	if( is_align_top() ){
+		p.y -= m_bounds.point.y;
+	} else if( is_align_bottom() ){
+		p.y += bitmap->height() - (m_bounds.point.y + m_bounds.area.height);
 	}
+
+	if( is_align_left() ){
+		p.x -= m_bounds.point.x;
+	} else if( is_align_right() ){
+		p.y += bitmap->width() - (m_bounds.point.x + m_bounds.area.width);
+	}
+
+	//now draw on the bitmap
+	attr.bitmap().draw_bitmap(p, *bitmap);
 }
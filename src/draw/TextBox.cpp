@@ -5,40 +5,82 @@
 #include "draw/TextBox.hpp"
 using namespace draw;
 
-TextBox::TextBox(){ set_font_size(16); m_scroll = 0; m_scroll_max = 0; }
+TextBox::TextBox(){
+	set_font_size(16);
+	m_scroll = 0;
+	m_scroll_max = 0;
+	m_layout_font = 0;
+	m_layout_width = 0;
+}
 
 
 int TextBox::count_lines(sg_size_t w){
 	const Font * font = resolve_font(20);
-	return count_lines(font, w, *this);
+	return update_layout(font, w);
 }
 
 int TextBox::count_lines(const Font * font, sg_size_t w, const TextAttr & text_attr){
-	Tokenizer tokens(text_attr.string(), " ");
-	u32 i;
-	String line;
-	int len;
-	int num_lines;
-	i = 0;
-	num_lines = 0;
+	Vector<word_t> words;
+	Vector<line_t> lines;
 
 	if( font == 0 ){
 		return -1;
 	}
 
-	do {
-		line.clear();
-		build_line(font, i, line, tokens, len, w);
-		num_lines++;
-	} while( i < tokens.size() );
-	return num_lines;
+	find_words(font, text_attr.string(), 0, words);
+	wrap_lines(font, w, words, 0, lines);
+	return lines.count();
 }
 
+int TextBox::update_layout(const Font * font, sg_size_t w){
+	const String & text = string();
+	u32 layout_length = m_layout_string.length();
+
+	if( font == 0 ){
+		return -1;
+	}
+
+	if( (font == m_layout_font) && (w == m_layout_width) && m_lines.count() ){
+		if( text == m_layout_string ){
+			return m_lines.count();
+		}
+
+		if( (text.length() > layout_length) &&
+			 (strncmp(text.cstring(), m_layout_string.cstring(), layout_length) == 0) ){
+			//text was appended -- the last word may have grown so it is measured again
+			u32 offset = layout_length;
+			if( m_words.count() ){
+				const word_t & last = m_words.at(m_words.count()-1);
+				if( last.offset + last.length == layout_length ){
+					offset = last.offset;
+					m_words.pop_back();
+				}
+			}
+			find_words(font, text, offset, m_words);
+
+			//only the last two lines can change: a grown last word that no longer
+			//fits at all is added to the end of the line before it
+			u32 redo = m_lines.count() > 1 ? 2 : 1;
+			u32 first_word = m_lines.at(m_lines.count()-redo).word;
+			while( redo-- ){ m_lines.pop_back(); }
+			wrap_lines(font, w, m_words, first_word, m_lines);
+			m_layout_string = text;
+			return m_lines.count();
+		}
+	}
+
+	m_words.clear();
+	m_lines.clear();
+	find_words(font, text, 0, m_words);
+	wrap_lines(font, w, m_words, 0, m_lines);
+	m_layout_string = text;
+	m_layout_font = font;
+	m_layout_width = w;
+	return m_lines.count();
+}
 
 void TextBox::draw_to_scale(const DrawingScaledAttr & attr){
-	Tokenizer tokens(string(), " ");
-	String line;
-	u32 i;
+	StringBuilder line;
 	sg_size_t w;
 	sg_point_t p = attr.point();
 	sg_area_t d = attr.area();
@@ -46,11 +88,9 @@ void TextBox::draw_to_scale(const DrawingScaledAttr & attr){
 
 	sg_int_t line_y;
 	sg_size_t font_height;
-	sg_size_t num_lines;
+	int num_lines;
 	sg_size_t visible_lines;
-	sg_size_t draw_line;
 	sg_size_t line_spacing;
-	int len;
 	const Font * font;
 
 	//draw the message and wrap the text
@@ -64,7 +104,7 @@ void TextBox::draw_to_scale(const DrawingScaledAttr & attr){
 	w = d.width;
 	line_y = 0;
 
-	num_lines = count_lines(w);
+	num_lines = update_layout(font, w);
 	if( num_lines < 0 ){
 		return;
 	}
@@ -83,61 +123,96 @@ void TextBox::draw_to_scale(const DrawingScaledAttr & attr){
 		}
 	}
 
+	//only the visible lines are built and drawn
+	const char * text = m_layout_string.cstring();
+	for(u32 i = m_scroll; (i < m_lines.count()) && (i - m_scroll < visible_lines); i++){
+		const line_t & layout = m_lines.at(i);
 
-	draw_line = 0;
-	i = 0;
-	do {
 		line.clear();
-		build_line(font, i, line, tokens, len, w);
-		if( (draw_line >= m_scroll) && (draw_line - m_scroll < visible_lines) ){
-
-			start.y = p.y + line_y;
-			if( is_align_left() ){
-				start.x  = p.x;
-			} else if( is_align_right() ){
-				start.x  = p.x + w - len;
-			} else {
-				start.x = p.x + (w - len)/2;
-			}
-			font->draw(line.c_str(), attr.bitmap(), start);
-			line_y += (font_height + line_spacing);
+		for(u32 j=0; j < layout.count; j++){
+			const word_t & word = m_words.at(layout.word + j);
+			if( j ){ line << ' '; }
+			line.append(text + word.offset, word.length);
 		}
-		draw_line++;
-	} while( i < tokens.size() );
-}
+		if( layout.is_trailing_space ){ line << ' '; }
 
-void TextBox::build_line(const Font * font, u32 & i, String & line, Tokenizer & tokens, int & build_len, sg_size_t w){
-	int len;
-	int line_len;
-	u32 j;
-	u32 count = tokens.size();
-	build_len = 0;
-
-	for(j=i; j < count; j++){
-		line_len = font->calc_len(line.c_str());
-		len = font->calc_len(tokens.at(i));
-		if( line_len + len <= w ){
-			line << tokens.at(j);
-			i++;
-		}
-
-		if( len > w ){
-			//single word is too large to fit on one line
-			line << tokens.at(j);
-			i++;
-			break;
+		start.y = p.y + line_y;
+		if( is_align_left() ){
+			start.x  = p.x;
+		} else if( is_align_right() ){
+			start.x  = p.x + w - layout.width;
+		} else {
+			start.x = p.x + (w - layout.width)/2;
 		}
+		font->draw(line.cstring(), attr.bitmap(), start);
+		line_y += (font_height + line_spacing);
+	}
+}
 
-		if( (line_len + len + font->space_size() <= w) && (j < (count-1)) ){
-			line.append(" ");
-		} else {
-			break;
+void TextBox::find_words(const Font * font, const ConstString & text, u32 offset, Vector<word_t> & words){
+	const char * str = text.cstring();
+	u32 length = text.length();
+	u32 i = offset;
+
+	//words are separated by one or more spaces
+	while( i < length ){
+		while( (i < length) && (str[i] == ' ') ){ i++; }
+		if( i == length ){ break; }
+
+		word_t word;
+		word.offset = i;
+		while( (i < length) && (str[i] != ' ') ){ i++; }
+		word.length = i - word.offset;
+		word.width = font->calculate_length(str + word.offset, word.length);
+		if( words.push_back(word) < 0 ){
+			return;
 		}
 	}
+}
 
-	build_len = font->calc_len(line.c_str());
+void TextBox::wrap_lines(const Font * font, sg_size_t w, const Vector<word_t> & words, u32 first_word, Vector<line_t> & lines){
+	u32 count = words.count();
+	u32 i = first_word;
+	int space = font->space_size();
 
-}
+	//greedy wrap: words are separated by one space; a word wider than w ends the line it is added to
+	do {
+		line_t line;
+		line.word = i;
+		line.count = 0;
+		line.width = 0;
+		line.is_trailing_space = false;
+
+		for(u32 j=i; j < count; j++){
+			int len = words.at(j).width;
+			int line_len = line.width;
+
+			if( line_len + len <= w ){
+				line.count++;
+				line.width += len;
+				line.is_trailing_space = false;
+				i++;
+			}
 
+			if( len > w ){
+				//single word is too large to fit on one line
+				line.count++;
+				line.width += len;
+				line.is_trailing_space = false;
+				i++;
+				break;
+			}
 
+			if( (line_len + len + space <= w) && (j < (count-1)) ){
+				line.width += space;
+				line.is_trailing_space = true;
+			} else {
+				break;
+			}
+		}
 
+		if( lines.push_back(line) < 0 ){
+			return;
+		}
+	} while( i < count );
+}
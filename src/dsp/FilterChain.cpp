@@ -0,0 +1,57 @@
+#include "dsp/FilterChain.hpp"
+
+using namespace dsp;
+
+void FilterChainQ15::execute(const stage_t & stage, const q15_t * input, q15_t * output, u32 count){
+	if( stage.type == FIR ){
+		api_q15()->fir_fast(((FirFilterQ15*)stage.filter)->instance(), (q15_t*)input, output, count);
+	} else {
+		api_q15()->biquad_cascade_df1_fast(((BiquadFilterQ15*)stage.filter)->instance(), (q15_t*)input, output, count);
+	}
+}
+
+void FilterChainQ15::reset_filter(const stage_t & stage){
+	if( stage.type == FIR ){
+		((FirFilterQ15*)stage.filter)->reset();
+	} else {
+		((BiquadFilterQ15*)stage.filter)->reset();
+	}
+}
+
+void FilterChainQ31::execute(const stage_t & stage, const q31_t * input, q31_t * output, u32 count){
+	switch(stage.type){
+		case FIR:
+			api_q31()->fir_fast(((FirFilterQ31*)stage.filter)->instance(), (q31_t*)input, output, count);
+			break;
+		case BIQUAD:
+			api_q31()->biquad_cascade_df1_fast(((BiquadFilterQ31*)stage.filter)->instance(), (q31_t*)input, output, count);
+			break;
+		case DECIMATE:
+			api_q31()->fir_decimate_fast((arm_fir_decimate_instance_q31*)((FirDecimateFilterQ31*)stage.filter)->instance(), (q31_t*)input, output, count);
+			break;
+	}
+}
+
+void FilterChainQ31::reset_filter(const stage_t & stage){
+	switch(stage.type){
+		case FIR: ((FirFilterQ31*)stage.filter)->reset(); break;
+		case BIQUAD: ((BiquadFilterQ31*)stage.filter)->reset(); break;
+		case DECIMATE: ((FirDecimateFilterQ31*)stage.filter)->reset(); break;
+	}
+}
+
+void FilterChainF32::execute(const stage_t & stage, const float32_t * input, float32_t * output, u32 count){
+	if( stage.type == FIR ){
+		api_f32()->fir(((FirFilterF32*)stage.filter)->instance(), (float32_t*)input, output, count);
+	} else {
+		api_f32()->biquad_cascade_df1(((BiquadFilterF32*)stage.filter)->instance(), (float32_t*)input, output, count);
+	}
+}
+
+void FilterChainF32::reset_filter(const stage_t & stage){
+	if( stage.type == FIR ){
+		((FirFilterF32*)stage.filter)->reset();
+	} else {
+		((BiquadFilterF32*)stage.filter)->reset();
+	}
+}
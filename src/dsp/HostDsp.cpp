@@ -0,0 +1,65 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#include "HostDspLocal.h"
+
+using namespace dsp;
+
+enum HostDsp::backend HostDsp::m_backend = HostDsp::BACKEND_AUTO;
+
+enum HostDsp::backend HostDsp::backend(){
+	if( m_backend == BACKEND_AUTO ){
+		m_backend = detect_backend();
+	}
+	return m_backend;
+}
+
+const char * HostDsp::backend_name(){
+	switch(backend()){
+		case BACKEND_SSE2: return "sse2";
+		case BACKEND_AVX2: return "avx2";
+		case BACKEND_NEON: return "neon";
+		default: break;
+	}
+	return "scalar";
+}
+
+bool HostDsp::is_backend_supported(enum backend value){
+	switch(value){
+		case BACKEND_AUTO:
+		case BACKEND_SCALAR:
+			return true;
+#if defined HOST_DSP_X86
+		case BACKEND_SSE2:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse2");
+		case BACKEND_AVX2:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+#endif
+#if defined HOST_DSP_NEON
+		case BACKEND_NEON:
+			return true;
+#endif
+		default:
+			break;
+	}
+	return false;
+}
+
+int HostDsp::set_backend(enum backend value){
+	if( is_backend_supported(value) == false ){
+		return -1;
+	}
+	if( value == BACKEND_AUTO ){
+		value = detect_backend();
+	}
+	m_backend = value;
+	return 0;
+}
+
+enum HostDsp::backend HostDsp::detect_backend(){
+	if( is_backend_supported(BACKEND_AVX2) ){ return BACKEND_AVX2; }
+	if( is_backend_supported(BACKEND_SSE2) ){ return BACKEND_SSE2; }
+	if( is_backend_supported(BACKEND_NEON) ){ return BACKEND_NEON; }
+	return BACKEND_SCALAR;
+}
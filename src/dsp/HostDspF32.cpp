@@ -0,0 +1,322 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#include <math.h>
+#include "HostDspLocal.h"
+
+/*
+ * 32-bit floating point kernels -- element-wise results are exact.
+ * The sums use one accumulator per lane so the rounding can differ
+ * from a sequential sum in the last bits.
+ *
+ */
+
+#if defined HOST_DSP_X86
+
+#define F32_ELEMENTWISE_SSE2(name, expression) \
+	HOST_DSP_SSE2_FUNCTION static u32 name##_sse2(const float32_t * a, const float32_t * b, float32_t * dst, u32 n){ \
+		u32 i; \
+		for(i=0; i+4 <= n; i+=4){ \
+			__m128 x = _mm_loadu_ps(a+i); \
+			_mm_storeu_ps(dst+i, expression); \
+		} \
+		return i; \
+	}
+
+#define F32_ELEMENTWISE_AVX2(name, expression) \
+	HOST_DSP_AVX2_FUNCTION static u32 name##_avx2(const float32_t * a, const float32_t * b, float32_t * dst, u32 n){ \
+		u32 i; \
+		for(i=0; i+8 <= n; i+=8){ \
+			__m256 x = _mm256_loadu_ps(a+i); \
+			_mm256_storeu_ps(dst+i, expression); \
+		} \
+		return i; \
+	}
+
+F32_ELEMENTWISE_SSE2(add, _mm_add_ps(x, _mm_loadu_ps(b+i)))
+F32_ELEMENTWISE_AVX2(add, _mm256_add_ps(x, _mm256_loadu_ps(b+i)))
+F32_ELEMENTWISE_SSE2(sub, _mm_sub_ps(x, _mm_loadu_ps(b+i)))
+F32_ELEMENTWISE_AVX2(sub, _mm256_sub_ps(x, _mm256_loadu_ps(b+i)))
+F32_ELEMENTWISE_SSE2(mult, _mm_mul_ps(x, _mm_loadu_ps(b+i)))
+F32_ELEMENTWISE_AVX2(mult, _mm256_mul_ps(x, _mm256_loadu_ps(b+i)))
+
+//scale and offset pass the scalar as a one-element b
+F32_ELEMENTWISE_SSE2(scale, _mm_mul_ps(x, _mm_set1_ps(b[0])))
+F32_ELEMENTWISE_AVX2(scale, _mm256_mul_ps(x, _mm256_set1_ps(b[0])))
+F32_ELEMENTWISE_SSE2(offset, _mm_add_ps(x, _mm_set1_ps(b[0])))
+F32_ELEMENTWISE_AVX2(offset, _mm256_add_ps(x, _mm256_set1_ps(b[0])))
+
+//negate and abs only change the sign bit (b isn't used)
+F32_ELEMENTWISE_SSE2(negate, _mm_xor_ps(x, _mm_set1_ps(-0.0f)))
+F32_ELEMENTWISE_AVX2(negate, _mm256_xor_ps(x, _mm256_set1_ps(-0.0f)))
+F32_ELEMENTWISE_SSE2(abs, _mm_andnot_ps(_mm_set1_ps(-0.0f), x))
+F32_ELEMENTWISE_AVX2(abs, _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x))
+
+HOST_DSP_SSE2_FUNCTION static u32 min_sse2(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	float32_t lanes[4];
+	__m128 value = _mm_set1_ps(INFINITY);
+	for(i=0; i+4 <= n; i+=4){ value = _mm_min_ps(value, _mm_loadu_ps(src+i)); }
+	_mm_storeu_ps(lanes, value);
+	*result = lanes[0];
+	for(u32 j=1; j < 4; j++){ if( lanes[j] < *result ){ *result = lanes[j]; } }
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 min_avx2(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	float32_t lanes[8];
+	__m256 value = _mm256_set1_ps(INFINITY);
+	for(i=0; i+8 <= n; i+=8){ value = _mm256_min_ps(value, _mm256_loadu_ps(src+i)); }
+	_mm256_storeu_ps(lanes, value);
+	*result = lanes[0];
+	for(u32 j=1; j < 8; j++){ if( lanes[j] < *result ){ *result = lanes[j]; } }
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 max_sse2(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	float32_t lanes[4];
+	__m128 value = _mm_set1_ps(-INFINITY);
+	for(i=0; i+4 <= n; i+=4){ value = _mm_max_ps(value, _mm_loadu_ps(src+i)); }
+	_mm_storeu_ps(lanes, value);
+	*result = lanes[0];
+	for(u32 j=1; j < 4; j++){ if( lanes[j] > *result ){ *result = lanes[j]; } }
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 max_avx2(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	float32_t lanes[8];
+	__m256 value = _mm256_set1_ps(-INFINITY);
+	for(i=0; i+8 <= n; i+=8){ value = _mm256_max_ps(value, _mm256_loadu_ps(src+i)); }
+	_mm256_storeu_ps(lanes, value);
+	*result = lanes[0];
+	for(u32 j=1; j < 8; j++){ if( lanes[j] > *result ){ *result = lanes[j]; } }
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 sum_sse2(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	__m128 acc = _mm_setzero_ps();
+	for(i=0; i+4 <= n; i+=4){ acc = _mm_add_ps(acc, _mm_loadu_ps(src+i)); }
+	*result = host_dsp_hsum_ps(acc);
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 sum_avx2(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	__m256 acc = _mm256_setzero_ps();
+	for(i=0; i+8 <= n; i+=8){ acc = _mm256_add_ps(acc, _mm256_loadu_ps(src+i)); }
+	*result = host_dsp_hsum_ps(_mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 dot_sse2(const float32_t * a, const float32_t * b, u32 n, float32_t * result){
+	u32 i;
+	__m128 acc = _mm_setzero_ps();
+	for(i=0; i+4 <= n; i+=4){ acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i))); }
+	*result = host_dsp_hsum_ps(acc);
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 dot_avx2(const float32_t * a, const float32_t * b, u32 n, float32_t * result){
+	u32 i;
+	__m256 acc = _mm256_setzero_ps();
+	for(i=0; i+8 <= n; i+=8){ acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i))); }
+	*result = host_dsp_hsum_ps(_mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+	return i;
+}
+
+#endif
+
+#if defined HOST_DSP_NEON
+
+#define F32_ELEMENTWISE_NEON(name, expression) \
+	static u32 name##_neon(const float32_t * a, const float32_t * b, float32_t * dst, u32 n){ \
+		u32 i; \
+		for(i=0; i+4 <= n; i+=4){ \
+			float32x4_t x = vld1q_f32(a+i); \
+			vst1q_f32(dst+i, expression); \
+		} \
+		return i; \
+	}
+
+F32_ELEMENTWISE_NEON(add, vaddq_f32(x, vld1q_f32(b+i)))
+F32_ELEMENTWISE_NEON(sub, vsubq_f32(x, vld1q_f32(b+i)))
+F32_ELEMENTWISE_NEON(mult, vmulq_f32(x, vld1q_f32(b+i)))
+F32_ELEMENTWISE_NEON(scale, vmulq_n_f32(x, b[0]))
+F32_ELEMENTWISE_NEON(offset, vaddq_f32(x, vdupq_n_f32(b[0])))
+F32_ELEMENTWISE_NEON(negate, vnegq_f32(x))
+F32_ELEMENTWISE_NEON(abs, vabsq_f32(x))
+
+static u32 min_neon(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	float32x4_t value = vdupq_n_f32(INFINITY);
+	for(i=0; i+4 <= n; i+=4){ value = vminq_f32(value, vld1q_f32(src+i)); }
+	*result = vminvq_f32(value);
+	return i;
+}
+
+static u32 max_neon(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	float32x4_t value = vdupq_n_f32(-INFINITY);
+	for(i=0; i+4 <= n; i+=4){ value = vmaxq_f32(value, vld1q_f32(src+i)); }
+	*result = vmaxvq_f32(value);
+	return i;
+}
+
+static u32 sum_neon(const float32_t * src, u32 n, float32_t * result){
+	u32 i;
+	float32x4_t acc = vdupq_n_f32(0);
+	for(i=0; i+4 <= n; i+=4){ acc = vaddq_f32(acc, vld1q_f32(src+i)); }
+	*result = vaddvq_f32(acc);
+	return i;
+}
+
+static u32 dot_neon(const float32_t * a, const float32_t * b, u32 n, float32_t * result){
+	u32 i;
+	float32x4_t acc = vdupq_n_f32(0);
+	//multiply then add (not fused) like the x86 kernels
+	for(i=0; i+4 <= n; i+=4){ acc = vaddq_f32(acc, vmulq_f32(vld1q_f32(a+i), vld1q_f32(b+i))); }
+	*result = vaddvq_f32(acc);
+	return i;
+}
+
+#endif
+
+static u32 add_simd(const float32_t * a, const float32_t * b, float32_t * dst, u32 n){ HOST_DSP_SELECT(add, a, b, dst, n) }
+static u32 sub_simd(const float32_t * a, const float32_t * b, float32_t * dst, u32 n){ HOST_DSP_SELECT(sub, a, b, dst, n) }
+static u32 mult_simd(const float32_t * a, const float32_t * b, float32_t * dst, u32 n){ HOST_DSP_SELECT(mult, a, b, dst, n) }
+static u32 scale_simd(const float32_t * src, const float32_t * scale, float32_t * dst, u32 n){ HOST_DSP_SELECT(scale, src, scale, dst, n) }
+static u32 offset_simd(const float32_t * src, const float32_t * offset, float32_t * dst, u32 n){ HOST_DSP_SELECT(offset, src, offset, dst, n) }
+static u32 negate_simd(const float32_t * src, float32_t * dst, u32 n){ HOST_DSP_SELECT(negate, src, src, dst, n) }
+static u32 abs_simd(const float32_t * src, float32_t * dst, u32 n){ HOST_DSP_SELECT(abs, src, src, dst, n) }
+static u32 min_simd(const float32_t * src, u32 n, float32_t * result){ HOST_DSP_SELECT(min, src, n, result) }
+static u32 max_simd(const float32_t * src, u32 n, float32_t * result){ HOST_DSP_SELECT(max, src, n, result) }
+static u32 sum_simd(const float32_t * src, u32 n, float32_t * result){ HOST_DSP_SELECT(sum, src, n, result) }
+static u32 dot_simd(const float32_t * a, const float32_t * b, u32 n, float32_t * result){ HOST_DSP_SELECT(dot, a, b, n, result) }
+
+static float32_t sum(const float32_t * src, u32 n){
+	float32_t result = 0.0f;
+	u32 i = sum_simd(src, n, &result);
+	for(; i < n; i++){ result += src[i]; }
+	return result;
+}
+
+static float32_t dot(const float32_t * a, const float32_t * b, u32 n){
+	float32_t result = 0.0f;
+	u32 i = dot_simd(a, b, n, &result);
+	for(; i < n; i++){ result += a[i] * b[i]; }
+	return result;
+}
+
+//two pass variance as in arm_var_f32()
+static float32_t variance_f32(const float32_t * src, u32 n){
+	float32_t mean = sum(src, n) / (float32_t)n;
+	float32_t result = 0.0f;
+	for(u32 i=0; i < n; i++){
+		float32_t difference = src[i] - mean;
+		result += difference * difference;
+	}
+	return result / ((float32_t)n - 1.0f);
+}
+
+static void host_mean_f32(float32_t * pSrc, u32 blockSize, float32_t * pResult){
+	if( blockSize == 0 ){ *pResult = 0.0f; return; }
+	*pResult = sum(pSrc, blockSize) / (float32_t)blockSize;
+}
+
+static void host_power_f32(float32_t * pSrc, u32 blockSize, float32_t * pResult){
+	*pResult = dot(pSrc, pSrc, blockSize);
+}
+
+static void host_var_f32(float32_t * pSrc, u32 blockSize, float32_t * pResult){
+	if( blockSize <= 1U ){ *pResult = 0.0f; return; }
+	*pResult = variance_f32(pSrc, blockSize);
+}
+
+static void host_rms_f32(float32_t * pSrc, u32 blockSize, float32_t * pResult){
+	if( blockSize == 0 ){ *pResult = 0.0f; return; }
+	*pResult = sqrtf(dot(pSrc, pSrc, blockSize) / (float32_t)blockSize);
+}
+
+static void host_std_f32(float32_t * pSrc, u32 blockSize, float32_t * pResult){
+	if( blockSize <= 1U ){ *pResult = 0.0f; return; }
+	*pResult = sqrtf(variance_f32(pSrc, blockSize));
+}
+
+static void host_min_f32(float32_t * pSrc, u32 blockSize, float32_t * pResult, u32 * pIndex){
+	float32_t value = INFINITY;
+	u32 i = min_simd(pSrc, blockSize, &value);
+	for(; i < blockSize; i++){ if( pSrc[i] < value ){ value = pSrc[i]; } }
+	//CMSIS reports the first occurrence
+	for(i=0; (i < blockSize) && (pSrc[i] != value); i++){}
+	*pResult = blockSize ? value : 0.0f;
+	*pIndex = (i < blockSize) ? i : 0;
+}
+
+static void host_max_f32(float32_t * pSrc, u32 blockSize, float32_t * pResult, u32 * pIndex){
+	float32_t value = -INFINITY;
+	u32 i = max_simd(pSrc, blockSize, &value);
+	for(; i < blockSize; i++){ if( pSrc[i] > value ){ value = pSrc[i]; } }
+	for(i=0; (i < blockSize) && (pSrc[i] != value); i++){}
+	*pResult = blockSize ? value : 0.0f;
+	*pIndex = (i < blockSize) ? i : 0;
+}
+
+static void host_abs_f32(float32_t * pSrc, float32_t * pDst, u32 blockSize){
+	u32 i = abs_simd(pSrc, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = fabsf(pSrc[i]); }
+}
+
+static void host_dot_prod_f32(float32_t * pSrcA, float32_t * pSrcB, u32 blockSize, float32_t * result){
+	*result = dot(pSrcA, pSrcB, blockSize);
+}
+
+static void host_negate_f32(float32_t * pSrc, float32_t * pDst, u32 blockSize){
+	u32 i = negate_simd(pSrc, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = -pSrc[i]; }
+}
+
+static void host_scale_f32(float32_t * pSrc, float32_t scale, float32_t * pDst, u32 blockSize){
+	u32 i = scale_simd(pSrc, &scale, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = pSrc[i] * scale; }
+}
+
+static void host_offset_f32(float32_t * pSrc, float32_t offset, float32_t * pDst, u32 blockSize){
+	u32 i = offset_simd(pSrc, &offset, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = pSrc[i] + offset; }
+}
+
+static void host_add_f32(float32_t * pSrcA, float32_t * pSrcB, float32_t * pDst, u32 blockSize){
+	u32 i = add_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = pSrcA[i] + pSrcB[i]; }
+}
+
+static void host_sub_f32(float32_t * pSrcA, float32_t * pSrcB, float32_t * pDst, u32 blockSize){
+	u32 i = sub_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = pSrcA[i] - pSrcB[i]; }
+}
+
+static void host_mult_f32(float32_t * pSrcA, float32_t * pSrcB, float32_t * pDst, u32 blockSize){
+	u32 i = mult_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = pSrcA[i] * pSrcB[i]; }
+}
+
+const host_dsp_api_f32_t host_dsp_api_f32 = {
+	host_mean_f32,
+	host_power_f32,
+	host_var_f32,
+	host_rms_f32,
+	host_std_f32,
+	host_min_f32,
+	host_max_f32,
+	host_abs_f32,
+	host_dot_prod_f32,
+	host_negate_f32,
+	host_scale_f32,
+	host_offset_f32,
+	host_add_f32,
+	host_sub_f32,
+	host_mult_f32
+};
@@ -0,0 +1,195 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#ifndef SAPI_DSP_HOST_DSP_LOCAL_H_
+#define SAPI_DSP_HOST_DSP_LOCAL_H_
+
+#include <string.h>
+#include "dsp/HostDsp.hpp"
+
+#if defined __x86_64__ || defined __i386__
+#define HOST_DSP_X86 1
+#include <immintrin.h>
+#define HOST_DSP_SSE2_FUNCTION __attribute__((target("sse2")))
+#define HOST_DSP_AVX2_FUNCTION __attribute__((target("avx2")))
+#elif defined __aarch64__
+#define HOST_DSP_NEON 1
+#include <arm_neon.h>
+#endif
+
+/*
+ * Every kernel has the same shape. A SIMD function processes
+ * as many whole vectors as it can and returns the number of
+ * elements it processed. The scalar code (which mirrors CMSIS DSP)
+ * finishes the tail. Reductions return partial sums that are
+ * combined with the scalar tail.
+ *
+ */
+
+/*
+ * Calls the SIMD version of a kernel for the active backend.
+ * A backend that doesn't implement a kernel returns 0 (nothing processed).
+ *
+ */
+#if defined HOST_DSP_X86
+#define HOST_DSP_SELECT(name, ...) \
+	switch(dsp::HostDsp::backend()){ \
+		case dsp::HostDsp::BACKEND_AVX2: return name##_avx2(__VA_ARGS__); \
+		case dsp::HostDsp::BACKEND_SSE2: return name##_sse2(__VA_ARGS__); \
+		default: return 0; \
+	}
+#elif defined HOST_DSP_NEON
+#define HOST_DSP_SELECT(name, ...) \
+	switch(dsp::HostDsp::backend()){ \
+		case dsp::HostDsp::BACKEND_NEON: return name##_neon(__VA_ARGS__); \
+		default: return 0; \
+	}
+#else
+#define HOST_DSP_SELECT(name, ...) return 0;
+#endif
+
+#if defined HOST_DSP_X86
+HOST_DSP_SSE2_FUNCTION static inline s32 host_dsp_hsum_epi32(__m128i value){
+	value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1,0,3,2)));
+	value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2,3,0,1)));
+	return _mm_cvtsi128_si32(value);
+}
+
+HOST_DSP_SSE2_FUNCTION static inline s64 host_dsp_hsum_epi64(__m128i value){
+	s64 lanes[2];
+	_mm_storeu_si128((__m128i*)lanes, value);
+	return (s64)((u64)lanes[0] + (u64)lanes[1]);
+}
+
+HOST_DSP_SSE2_FUNCTION static inline float32_t host_dsp_hsum_ps(__m128 value){
+	float32_t lanes[4];
+	_mm_storeu_ps(lanes, value);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+#endif
+
+static inline q15_t host_dsp_ssat16(s32 value){
+	if( value > 32767 ){ return 32767; }
+	if( value < -32768 ){ return -32768; }
+	return (q15_t)value;
+}
+
+static inline q31_t host_dsp_ssat(s64 value, int bits){
+	s64 max = ((s64)1 << (bits-1)) - 1;
+	if( value > max ){ return (q31_t)max; }
+	if( value < -max - 1 ){ return (q31_t)(-max - 1); }
+	return (q31_t)value;
+}
+
+static inline q31_t host_dsp_clip_q63_to_q31(q63_t value){
+	return ((q31_t)(value >> 32) != ((q31_t)value >> 31)) ? ((0x7FFFFFFF ^ ((q31_t)(value >> 63)))) : (q31_t)value;
+}
+
+static inline q15_t host_dsp_qadd16(q15_t a, q15_t b){ return host_dsp_ssat16((s32)a + b); }
+static inline q15_t host_dsp_qsub16(q15_t a, q15_t b){ return host_dsp_ssat16((s32)a - b); }
+static inline q31_t host_dsp_qadd(q31_t a, q31_t b){ return host_dsp_clip_q63_to_q31((q63_t)a + b); }
+static inline q31_t host_dsp_qsub(q31_t a, q31_t b){ return host_dsp_clip_q63_to_q31((q63_t)a - b); }
+
+//shifts that wrap like the ARM LSL instruction instead of being undefined
+static inline s32 host_dsp_lsl32(s32 value, int shift){ return (s32)((u32)value << shift); }
+
+static inline float32_t host_dsp_bits_to_float(s32 value){
+	float32_t result;
+	memcpy(&result, &value, sizeof(result));
+	return result;
+}
+
+static inline s32 host_dsp_float_to_bits(float32_t value){
+	s32 result;
+	memcpy(&result, &value, sizeof(result));
+	return result;
+}
+
+//same algorithm as arm_sqrt_q15() so results match the device
+static inline q15_t host_dsp_sqrt_q15(q15_t in){
+	q31_t bits_val1;
+	q15_t number, temp1, var1, signBits1, half;
+	float32_t temp_float1;
+	int i;
+
+	number = in;
+	if( number <= 0 ){ return 0; }
+
+	signBits1 = __builtin_clz((u32)number) - 17;
+	if( (signBits1 % 2) == 0 ){
+		number = number << signBits1;
+	} else {
+		number = number << (signBits1 - 1);
+	}
+
+	half = number >> 1;
+	temp1 = number;
+
+	temp_float1 = number * 3.051757812500000e-005f;
+	bits_val1 = host_dsp_float_to_bits(temp_float1);
+	bits_val1 = 0x5f3759df - (bits_val1 >> 1);
+	temp_float1 = host_dsp_bits_to_float(bits_val1);
+	var1 = (q31_t)(temp_float1 * 16384);
+
+	for(i=0; i < 3; i++){
+		var1 = ((q15_t)((q31_t)var1 * (0x3000 -
+													  ((q15_t)
+														((((q15_t)
+															(((q31_t)var1 * var1) >> 15)) *
+														  (q31_t)half) >> 15))) >> 15)) << 2;
+	}
+
+	var1 = ((q15_t)(((q31_t)temp1 * var1) >> 15)) << 1;
+
+	if( (signBits1 % 2) == 0 ){
+		var1 = var1 >> (signBits1 / 2);
+	} else {
+		var1 = var1 >> ((signBits1 - 1) / 2);
+	}
+	return var1;
+}
+
+//same algorithm as arm_sqrt_q31() so results match the device
+static inline q31_t host_dsp_sqrt_q31(q31_t in){
+	q31_t bits_val1;
+	q31_t number, temp1, var1, signBits1, half;
+	float32_t temp_float1;
+	int i;
+
+	number = in;
+	if( number <= 0 ){ return 0; }
+
+	signBits1 = __builtin_clz((u32)number) - 1;
+	if( (signBits1 % 2) == 0 ){
+		number = number << signBits1;
+	} else {
+		number = number << (signBits1 - 1);
+	}
+
+	half = number >> 1;
+	temp1 = number;
+
+	temp_float1 = number * 4.6566128731e-010f;
+	bits_val1 = host_dsp_float_to_bits(temp_float1);
+	bits_val1 = 0x5f3759df - (bits_val1 >> 1);
+	temp_float1 = host_dsp_bits_to_float(bits_val1);
+	var1 = (q31_t)(temp_float1 * 1073741824);
+
+	for(i=0; i < 3; i++){
+		var1 = ((q31_t)((q63_t)var1 * (0x30000000 -
+												 ((q31_t)
+												  ((((q31_t)
+													  (((q63_t)var1 * var1) >> 31)) *
+													 (q63_t)half) >> 31))) >> 31)) << 2;
+	}
+
+	var1 = ((q31_t)(((q63_t)temp1 * var1) >> 31)) << 1;
+
+	if( (signBits1 % 2) == 0 ){
+		var1 = var1 >> (signBits1 / 2);
+	} else {
+		var1 = var1 >> ((signBits1 - 1) / 2);
+	}
+	return var1;
+}
+
+#endif // SAPI_DSP_HOST_DSP_LOCAL_H_
@@ -0,0 +1,602 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#include "HostDspLocal.h"
+
+/*
+ * q1.15 kernels -- the scalar code follows CMSIS DSP exactly
+ * and the SIMD code produces the same bits.
+ *
+ */
+
+#if defined HOST_DSP_X86
+
+//convert _mm_madd_epi16() results to 64-bit -- 0x80000000 can only be (-32768*-32768)*2
+HOST_DSP_SSE2_FUNCTION static inline __m128i madd_to_epi64_sse2(__m128i acc, __m128i value){
+	__m128i sign = _mm_andnot_si128(
+				_mm_cmpeq_epi32(value, _mm_set1_epi32((s32)0x80000000)),
+				_mm_srai_epi32(value, 31));
+	acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(value, sign));
+	return _mm_add_epi64(acc, _mm_unpackhi_epi32(value, sign));
+}
+
+HOST_DSP_AVX2_FUNCTION static inline __m256i madd_to_epi64_avx2(__m256i acc, __m256i value){
+	__m256i sign = _mm256_andnot_si256(
+				_mm256_cmpeq_epi32(value, _mm256_set1_epi32((s32)0x80000000)),
+				_mm256_srai_epi32(value, 31));
+	acc = _mm256_add_epi64(acc, _mm256_unpacklo_epi32(value, sign));
+	return _mm256_add_epi64(acc, _mm256_unpackhi_epi32(value, sign));
+}
+
+HOST_DSP_SSE2_FUNCTION static inline __m128i mult_sse2(__m128i a, __m128i b){
+	__m128i min = _mm_set1_epi16((s16)0x8000);
+	__m128i result = _mm_or_si128(
+				_mm_slli_epi16(_mm_mulhi_epi16(a, b), 1),
+				_mm_srli_epi16(_mm_mullo_epi16(a, b), 15));
+	//-1 * -1 is the only product that saturates
+	return _mm_xor_si128(result, _mm_and_si128(_mm_cmpeq_epi16(a, min), _mm_cmpeq_epi16(b, min)));
+}
+
+HOST_DSP_AVX2_FUNCTION static inline __m256i mult_avx2(__m256i a, __m256i b){
+	__m256i min = _mm256_set1_epi16((s16)0x8000);
+	__m256i result = _mm256_or_si256(
+				_mm256_slli_epi16(_mm256_mulhi_epi16(a, b), 1),
+				_mm256_srli_epi16(_mm256_mullo_epi16(a, b), 15));
+	return _mm256_xor_si256(result, _mm256_and_si256(_mm256_cmpeq_epi16(a, min), _mm256_cmpeq_epi16(b, min)));
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 add_sse2(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(a+i)), _mm_loadu_si128((const __m128i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 add_avx2(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+16 <= n; i+=16){
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_adds_epi16(_mm256_loadu_si256((const __m256i*)(a+i)), _mm256_loadu_si256((const __m256i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 sub_sse2(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_subs_epi16(_mm_loadu_si128((const __m128i*)(a+i)), _mm_loadu_si128((const __m128i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 sub_avx2(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+16 <= n; i+=16){
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_subs_epi16(_mm256_loadu_si256((const __m256i*)(a+i)), _mm256_loadu_si256((const __m256i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 mult_sse2(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){
+		_mm_storeu_si128((__m128i*)(dst+i), mult_sse2(_mm_loadu_si128((const __m128i*)(a+i)), _mm_loadu_si128((const __m128i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 mult_avx2(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+16 <= n; i+=16){
+		_mm256_storeu_si256((__m256i*)(dst+i), mult_avx2(_mm256_loadu_si256((const __m256i*)(a+i)), _mm256_loadu_si256((const __m256i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 offset_sse2(const q15_t * src, q15_t offset, q15_t * dst, u32 n){
+	u32 i;
+	__m128i value = _mm_set1_epi16(offset);
+	for(i=0; i+8 <= n; i+=8){
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(src+i)), value));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 offset_avx2(const q15_t * src, q15_t offset, q15_t * dst, u32 n){
+	u32 i;
+	__m256i value = _mm256_set1_epi16(offset);
+	for(i=0; i+16 <= n; i+=16){
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_adds_epi16(_mm256_loadu_si256((const __m256i*)(src+i)), value));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 negate_sse2(const q15_t * src, q15_t * dst, u32 n){
+	u32 i;
+	__m128i zero = _mm_setzero_si128();
+	for(i=0; i+8 <= n; i+=8){
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_subs_epi16(zero, _mm_loadu_si128((const __m128i*)(src+i))));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 negate_avx2(const q15_t * src, q15_t * dst, u32 n){
+	u32 i;
+	__m256i zero = _mm256_setzero_si256();
+	for(i=0; i+16 <= n; i+=16){
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_subs_epi16(zero, _mm256_loadu_si256((const __m256i*)(src+i))));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 abs_sse2(const q15_t * src, q15_t * dst, u32 n){
+	u32 i;
+	__m128i zero = _mm_setzero_si128();
+	for(i=0; i+8 <= n; i+=8){
+		__m128i value = _mm_loadu_si128((const __m128i*)(src+i));
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_max_epi16(value, _mm_subs_epi16(zero, value)));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 abs_avx2(const q15_t * src, q15_t * dst, u32 n){
+	u32 i;
+	__m256i zero = _mm256_setzero_si256();
+	for(i=0; i+16 <= n; i+=16){
+		__m256i value = _mm256_loadu_si256((const __m256i*)(src+i));
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_max_epi16(value, _mm256_subs_epi16(zero, value)));
+	}
+	return i;
+}
+
+//(src * scale) >> shift saturated to 16 bits -- shift must be 0 to 31
+HOST_DSP_SSE2_FUNCTION static u32 scale_sse2(const q15_t * src, q15_t scale, int shift, q15_t * dst, u32 n){
+	u32 i;
+	__m128i value = _mm_set1_epi16(scale);
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+8 <= n; i+=8){
+		__m128i x = _mm_loadu_si128((const __m128i*)(src+i));
+		__m128i lo = _mm_mullo_epi16(x, value);
+		__m128i hi = _mm_mulhi_epi16(x, value);
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_packs_epi32(
+								  _mm_sra_epi32(_mm_unpacklo_epi16(lo, hi), count),
+								  _mm_sra_epi32(_mm_unpackhi_epi16(lo, hi), count)));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 scale_avx2(const q15_t * src, q15_t scale, int shift, q15_t * dst, u32 n){
+	u32 i;
+	__m256i value = _mm256_set1_epi16(scale);
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+16 <= n; i+=16){
+		__m256i x = _mm256_loadu_si256((const __m256i*)(src+i));
+		__m256i lo = _mm256_mullo_epi16(x, value);
+		__m256i hi = _mm256_mulhi_epi16(x, value);
+		//unpack and pack both work within 128-bit lanes so the order is preserved
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_packs_epi32(
+									  _mm256_sra_epi32(_mm256_unpacklo_epi16(lo, hi), count),
+									  _mm256_sra_epi32(_mm256_unpackhi_epi16(lo, hi), count)));
+	}
+	return i;
+}
+
+//left shift saturates like __SSAT(x << shift, 16) -- shift must be 0 to 31
+HOST_DSP_SSE2_FUNCTION static u32 shift_left_sse2(const q15_t * src, int shift, q15_t * dst, u32 n){
+	u32 i;
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+8 <= n; i+=8){
+		__m128i x = _mm_loadu_si128((const __m128i*)(src+i));
+		__m128i sign = _mm_srai_epi16(x, 15);
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_packs_epi32(
+								  _mm_sll_epi32(_mm_unpacklo_epi16(x, sign), count),
+								  _mm_sll_epi32(_mm_unpackhi_epi16(x, sign), count)));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 shift_left_avx2(const q15_t * src, int shift, q15_t * dst, u32 n){
+	u32 i;
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+16 <= n; i+=16){
+		__m256i x = _mm256_loadu_si256((const __m256i*)(src+i));
+		__m256i sign = _mm256_srai_epi16(x, 15);
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_packs_epi32(
+									  _mm256_sll_epi32(_mm256_unpacklo_epi16(x, sign), count),
+									  _mm256_sll_epi32(_mm256_unpackhi_epi16(x, sign), count)));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 shift_right_sse2(const q15_t * src, int shift, q15_t * dst, u32 n){
+	u32 i;
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+8 <= n; i+=8){
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_sra_epi16(_mm_loadu_si128((const __m128i*)(src+i)), count));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 shift_right_avx2(const q15_t * src, int shift, q15_t * dst, u32 n){
+	u32 i;
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+16 <= n; i+=16){
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_sra_epi16(_mm256_loadu_si256((const __m256i*)(src+i)), count));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static inline q15_t hmin_sse2(__m128i value){
+	value = _mm_min_epi16(value, _mm_srli_si128(value, 8));
+	value = _mm_min_epi16(value, _mm_srli_si128(value, 4));
+	value = _mm_min_epi16(value, _mm_srli_si128(value, 2));
+	return (q15_t)_mm_cvtsi128_si32(value);
+}
+
+HOST_DSP_SSE2_FUNCTION static inline q15_t hmax_sse2(__m128i value){
+	value = _mm_max_epi16(value, _mm_srli_si128(value, 8));
+	value = _mm_max_epi16(value, _mm_srli_si128(value, 4));
+	value = _mm_max_epi16(value, _mm_srli_si128(value, 2));
+	return (q15_t)_mm_cvtsi128_si32(value);
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 min_sse2(const q15_t * src, u32 n, q15_t * result){
+	u32 i;
+	__m128i value = _mm_set1_epi16(INT16_MAX);
+	for(i=0; i+8 <= n; i+=8){
+		value = _mm_min_epi16(value, _mm_loadu_si128((const __m128i*)(src+i)));
+	}
+	*result = hmin_sse2(value);
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 min_avx2(const q15_t * src, u32 n, q15_t * result){
+	u32 i;
+	__m256i value = _mm256_set1_epi16(INT16_MAX);
+	for(i=0; i+16 <= n; i+=16){
+		value = _mm256_min_epi16(value, _mm256_loadu_si256((const __m256i*)(src+i)));
+	}
+	*result = hmin_sse2(_mm_min_epi16(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1)));
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 max_sse2(const q15_t * src, u32 n, q15_t * result){
+	u32 i;
+	__m128i value = _mm_set1_epi16(INT16_MIN);
+	for(i=0; i+8 <= n; i+=8){
+		value = _mm_max_epi16(value, _mm_loadu_si128((const __m128i*)(src+i)));
+	}
+	*result = hmax_sse2(value);
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 max_avx2(const q15_t * src, u32 n, q15_t * result){
+	u32 i;
+	__m256i value = _mm256_set1_epi16(INT16_MIN);
+	for(i=0; i+16 <= n; i+=16){
+		value = _mm256_max_epi16(value, _mm256_loadu_si256((const __m256i*)(src+i)));
+	}
+	*result = hmax_sse2(_mm_max_epi16(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1)));
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 sum_sse2(const q15_t * src, u32 n, s32 * result){
+	u32 i;
+	__m128i one = _mm_set1_epi16(1);
+	__m128i acc = _mm_setzero_si128();
+	for(i=0; i+8 <= n; i+=8){
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(src+i)), one));
+	}
+	*result = host_dsp_hsum_epi32(acc);
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 sum_avx2(const q15_t * src, u32 n, s32 * result){
+	u32 i;
+	__m256i one = _mm256_set1_epi16(1);
+	__m256i acc = _mm256_setzero_si256();
+	for(i=0; i+16 <= n; i+=16){
+		acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(src+i)), one));
+	}
+	*result = host_dsp_hsum_epi32(_mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 dot_sse2(const q15_t * a, const q15_t * b, u32 n, s64 * result){
+	u32 i;
+	__m128i acc = _mm_setzero_si128();
+	for(i=0; i+8 <= n; i+=8){
+		acc = madd_to_epi64_sse2(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(a+i)), _mm_loadu_si128((const __m128i*)(b+i))));
+	}
+	*result = host_dsp_hsum_epi64(acc);
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 dot_avx2(const q15_t * a, const q15_t * b, u32 n, s64 * result){
+	u32 i;
+	__m256i acc = _mm256_setzero_si256();
+	for(i=0; i+16 <= n; i+=16){
+		acc = madd_to_epi64_avx2(acc, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(a+i)), _mm256_loadu_si256((const __m256i*)(b+i))));
+	}
+	*result = host_dsp_hsum_epi64(_mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+	return i;
+}
+
+#endif
+
+#if defined HOST_DSP_NEON
+
+static u32 add_neon(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){ vst1q_s16(dst+i, vqaddq_s16(vld1q_s16(a+i), vld1q_s16(b+i))); }
+	return i;
+}
+
+static u32 sub_neon(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){ vst1q_s16(dst+i, vqsubq_s16(vld1q_s16(a+i), vld1q_s16(b+i))); }
+	return i;
+}
+
+static u32 mult_neon(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){
+	u32 i;
+	//(2*a*b) >> 16 saturated is the same as __SSAT((a*b) >> 15, 16)
+	for(i=0; i+8 <= n; i+=8){ vst1q_s16(dst+i, vqdmulhq_s16(vld1q_s16(a+i), vld1q_s16(b+i))); }
+	return i;
+}
+
+static u32 offset_neon(const q15_t * src, q15_t offset, q15_t * dst, u32 n){
+	u32 i;
+	int16x8_t value = vdupq_n_s16(offset);
+	for(i=0; i+8 <= n; i+=8){ vst1q_s16(dst+i, vqaddq_s16(vld1q_s16(src+i), value)); }
+	return i;
+}
+
+static u32 negate_neon(const q15_t * src, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){ vst1q_s16(dst+i, vqnegq_s16(vld1q_s16(src+i))); }
+	return i;
+}
+
+static u32 abs_neon(const q15_t * src, q15_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){ vst1q_s16(dst+i, vqabsq_s16(vld1q_s16(src+i))); }
+	return i;
+}
+
+static u32 scale_neon(const q15_t * src, q15_t scale, int shift, q15_t * dst, u32 n){
+	u32 i;
+	int16x4_t value = vdup_n_s16(scale);
+	int32x4_t count = vdupq_n_s32(-shift);
+	for(i=0; i+8 <= n; i+=8){
+		int16x8_t x = vld1q_s16(src+i);
+		int32x4_t lo = vshlq_s32(vmull_s16(vget_low_s16(x), value), count);
+		int32x4_t hi = vshlq_s32(vmull_s16(vget_high_s16(x), value), count);
+		vst1q_s16(dst+i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+	}
+	return i;
+}
+
+static u32 shift_left_neon(const q15_t * src, int shift, q15_t * dst, u32 n){
+	u32 i;
+	int32x4_t count = vdupq_n_s32(shift);
+	for(i=0; i+8 <= n; i+=8){
+		int16x8_t x = vld1q_s16(src+i);
+		int32x4_t lo = vshlq_s32(vmovl_s16(vget_low_s16(x)), count);
+		int32x4_t hi = vshlq_s32(vmovl_s16(vget_high_s16(x)), count);
+		vst1q_s16(dst+i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+	}
+	return i;
+}
+
+static u32 shift_right_neon(const q15_t * src, int shift, q15_t * dst, u32 n){
+	u32 i;
+	//a right shift of 16 or more leaves only the sign
+	int16x8_t count = vdupq_n_s16(shift > 15 ? -15 : -shift);
+	for(i=0; i+8 <= n; i+=8){ vst1q_s16(dst+i, vshlq_s16(vld1q_s16(src+i), count)); }
+	return i;
+}
+
+static u32 min_neon(const q15_t * src, u32 n, q15_t * result){
+	u32 i;
+	int16x8_t value = vdupq_n_s16(INT16_MAX);
+	for(i=0; i+8 <= n; i+=8){ value = vminq_s16(value, vld1q_s16(src+i)); }
+	*result = vminvq_s16(value);
+	return i;
+}
+
+static u32 max_neon(const q15_t * src, u32 n, q15_t * result){
+	u32 i;
+	int16x8_t value = vdupq_n_s16(INT16_MIN);
+	for(i=0; i+8 <= n; i+=8){ value = vmaxq_s16(value, vld1q_s16(src+i)); }
+	*result = vmaxvq_s16(value);
+	return i;
+}
+
+static u32 sum_neon(const q15_t * src, u32 n, s32 * result){
+	u32 i;
+	int32x4_t acc = vdupq_n_s32(0);
+	for(i=0; i+8 <= n; i+=8){ acc = vpadalq_s16(acc, vld1q_s16(src+i)); }
+	*result = vaddvq_s32(acc);
+	return i;
+}
+
+static u32 dot_neon(const q15_t * a, const q15_t * b, u32 n, s64 * result){
+	u32 i;
+	int64x2_t acc = vdupq_n_s64(0);
+	for(i=0; i+8 <= n; i+=8){
+		int16x8_t x = vld1q_s16(a+i);
+		int16x8_t y = vld1q_s16(b+i);
+		acc = vpadalq_s32(acc, vmull_s16(vget_low_s16(x), vget_low_s16(y)));
+		acc = vpadalq_s32(acc, vmull_s16(vget_high_s16(x), vget_high_s16(y)));
+	}
+	*result = vaddvq_s64(acc);
+	return i;
+}
+
+#endif
+
+static u32 add_simd(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){ HOST_DSP_SELECT(add, a, b, dst, n) }
+static u32 sub_simd(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){ HOST_DSP_SELECT(sub, a, b, dst, n) }
+static u32 mult_simd(const q15_t * a, const q15_t * b, q15_t * dst, u32 n){ HOST_DSP_SELECT(mult, a, b, dst, n) }
+static u32 offset_simd(const q15_t * src, q15_t offset, q15_t * dst, u32 n){ HOST_DSP_SELECT(offset, src, offset, dst, n) }
+static u32 negate_simd(const q15_t * src, q15_t * dst, u32 n){ HOST_DSP_SELECT(negate, src, dst, n) }
+static u32 abs_simd(const q15_t * src, q15_t * dst, u32 n){ HOST_DSP_SELECT(abs, src, dst, n) }
+static u32 scale_simd(const q15_t * src, q15_t scale, int shift, q15_t * dst, u32 n){ HOST_DSP_SELECT(scale, src, scale, shift, dst, n) }
+static u32 shift_left_simd(const q15_t * src, int shift, q15_t * dst, u32 n){ HOST_DSP_SELECT(shift_left, src, shift, dst, n) }
+static u32 shift_right_simd(const q15_t * src, int shift, q15_t * dst, u32 n){ HOST_DSP_SELECT(shift_right, src, shift, dst, n) }
+static u32 min_simd(const q15_t * src, u32 n, q15_t * result){ HOST_DSP_SELECT(min, src, n, result) }
+static u32 max_simd(const q15_t * src, u32 n, q15_t * result){ HOST_DSP_SELECT(max, src, n, result) }
+static u32 sum_simd(const q15_t * src, u32 n, s32 * result){ HOST_DSP_SELECT(sum, src, n, result) }
+static u32 dot_simd(const q15_t * a, const q15_t * b, u32 n, s64 * result){ HOST_DSP_SELECT(dot, a, b, n, result) }
+
+static s32 sum(const q15_t * src, u32 n){
+	s32 result = 0;
+	u32 i = sum_simd(src, n, &result);
+	for(; i < n; i++){ result = (s32)((u32)result + (u32)(s32)src[i]); }
+	return result;
+}
+
+static s64 dot(const q15_t * a, const q15_t * b, u32 n){
+	s64 result = 0;
+	u32 i = dot_simd(a, b, n, &result);
+	for(; i < n; i++){ result += (q31_t)a[i] * b[i]; }
+	return result;
+}
+
+//mean of squares minus square of mean (as in arm_var_q15() and arm_std_q15())
+static q31_t variance_q15(const q15_t * src, u32 n){
+	q31_t sum_value = sum(src, n);
+	q63_t sum_of_squares = dot(src, src, n);
+	q31_t mean_of_squares = (q31_t)(sum_of_squares / (q63_t)(n - 1U));
+	q31_t square_of_mean = (q31_t)((q63_t)sum_value * sum_value / (q63_t)(n * (n - 1U)));
+	return (mean_of_squares - square_of_mean) >> 15U;
+}
+
+static void host_mean_q15(q15_t * pSrc, u32 blockSize, q15_t * pResult){
+	if( blockSize == 0 ){ *pResult = 0; return; }
+	*pResult = (q15_t)(sum(pSrc, blockSize) / (s32)blockSize);
+}
+
+static void host_power_q15(q15_t * pSrc, u32 blockSize, q63_t * pResult){
+	*pResult = dot(pSrc, pSrc, blockSize);
+}
+
+static void host_var_q15(q15_t * pSrc, u32 blockSize, q15_t * pResult){
+	if( blockSize <= 1U ){ *pResult = 0; return; }
+	*pResult = (q15_t)variance_q15(pSrc, blockSize);
+}
+
+static void host_rms_q15(q15_t * pSrc, u32 blockSize, q15_t * pResult){
+	if( blockSize == 0 ){ *pResult = 0; return; }
+	q63_t sum_of_squares = dot(pSrc, pSrc, blockSize);
+	*pResult = host_dsp_sqrt_q15(host_dsp_ssat16((q31_t)((sum_of_squares / (q63_t)blockSize) >> 15)));
+}
+
+static void host_std_q15(q15_t * pSrc, u32 blockSize, q15_t * pResult){
+	if( blockSize <= 1U ){ *pResult = 0; return; }
+	*pResult = host_dsp_sqrt_q15(host_dsp_ssat16(variance_q15(pSrc, blockSize)));
+}
+
+static void host_min_q15(q15_t * pSrc, u32 blockSize, q15_t * pResult, u32 * pIndex){
+	q15_t value = INT16_MAX;
+	u32 i = min_simd(pSrc, blockSize, &value);
+	for(; i < blockSize; i++){ if( pSrc[i] < value ){ value = pSrc[i]; } }
+	//CMSIS reports the first occurrence
+	for(i=0; (i < blockSize) && (pSrc[i] != value); i++){}
+	*pResult = blockSize ? value : 0;
+	*pIndex = blockSize ? i : 0;
+}
+
+static void host_max_q15(q15_t * pSrc, u32 blockSize, q15_t * pResult, u32 * pIndex){
+	q15_t value = INT16_MIN;
+	u32 i = max_simd(pSrc, blockSize, &value);
+	for(; i < blockSize; i++){ if( pSrc[i] > value ){ value = pSrc[i]; } }
+	for(i=0; (i < blockSize) && (pSrc[i] != value); i++){}
+	*pResult = blockSize ? value : 0;
+	*pIndex = blockSize ? i : 0;
+}
+
+static void host_abs_q15(q15_t * pSrc, q15_t * pDst, u32 blockSize){
+	u32 i = abs_simd(pSrc, pDst, blockSize);
+	for(; i < blockSize; i++){
+		q15_t in = pSrc[i];
+		pDst[i] = (in > 0) ? in : host_dsp_qsub16(0, in);
+	}
+}
+
+static void host_dot_prod_q15(q15_t * pSrcA, q15_t * pSrcB, u32 blockSize, q63_t * result){
+	*result = dot(pSrcA, pSrcB, blockSize);
+}
+
+static void host_negate_q15(q15_t * pSrc, q15_t * pDst, u32 blockSize){
+	u32 i = negate_simd(pSrc, pDst, blockSize);
+	for(; i < blockSize; i++){
+		q15_t in = pSrc[i];
+		pDst[i] = (in == (q15_t)0x8000) ? 0x7fff : -in;
+	}
+}
+
+static void host_shift_q15(q15_t * pSrc, s8 shiftBits, q15_t * pDst, u32 blockSize){
+	u32 i = 0;
+	if( shiftBits >= 0 ){
+		if( shiftBits < 32 ){ i = shift_left_simd(pSrc, shiftBits, pDst, blockSize); }
+		for(; i < blockSize; i++){
+			pDst[i] = host_dsp_ssat16(host_dsp_lsl32(pSrc[i], shiftBits));
+		}
+	} else {
+		if( shiftBits > -32 ){ i = shift_right_simd(pSrc, -shiftBits, pDst, blockSize); }
+		for(; i < blockSize; i++){
+			pDst[i] = pSrc[i] >> -shiftBits;
+		}
+	}
+}
+
+static void host_scale_q15(q15_t * pSrc, q15_t scaleFract, s8 shift, q15_t * pDst, u32 blockSize){
+	s8 kShift = 15 - shift;
+	u32 i = 0;
+	if( (kShift >= 0) && (kShift < 32) ){
+		i = scale_simd(pSrc, scaleFract, kShift, pDst, blockSize);
+	}
+	for(; i < blockSize; i++){
+		pDst[i] = host_dsp_ssat16(((q31_t)pSrc[i] * scaleFract) >> kShift);
+	}
+}
+
+static void host_offset_q15(q15_t * pSrc, q15_t offset, q15_t * pDst, u32 blockSize){
+	u32 i = offset_simd(pSrc, offset, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = host_dsp_qadd16(pSrc[i], offset); }
+}
+
+static void host_add_q15(q15_t * pSrcA, q15_t * pSrcB, q15_t * pDst, u32 blockSize){
+	u32 i = add_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = host_dsp_qadd16(pSrcA[i], pSrcB[i]); }
+}
+
+static void host_sub_q15(q15_t * pSrcA, q15_t * pSrcB, q15_t * pDst, u32 blockSize){
+	u32 i = sub_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = host_dsp_qsub16(pSrcA[i], pSrcB[i]); }
+}
+
+static void host_mult_q15(q15_t * pSrcA, q15_t * pSrcB, q15_t * pDst, u32 blockSize){
+	u32 i = mult_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = host_dsp_ssat16(((q31_t)pSrcA[i] * pSrcB[i]) >> 15); }
+}
+
+const host_dsp_api_q15_t host_dsp_api_q15 = {
+	host_mean_q15,
+	host_power_q15,
+	host_var_q15,
+	host_rms_q15,
+	host_std_q15,
+	host_min_q15,
+	host_max_q15,
+	host_abs_q15,
+	host_dot_prod_q15,
+	host_negate_q15,
+	host_shift_q15,
+	host_scale_q15,
+	host_offset_q15,
+	host_add_q15,
+	host_sub_q15,
+	host_mult_q15
+};
@@ -0,0 +1,658 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#include "HostDspLocal.h"
+
+/*
+ * q1.31 kernels -- the scalar code follows CMSIS DSP exactly
+ * and the SIMD code produces the same bits.
+ *
+ * SSE2 has no signed 32x32->64 multiply so the multiply kernels
+ * use the scalar code on CPUs without AVX2.
+ *
+ */
+
+#if defined HOST_DSP_X86
+
+//result where the 32-bit signed operation overflowed (0x7FFFFFFF or 0x80000000 from the sign of a)
+HOST_DSP_SSE2_FUNCTION static inline __m128i saturate_sse2(__m128i a, __m128i result, __m128i overflow){
+	__m128i mask = _mm_srai_epi32(overflow, 31);
+	__m128i limit = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(0x7FFFFFFF));
+	return _mm_or_si128(_mm_and_si128(mask, limit), _mm_andnot_si128(mask, result));
+}
+
+HOST_DSP_AVX2_FUNCTION static inline __m256i saturate_avx2(__m256i a, __m256i result, __m256i overflow){
+	__m256i limit = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(0x7FFFFFFF));
+	return _mm256_blendv_epi8(result, limit, _mm256_srai_epi32(overflow, 31));
+}
+
+HOST_DSP_SSE2_FUNCTION static inline __m128i qadd_sse2(__m128i a, __m128i b){
+	__m128i result = _mm_add_epi32(a, b);
+	return saturate_sse2(a, result, _mm_and_si128(_mm_xor_si128(a, result), _mm_xor_si128(b, result)));
+}
+
+HOST_DSP_AVX2_FUNCTION static inline __m256i qadd_avx2(__m256i a, __m256i b){
+	__m256i result = _mm256_add_epi32(a, b);
+	return saturate_avx2(a, result, _mm256_and_si256(_mm256_xor_si256(a, result), _mm256_xor_si256(b, result)));
+}
+
+HOST_DSP_SSE2_FUNCTION static inline __m128i qsub_sse2(__m128i a, __m128i b){
+	__m128i result = _mm_sub_epi32(a, b);
+	return saturate_sse2(a, result, _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, result)));
+}
+
+HOST_DSP_AVX2_FUNCTION static inline __m256i qsub_avx2(__m256i a, __m256i b){
+	__m256i result = _mm256_sub_epi32(a, b);
+	return saturate_avx2(a, result, _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, result)));
+}
+
+//-x with -(INT32_MIN) saturated to INT32_MAX
+HOST_DSP_SSE2_FUNCTION static inline __m128i qneg_sse2(__m128i x){
+	return _mm_xor_si128(_mm_sub_epi32(_mm_setzero_si128(), x), _mm_cmpeq_epi32(x, _mm_set1_epi32(INT32_MIN)));
+}
+
+HOST_DSP_AVX2_FUNCTION static inline __m256i qneg_avx2(__m256i x){
+	return _mm256_xor_si256(_mm256_sub_epi32(_mm256_setzero_si256(), x), _mm256_cmpeq_epi32(x, _mm256_set1_epi32(INT32_MIN)));
+}
+
+//x << shift saturated as in clip_q63_to_q31((q63_t)x << shift)
+HOST_DSP_SSE2_FUNCTION static inline __m128i qshl_sse2(__m128i x, __m128i count){
+	__m128i result = _mm_sll_epi32(x, count);
+	__m128i overflow = _mm_xor_si128(_mm_cmpeq_epi32(_mm_sra_epi32(result, count), x), _mm_set1_epi32(-1));
+	return saturate_sse2(x, result, overflow);
+}
+
+HOST_DSP_AVX2_FUNCTION static inline __m256i qshl_avx2(__m256i x, __m128i count){
+	__m256i result = _mm256_sll_epi32(x, count);
+	__m256i overflow = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_sra_epi32(result, count), x), _mm256_set1_epi32(-1));
+	return saturate_avx2(x, result, overflow);
+}
+
+//upper 32 bits of each signed 64-bit product a*b
+HOST_DSP_AVX2_FUNCTION static inline __m256i mulhi_avx2(__m256i a, __m256i b){
+	__m256i even = _mm256_mul_epi32(a, b);
+	__m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	return _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+//arithmetic right shift of 64-bit lanes (AVX2 only has the logical one)
+HOST_DSP_AVX2_FUNCTION static inline __m256i srai_epi64_avx2(__m256i x, int shift){
+	__m256i sign = _mm256_set1_epi64x((s64)1 << (63 - shift));
+	x = _mm256_srli_epi64(x, shift);
+	return _mm256_sub_epi64(_mm256_xor_si256(x, sign), sign);
+}
+
+HOST_DSP_AVX2_FUNCTION static inline __m256i mul_shift_acc_avx2(__m256i acc, __m256i a, __m256i b, int shift){
+	__m256i even = _mm256_mul_epi32(a, b);
+	__m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	if( shift ){
+		even = srai_epi64_avx2(even, shift);
+		odd = srai_epi64_avx2(odd, shift);
+	}
+	return _mm256_add_epi64(acc, _mm256_add_epi64(even, odd));
+}
+
+HOST_DSP_AVX2_FUNCTION static inline s64 hsum_epi64_avx2(__m256i value){
+	return host_dsp_hsum_epi64(_mm_add_epi64(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1)));
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 add_sse2(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+4 <= n; i+=4){
+		_mm_storeu_si128((__m128i*)(dst+i), qadd_sse2(_mm_loadu_si128((const __m128i*)(a+i)), _mm_loadu_si128((const __m128i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 add_avx2(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){
+		_mm256_storeu_si256((__m256i*)(dst+i), qadd_avx2(_mm256_loadu_si256((const __m256i*)(a+i)), _mm256_loadu_si256((const __m256i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 sub_sse2(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+4 <= n; i+=4){
+		_mm_storeu_si128((__m128i*)(dst+i), qsub_sse2(_mm_loadu_si128((const __m128i*)(a+i)), _mm_loadu_si128((const __m128i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 sub_avx2(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){
+		_mm256_storeu_si256((__m256i*)(dst+i), qsub_avx2(_mm256_loadu_si256((const __m256i*)(a+i)), _mm256_loadu_si256((const __m256i*)(b+i))));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 offset_sse2(const q31_t * src, q31_t offset, q31_t * dst, u32 n){
+	u32 i;
+	__m128i value = _mm_set1_epi32(offset);
+	for(i=0; i+4 <= n; i+=4){
+		_mm_storeu_si128((__m128i*)(dst+i), qadd_sse2(_mm_loadu_si128((const __m128i*)(src+i)), value));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 offset_avx2(const q31_t * src, q31_t offset, q31_t * dst, u32 n){
+	u32 i;
+	__m256i value = _mm256_set1_epi32(offset);
+	for(i=0; i+8 <= n; i+=8){
+		_mm256_storeu_si256((__m256i*)(dst+i), qadd_avx2(_mm256_loadu_si256((const __m256i*)(src+i)), value));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 negate_sse2(const q31_t * src, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+4 <= n; i+=4){
+		_mm_storeu_si128((__m128i*)(dst+i), qneg_sse2(_mm_loadu_si128((const __m128i*)(src+i))));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 negate_avx2(const q31_t * src, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){
+		_mm256_storeu_si256((__m256i*)(dst+i), qneg_avx2(_mm256_loadu_si256((const __m256i*)(src+i))));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 abs_sse2(const q31_t * src, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+4 <= n; i+=4){
+		__m128i x = _mm_loadu_si128((const __m128i*)(src+i));
+		__m128i sign = _mm_srai_epi32(x, 31);
+		__m128i result = _mm_sub_epi32(_mm_xor_si128(x, sign), sign);
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_xor_si128(result, _mm_cmpeq_epi32(x, _mm_set1_epi32(INT32_MIN))));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 abs_avx2(const q31_t * src, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+8 <= n; i+=8){
+		__m256i x = _mm256_loadu_si256((const __m256i*)(src+i));
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_xor_si256(_mm256_abs_epi32(x), _mm256_cmpeq_epi32(x, _mm256_set1_epi32(INT32_MIN))));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 shift_left_sse2(const q31_t * src, int shift, q31_t * dst, u32 n){
+	u32 i;
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+4 <= n; i+=4){
+		_mm_storeu_si128((__m128i*)(dst+i), qshl_sse2(_mm_loadu_si128((const __m128i*)(src+i)), count));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 shift_left_avx2(const q31_t * src, int shift, q31_t * dst, u32 n){
+	u32 i;
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+8 <= n; i+=8){
+		_mm256_storeu_si256((__m256i*)(dst+i), qshl_avx2(_mm256_loadu_si256((const __m256i*)(src+i)), count));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 shift_right_sse2(const q31_t * src, int shift, q31_t * dst, u32 n){
+	u32 i;
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+4 <= n; i+=4){
+		_mm_storeu_si128((__m128i*)(dst+i), _mm_sra_epi32(_mm_loadu_si128((const __m128i*)(src+i)), count));
+	}
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 shift_right_avx2(const q31_t * src, int shift, q31_t * dst, u32 n){
+	u32 i;
+	__m128i count = _mm_cvtsi32_si128(shift);
+	for(i=0; i+8 <= n; i+=8){
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_sra_epi32(_mm256_loadu_si256((const __m256i*)(src+i)), count));
+	}
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 min_sse2(const q31_t * src, u32 n, q31_t * result){
+	u32 i;
+	q31_t lanes[4];
+	__m128i value = _mm_set1_epi32(INT32_MAX);
+	for(i=0; i+4 <= n; i+=4){
+		__m128i x = _mm_loadu_si128((const __m128i*)(src+i));
+		__m128i mask = _mm_cmpgt_epi32(value, x);
+		value = _mm_or_si128(_mm_and_si128(mask, x), _mm_andnot_si128(mask, value));
+	}
+	_mm_storeu_si128((__m128i*)lanes, value);
+	*result = lanes[0];
+	for(u32 j=1; j < 4; j++){ if( lanes[j] < *result ){ *result = lanes[j]; } }
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 min_avx2(const q31_t * src, u32 n, q31_t * result){
+	u32 i;
+	q31_t lanes[8];
+	__m256i value = _mm256_set1_epi32(INT32_MAX);
+	for(i=0; i+8 <= n; i+=8){
+		value = _mm256_min_epi32(value, _mm256_loadu_si256((const __m256i*)(src+i)));
+	}
+	_mm256_storeu_si256((__m256i*)lanes, value);
+	*result = lanes[0];
+	for(u32 j=1; j < 8; j++){ if( lanes[j] < *result ){ *result = lanes[j]; } }
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 max_sse2(const q31_t * src, u32 n, q31_t * result){
+	u32 i;
+	q31_t lanes[4];
+	__m128i value = _mm_set1_epi32(INT32_MIN);
+	for(i=0; i+4 <= n; i+=4){
+		__m128i x = _mm_loadu_si128((const __m128i*)(src+i));
+		__m128i mask = _mm_cmpgt_epi32(x, value);
+		value = _mm_or_si128(_mm_and_si128(mask, x), _mm_andnot_si128(mask, value));
+	}
+	_mm_storeu_si128((__m128i*)lanes, value);
+	*result = lanes[0];
+	for(u32 j=1; j < 4; j++){ if( lanes[j] > *result ){ *result = lanes[j]; } }
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 max_avx2(const q31_t * src, u32 n, q31_t * result){
+	u32 i;
+	q31_t lanes[8];
+	__m256i value = _mm256_set1_epi32(INT32_MIN);
+	for(i=0; i+8 <= n; i+=8){
+		value = _mm256_max_epi32(value, _mm256_loadu_si256((const __m256i*)(src+i)));
+	}
+	_mm256_storeu_si256((__m256i*)lanes, value);
+	*result = lanes[0];
+	for(u32 j=1; j < 8; j++){ if( lanes[j] > *result ){ *result = lanes[j]; } }
+	return i;
+}
+
+HOST_DSP_SSE2_FUNCTION static u32 sum_sse2(const q31_t * src, u32 n, s64 * result){
+	u32 i;
+	__m128i acc = _mm_setzero_si128();
+	for(i=0; i+4 <= n; i+=4){
+		__m128i x = _mm_loadu_si128((const __m128i*)(src+i));
+		__m128i sign = _mm_srai_epi32(x, 31);
+		acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(x, sign));
+		acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(x, sign));
+	}
+	*result = host_dsp_hsum_epi64(acc);
+	return i;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 sum_avx2(const q31_t * src, u32 n, s64 * result){
+	u32 i;
+	__m256i acc = _mm256_setzero_si256();
+	for(i=0; i+8 <= n; i+=8){
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(src+i))));
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(src+i+4))));
+	}
+	*result = hsum_epi64_avx2(acc);
+	return i;
+}
+
+//sum of (a*b) >> shift using 64-bit products
+static u32 dot_sse2(const q31_t * a, const q31_t * b, u32 n, int shift, s64 * result){
+	return 0;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 dot_avx2(const q31_t * a, const q31_t * b, u32 n, int shift, s64 * result){
+	u32 i;
+	__m256i acc = _mm256_setzero_si256();
+	for(i=0; i+8 <= n; i+=8){
+		acc = mul_shift_acc_avx2(acc, _mm256_loadu_si256((const __m256i*)(a+i)), _mm256_loadu_si256((const __m256i*)(b+i)), shift);
+	}
+	*result = hsum_epi64_avx2(acc);
+	return i;
+}
+
+static u32 mult_sse2(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	return 0;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 mult_avx2(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	u32 i;
+	__m256i min = _mm256_set1_epi32(INT32_MIN);
+	__m256i limit = _mm256_set1_epi32(0x7FFFFFFE);
+	for(i=0; i+8 <= n; i+=8){
+		__m256i x = _mm256_loadu_si256((const __m256i*)(a+i));
+		__m256i y = _mm256_loadu_si256((const __m256i*)(b+i));
+		__m256i result = _mm256_slli_epi32(mulhi_avx2(x, y), 1);
+		//INT32_MIN * INT32_MIN is the only product that saturates
+		__m256i overflow = _mm256_and_si256(_mm256_cmpeq_epi32(x, min), _mm256_cmpeq_epi32(y, min));
+		_mm256_storeu_si256((__m256i*)(dst+i), _mm256_blendv_epi8(result, limit, overflow));
+	}
+	return i;
+}
+
+static u32 scale_sse2(const q31_t * src, q31_t scale, int shift, q31_t * dst, u32 n){
+	return 0;
+}
+
+HOST_DSP_AVX2_FUNCTION static u32 scale_avx2(const q31_t * src, q31_t scale, int shift, q31_t * dst, u32 n){
+	u32 i;
+	__m256i value = _mm256_set1_epi32(scale);
+	__m128i count = _mm_cvtsi32_si128(shift < 0 ? -shift : shift);
+	for(i=0; i+8 <= n; i+=8){
+		__m256i x = mulhi_avx2(_mm256_loadu_si256((const __m256i*)(src+i)), value);
+		if( shift >= 0 ){
+			x = qshl_avx2(x, count);
+		} else {
+			x = _mm256_sra_epi32(x, count);
+		}
+		_mm256_storeu_si256((__m256i*)(dst+i), x);
+	}
+	return i;
+}
+
+#endif
+
+#if defined HOST_DSP_NEON
+
+static u32 add_neon(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+4 <= n; i+=4){ vst1q_s32(dst+i, vqaddq_s32(vld1q_s32(a+i), vld1q_s32(b+i))); }
+	return i;
+}
+
+static u32 sub_neon(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+4 <= n; i+=4){ vst1q_s32(dst+i, vqsubq_s32(vld1q_s32(a+i), vld1q_s32(b+i))); }
+	return i;
+}
+
+static u32 offset_neon(const q31_t * src, q31_t offset, q31_t * dst, u32 n){
+	u32 i;
+	int32x4_t value = vdupq_n_s32(offset);
+	for(i=0; i+4 <= n; i+=4){ vst1q_s32(dst+i, vqaddq_s32(vld1q_s32(src+i), value)); }
+	return i;
+}
+
+static u32 negate_neon(const q31_t * src, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+4 <= n; i+=4){ vst1q_s32(dst+i, vqnegq_s32(vld1q_s32(src+i))); }
+	return i;
+}
+
+static u32 abs_neon(const q31_t * src, q31_t * dst, u32 n){
+	u32 i;
+	for(i=0; i+4 <= n; i+=4){ vst1q_s32(dst+i, vqabsq_s32(vld1q_s32(src+i))); }
+	return i;
+}
+
+static u32 shift_left_neon(const q31_t * src, int shift, q31_t * dst, u32 n){
+	u32 i;
+	int32x4_t count = vdupq_n_s32(shift);
+	for(i=0; i+4 <= n; i+=4){ vst1q_s32(dst+i, vqshlq_s32(vld1q_s32(src+i), count)); }
+	return i;
+}
+
+static u32 shift_right_neon(const q31_t * src, int shift, q31_t * dst, u32 n){
+	u32 i;
+	int32x4_t count = vdupq_n_s32(-shift);
+	for(i=0; i+4 <= n; i+=4){ vst1q_s32(dst+i, vshlq_s32(vld1q_s32(src+i), count)); }
+	return i;
+}
+
+static u32 min_neon(const q31_t * src, u32 n, q31_t * result){
+	u32 i;
+	int32x4_t value = vdupq_n_s32(INT32_MAX);
+	for(i=0; i+4 <= n; i+=4){ value = vminq_s32(value, vld1q_s32(src+i)); }
+	*result = vminvq_s32(value);
+	return i;
+}
+
+static u32 max_neon(const q31_t * src, u32 n, q31_t * result){
+	u32 i;
+	int32x4_t value = vdupq_n_s32(INT32_MIN);
+	for(i=0; i+4 <= n; i+=4){ value = vmaxq_s32(value, vld1q_s32(src+i)); }
+	*result = vmaxvq_s32(value);
+	return i;
+}
+
+static u32 sum_neon(const q31_t * src, u32 n, s64 * result){
+	u32 i;
+	int64x2_t acc = vdupq_n_s64(0);
+	for(i=0; i+4 <= n; i+=4){ acc = vpadalq_s32(acc, vld1q_s32(src+i)); }
+	*result = vaddvq_s64(acc);
+	return i;
+}
+
+static u32 dot_neon(const q31_t * a, const q31_t * b, u32 n, int shift, s64 * result){
+	u32 i;
+	int64x2_t acc = vdupq_n_s64(0);
+	int64x2_t count = vdupq_n_s64(-shift);
+	for(i=0; i+4 <= n; i+=4){
+		int32x4_t x = vld1q_s32(a+i);
+		int32x4_t y = vld1q_s32(b+i);
+		acc = vaddq_s64(acc, vshlq_s64(vmull_s32(vget_low_s32(x), vget_low_s32(y)), count));
+		acc = vaddq_s64(acc, vshlq_s64(vmull_high_s32(x, y), count));
+	}
+	*result = vaddvq_s64(acc);
+	return i;
+}
+
+static inline int32x4_t mulhi_neon(int32x4_t x, int32x4_t y){
+	return vcombine_s32(
+				vshrn_n_s64(vmull_s32(vget_low_s32(x), vget_low_s32(y)), 32),
+				vshrn_n_s64(vmull_high_s32(x, y), 32));
+}
+
+static u32 mult_neon(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){
+	u32 i;
+	int32x4_t min = vdupq_n_s32(INT32_MIN);
+	int32x4_t limit = vdupq_n_s32(0x7FFFFFFE);
+	for(i=0; i+4 <= n; i+=4){
+		int32x4_t x = vld1q_s32(a+i);
+		int32x4_t y = vld1q_s32(b+i);
+		int32x4_t result = vshlq_n_s32(mulhi_neon(x, y), 1);
+		uint32x4_t overflow = vandq_u32(vceqq_s32(x, min), vceqq_s32(y, min));
+		vst1q_s32(dst+i, vbslq_s32(overflow, limit, result));
+	}
+	return i;
+}
+
+static u32 scale_neon(const q31_t * src, q31_t scale, int shift, q31_t * dst, u32 n){
+	u32 i;
+	int32x4_t value = vdupq_n_s32(scale);
+	int32x4_t count = vdupq_n_s32(shift);
+	for(i=0; i+4 <= n; i+=4){
+		int32x4_t x = mulhi_neon(vld1q_s32(src+i), value);
+		//saturating shift left or (with a negative count) plain shift right
+		vst1q_s32(dst+i, shift >= 0 ? vqshlq_s32(x, count) : vshlq_s32(x, count));
+	}
+	return i;
+}
+
+#endif
+
+static u32 add_simd(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){ HOST_DSP_SELECT(add, a, b, dst, n) }
+static u32 sub_simd(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){ HOST_DSP_SELECT(sub, a, b, dst, n) }
+static u32 mult_simd(const q31_t * a, const q31_t * b, q31_t * dst, u32 n){ HOST_DSP_SELECT(mult, a, b, dst, n) }
+static u32 offset_simd(const q31_t * src, q31_t offset, q31_t * dst, u32 n){ HOST_DSP_SELECT(offset, src, offset, dst, n) }
+static u32 negate_simd(const q31_t * src, q31_t * dst, u32 n){ HOST_DSP_SELECT(negate, src, dst, n) }
+static u32 abs_simd(const q31_t * src, q31_t * dst, u32 n){ HOST_DSP_SELECT(abs, src, dst, n) }
+static u32 scale_simd(const q31_t * src, q31_t scale, int shift, q31_t * dst, u32 n){ HOST_DSP_SELECT(scale, src, scale, shift, dst, n) }
+static u32 shift_left_simd(const q31_t * src, int shift, q31_t * dst, u32 n){ HOST_DSP_SELECT(shift_left, src, shift, dst, n) }
+static u32 shift_right_simd(const q31_t * src, int shift, q31_t * dst, u32 n){ HOST_DSP_SELECT(shift_right, src, shift, dst, n) }
+static u32 min_simd(const q31_t * src, u32 n, q31_t * result){ HOST_DSP_SELECT(min, src, n, result) }
+static u32 max_simd(const q31_t * src, u32 n, q31_t * result){ HOST_DSP_SELECT(max, src, n, result) }
+static u32 sum_simd(const q31_t * src, u32 n, s64 * result){ HOST_DSP_SELECT(sum, src, n, result) }
+static u32 dot_simd(const q31_t * a, const q31_t * b, u32 n, int shift, s64 * result){ HOST_DSP_SELECT(dot, a, b, n, shift, result) }
+
+static s64 sum(const q31_t * src, u32 n){
+	s64 result = 0;
+	u32 i = sum_simd(src, n, &result);
+	for(; i < n; i++){ result += src[i]; }
+	return result;
+}
+
+//sum of (a*b) >> shift -- the sum wraps like the device's 64-bit accumulator
+static s64 dot(const q31_t * a, const q31_t * b, u32 n, int shift){
+	s64 result = 0;
+	u32 i = dot_simd(a, b, n, shift, &result);
+	for(; i < n; i++){ result = (s64)((u64)result + (u64)(((q63_t)a[i] * b[i]) >> shift)); }
+	return result;
+}
+
+//mean of squares minus square of mean on values reduced to 1.23 (as in arm_var_q31() and arm_std_q31())
+static q31_t variance_q31(const q31_t * src, u32 n){
+	q63_t sum_value = 0;
+	q63_t sum_of_squares = 0;
+	for(u32 i=0; i < n; i++){
+		q31_t in = src[i] >> 8U;
+		sum_of_squares += (q63_t)in * in;
+		sum_value += in;
+	}
+	q63_t mean_of_squares = sum_of_squares / (q63_t)(n - 1U);
+	q63_t square_of_mean = sum_value * sum_value / (q63_t)(n * (n - 1U));
+	return (q31_t)((mean_of_squares - square_of_mean) >> 15U);
+}
+
+static void host_mean_q31(q31_t * pSrc, u32 blockSize, q31_t * pResult){
+	if( blockSize == 0 ){ *pResult = 0; return; }
+	*pResult = (q31_t)(sum(pSrc, blockSize) / blockSize);
+}
+
+static void host_power_q31(q31_t * pSrc, u32 blockSize, q63_t * pResult){
+	*pResult = dot(pSrc, pSrc, blockSize, 14);
+}
+
+static void host_var_q31(q31_t * pSrc, u32 blockSize, q31_t * pResult){
+	if( blockSize <= 1U ){ *pResult = 0; return; }
+	*pResult = variance_q31(pSrc, blockSize);
+}
+
+static void host_rms_q31(q31_t * pSrc, u32 blockSize, q31_t * pResult){
+	if( blockSize == 0 ){ *pResult = 0; return; }
+	q63_t sum_of_squares = dot(pSrc, pSrc, blockSize, 0);
+	*pResult = host_dsp_sqrt_q31(host_dsp_clip_q63_to_q31((sum_of_squares / (q63_t)blockSize) >> 31));
+}
+
+static void host_std_q31(q31_t * pSrc, u32 blockSize, q31_t * pResult){
+	if( blockSize <= 1U ){ *pResult = 0; return; }
+	*pResult = host_dsp_sqrt_q31(variance_q31(pSrc, blockSize));
+}
+
+static void host_min_q31(q31_t * pSrc, u32 blockSize, q31_t * pResult, u32 * pIndex){
+	q31_t value = INT32_MAX;
+	u32 i = min_simd(pSrc, blockSize, &value);
+	for(; i < blockSize; i++){ if( pSrc[i] < value ){ value = pSrc[i]; } }
+	//CMSIS reports the first occurrence
+	for(i=0; (i < blockSize) && (pSrc[i] != value); i++){}
+	*pResult = blockSize ? value : 0;
+	*pIndex = blockSize ? i : 0;
+}
+
+static void host_max_q31(q31_t * pSrc, u32 blockSize, q31_t * pResult, u32 * pIndex){
+	q31_t value = INT32_MIN;
+	u32 i = max_simd(pSrc, blockSize, &value);
+	for(; i < blockSize; i++){ if( pSrc[i] > value ){ value = pSrc[i]; } }
+	for(i=0; (i < blockSize) && (pSrc[i] != value); i++){}
+	*pResult = blockSize ? value : 0;
+	*pIndex = blockSize ? i : 0;
+}
+
+static void host_abs_q31(q31_t * pSrc, q31_t * pDst, u32 blockSize){
+	u32 i = abs_simd(pSrc, pDst, blockSize);
+	for(; i < blockSize; i++){
+		q31_t in = pSrc[i];
+		pDst[i] = (in > 0) ? in : host_dsp_qsub(0, in);
+	}
+}
+
+static void host_dot_prod_q31(q31_t * pSrcA, q31_t * pSrcB, u32 blockSize, q63_t * result){
+	*result = dot(pSrcA, pSrcB, blockSize, 14);
+}
+
+static void host_negate_q31(q31_t * pSrc, q31_t * pDst, u32 blockSize){
+	u32 i = negate_simd(pSrc, pDst, blockSize);
+	for(; i < blockSize; i++){
+		q31_t in = pSrc[i];
+		pDst[i] = (in == INT32_MIN) ? INT32_MAX : -in;
+	}
+}
+
+static void host_shift_q31(q31_t * pSrc, s8 shiftBits, q31_t * pDst, u32 blockSize){
+	u32 i = 0;
+	if( shiftBits >= 0 ){
+		if( shiftBits < 32 ){ i = shift_left_simd(pSrc, shiftBits, pDst, blockSize); }
+		for(; i < blockSize; i++){
+			pDst[i] = host_dsp_clip_q63_to_q31((q63_t)((u64)(q63_t)pSrc[i] << shiftBits));
+		}
+	} else {
+		if( shiftBits > -32 ){ i = shift_right_simd(pSrc, -shiftBits, pDst, blockSize); }
+		for(; i < blockSize; i++){
+			pDst[i] = pSrc[i] >> -shiftBits;
+		}
+	}
+}
+
+static void host_scale_q31(q31_t * pSrc, q31_t scaleFract, s8 shift, q31_t * pDst, u32 blockSize){
+	s8 kShift = shift + 1;
+	u32 i = 0;
+	if( (kShift > -32) && (kShift < 32) ){
+		i = scale_simd(pSrc, scaleFract, kShift, pDst, blockSize);
+	}
+	for(; i < blockSize; i++){
+		q31_t in = (q31_t)(((q63_t)pSrc[i] * scaleFract) >> 32);
+		if( kShift >= 0 ){
+			q31_t out = host_dsp_lsl32(in, kShift);
+			if( in != (out >> kShift) ){
+				out = 0x7FFFFFFF ^ (in >> 31);
+			}
+			pDst[i] = out;
+		} else {
+			pDst[i] = in >> -kShift;
+		}
+	}
+}
+
+static void host_offset_q31(q31_t * pSrc, q31_t offset, q31_t * pDst, u32 blockSize){
+	u32 i = offset_simd(pSrc, offset, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = host_dsp_qadd(pSrc[i], offset); }
+}
+
+static void host_add_q31(q31_t * pSrcA, q31_t * pSrcB, q31_t * pDst, u32 blockSize){
+	u32 i = add_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = host_dsp_qadd(pSrcA[i], pSrcB[i]); }
+}
+
+static void host_sub_q31(q31_t * pSrcA, q31_t * pSrcB, q31_t * pDst, u32 blockSize){
+	u32 i = sub_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){ pDst[i] = host_dsp_qsub(pSrcA[i], pSrcB[i]); }
+}
+
+static void host_mult_q31(q31_t * pSrcA, q31_t * pSrcB, q31_t * pDst, u32 blockSize){
+	u32 i = mult_simd(pSrcA, pSrcB, pDst, blockSize);
+	for(; i < blockSize; i++){
+		q31_t out = (q31_t)(((q63_t)pSrcA[i] * pSrcB[i]) >> 32);
+		out = host_dsp_ssat(out, 31);
+		pDst[i] = host_dsp_lsl32(out, 1);
+	}
+}
+
+const host_dsp_api_q31_t host_dsp_api_q31 = {
+	host_mean_q31,
+	host_power_q31,
+	host_var_q31,
+	host_rms_q31,
+	host_std_q31,
+	host_min_q31,
+	host_max_q31,
+	host_abs_q31,
+	host_dot_prod_q31,
+	host_negate_q31,
+	host_shift_q31,
+	host_scale_q31,
+	host_offset_q31,
+	host_add_q31,
+	host_sub_q31,
+	host_mult_q31
+};
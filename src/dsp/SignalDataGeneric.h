@@ -90,7 +90,8 @@ void SignalType::negate(SignalType & output) const {
 	arm_dsp_api_function()->negate((native_type*)vector_data_const(), output.vector_data(), count());
 }
 
-
+#if !defined __link
+//convolution, filters and transforms are only provided by the device's CMSIS DSP library
 SignalType SignalType::convolve(const SignalType & a) const {
 	SignalType ret(count() + a.count() - 1);
 #if IS_FLOAT == 0
@@ -109,6 +110,7 @@ void SignalType::convolve(SignalType & output, const SignalType & a) const {
 	arm_dsp_api_function()->conv((native_type*)vector_data_const(), count(), (native_type*)a.vector_data_const(), a.count(), output.vector_data());
 #endif
 }
+#endif
 
 #if IS_FLOAT == 0
 void SignalType::shift(SignalType & output, s8 value) const {
@@ -209,6 +211,7 @@ SignalType & SignalType::subtract_assign(const SignalType & a){
 	return *this;
 }
 
+#if !defined __link
 SignalType SignalType::filter(const BiquadFilterType & filter) const {
 	SignalType ret(count());
 #if IS_FLOAT == 0
@@ -306,5 +309,4 @@ SignalComplexType SignalComplexType::transform(FftRealType & fft, bool is_invers
 
 	return ret;
 }
-
-
+#endif
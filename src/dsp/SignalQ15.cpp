@@ -1,8 +1,10 @@
 
 
 #include "dsp/SignalData.hpp"
+#if !defined __link
 #include "dsp/Transform.hpp"
 #include "dsp/Filter.hpp"
+#endif
 
 using namespace dsp;
 
@@ -1,6 +1,8 @@
 #include "dsp/SignalData.hpp"
+#if !defined __link
 #include "dsp/Transform.hpp"
 #include "dsp/Filter.hpp"
+#endif
 
 using namespace dsp;
 
@@ -20,6 +22,8 @@ using namespace dsp;
 
 #include "SignalDataGeneric.h"
 
+#if !defined __link
+
 SignalQ31 SignalQ31::filter(const FirDecimateFilterQ31 & filter){
 	SignalQ31 ret(count());
 	api_q31()->fir_decimate_fast((arm_fir_decimate_instance_q31*)filter.instance(), (q31_t*)vector_data_const(), ret.vector_data(), count());
@@ -30,4 +34,4 @@ SignalQ31 SignalQ31::filter(const FirDecimateFilterQ31 & filter){
 void SignalQ31::filter(SignalQ31 & output, const FirDecimateFilterQ31 & filter){
 	api_q31()->fir_decimate_fast((arm_fir_decimate_instance_q31*)filter.instance(), (q31_t*)vector_data_const(), output.vector_data(), count());
 }
-
+#endif
@@ -4,11 +4,88 @@
 
 using namespace dsp;
 
+/*! \cond */
+//FFT lengths are powers of two so each cache has one slot per exponent
+enum {
+	PLAN_SLOTS = 14
+};
+
+template<typename T> struct fft_plan_cache_t {
+	T plan[PLAN_SLOTS];
+	volatile u16 is_valid;
+};
+
+static fft_plan_cache_t<arm_rfft_instance_q15> m_rfft_q15_plans;
+static fft_plan_cache_t<arm_rfft_instance_q31> m_rfft_q31_plans;
+static fft_plan_cache_t<arm_rfft_fast_instance_f32> m_rfft_f32_plans;
+
+static int plan_slot(u32 n_samples){
+	int slot = 0;
+	if( (n_samples == 0) || (n_samples & (n_samples-1)) ){ return -1; }
+	while( n_samples > 1 ){
+		n_samples >>= 1;
+		slot++;
+	}
+	return slot < PLAN_SLOTS ? slot : -1;
+}
+
+template<typename T> static bool load_plan(const fft_plan_cache_t<T> & cache, int slot, T * instance){
+	if( (slot >= 0) && (cache.is_valid & (1<<slot)) ){
+		memcpy(instance, cache.plan + slot, sizeof(T));
+		return true;
+	}
+	return false;
+}
+
+template<typename T> static void save_plan(fft_plan_cache_t<T> & cache, int slot, const T * instance){
+	if( slot >= 0 ){
+		//the plan is complete before it is marked valid
+		memcpy(cache.plan + slot, instance, sizeof(T));
+		cache.is_valid |= (1<<slot);
+	}
+}
+
+static arm_status rfft_q15_plan(arm_rfft_instance_q15 * instance, u32 n_samples){
+	int slot = plan_slot(n_samples);
+	if( load_plan(m_rfft_q15_plans, slot, instance) ){ return ARM_MATH_SUCCESS; }
+	arm_status result = api::DspWorkObject::api_q15()->rfft_init(instance, n_samples, 0, 0);
+	if( result == ARM_MATH_SUCCESS ){ save_plan(m_rfft_q15_plans, slot, instance); }
+	return result;
+}
+
+static arm_status rfft_q31_plan(arm_rfft_instance_q31 * instance, u32 n_samples){
+	int slot = plan_slot(n_samples);
+	if( load_plan(m_rfft_q31_plans, slot, instance) ){ return ARM_MATH_SUCCESS; }
+	arm_status result = api::DspWorkObject::api_q31()->rfft_init(instance, n_samples, 0, 0);
+	if( result == ARM_MATH_SUCCESS ){ save_plan(m_rfft_q31_plans, slot, instance); }
+	return result;
+}
+
+static arm_status rfft_f32_plan(arm_rfft_fast_instance_f32 * instance, u32 n_samples){
+	int slot = plan_slot(n_samples);
+	if( load_plan(m_rfft_f32_plans, slot, instance) ){ return ARM_MATH_SUCCESS; }
+	arm_status result = api::DspWorkObject::api_f32()->rfft_fast_init(instance, n_samples);
+	if( result == ARM_MATH_SUCCESS ){ save_plan(m_rfft_f32_plans, slot, instance); }
+	return result;
+}
+
+//returns the number of frames an STFT call will compute or -1 if the arguments don't fit
+static int stft_frames(u32 n_samples, u32 input_count, u32 window_count, u32 hop, u32 frames){
+	if( (hop == 0) || (n_samples == 0) || (window_count != n_samples) || (input_count < n_samples) ){
+		return -1;
+	}
+	u32 available = (input_count - n_samples) / hop + 1;
+	if( frames == 0 ){ return available; }
+	if( frames > available ){ return -1; }
+	return frames;
+}
+/*! \endcond */
+
 FftComplexQ15::FftComplexQ15(u32 n_samples){
 	//cfft is initialized using a hack - RFFT init will grab the data needed
 	if( api_q15().is_valid() && api_q15()->rfft_init ){
 		arm_rfft_instance_q15 rfft_instance;
-		if( api_q15()->rfft_init(&rfft_instance, n_samples, 0, 0) == ARM_MATH_SUCCESS){
+		if( rfft_q15_plan(&rfft_instance, n_samples) == ARM_MATH_SUCCESS){
 			memcpy(instance(), rfft_instance.pCfft, sizeof(*instance()));
 		} else {
 			set_error_number(EINVAL);
@@ -22,7 +99,7 @@ FftComplexQ31::FftComplexQ31(u32 n_samples){
 	//cfft is initialized using a hack - RFFT init will grab the data needed
 	if( api_q31().is_valid() && api_q31()->rfft_init ){
 		arm_rfft_instance_q31 rfft_instance;
-		if( api_q31()->rfft_init(&rfft_instance, n_samples, 0, 0) == ARM_MATH_SUCCESS){
+		if( rfft_q31_plan(&rfft_instance, n_samples) == ARM_MATH_SUCCESS){
 			memcpy(instance(), rfft_instance.pCfft, sizeof(*instance()));
 		} else {
 			set_error_number(EINVAL);
@@ -36,7 +113,7 @@ FftComplexF32::FftComplexF32(u32 n_samples){
 	//cfft is initialized using a hack - RFFT init will grab the data needed
 	if( api_f32().is_valid() && api_f32()->rfft_fast_init ){
 		arm_rfft_fast_instance_f32 rfft_instance;
-		if( api_f32()->rfft_fast_init(&rfft_instance, n_samples) == ARM_MATH_SUCCESS){
+		if( rfft_f32_plan(&rfft_instance, n_samples) == ARM_MATH_SUCCESS){
 			memcpy(instance(), &rfft_instance.Sint, sizeof(*instance()));
 		} else {
 			set_error_number(EINVAL);
@@ -48,7 +125,7 @@ FftComplexF32::FftComplexF32(u32 n_samples){
 
 FftRealQ15::FftRealQ15(u32 n_samples){
 	if( api_q15().is_valid() && api_q15()->rfft_init ){
-		if( api_q15()->rfft_init(instance(), n_samples, 0, 0) != ARM_MATH_SUCCESS){
+		if( rfft_q15_plan(instance(), n_samples) != ARM_MATH_SUCCESS){
 			set_error_number(EINVAL);
 		}
 	} else {
@@ -58,7 +135,7 @@ FftRealQ15::FftRealQ15(u32 n_samples){
 
 FftRealQ31::FftRealQ31(u32 n_samples){
 	if( api_q31().is_valid() && api_q31()->rfft_init ){
-		if( api_q31()->rfft_init(instance(), n_samples, 0, 0) != ARM_MATH_SUCCESS){
+		if( rfft_q31_plan(instance(), n_samples) != ARM_MATH_SUCCESS){
 			set_error_number(EINVAL);
 		}
 	} else {
@@ -68,10 +145,83 @@ FftRealQ31::FftRealQ31(u32 n_samples){
 
 FftRealF32::FftRealF32(u32 n_samples){
 	if( api_f32().is_valid() && api_f32()->rfft_fast_init ){
-		if( api_f32()->rfft_fast_init(instance(), n_samples) != ARM_MATH_SUCCESS){
+		if( rfft_f32_plan(instance(), n_samples) != ARM_MATH_SUCCESS){
 			set_error_number(EINVAL);
 		}
 	} else {
 		set_error_number(ENOENT);
 	}
 }
+
+int FftRealQ15::stft(const SignalQ15 & input, const SignalQ15 & window, u32 hop, u32 frames, SignalQ15 & output){
+	int result = stft_frames(samples(), input.count(), window.count(), hop, frames);
+	if( result < 0 ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+
+	m_frame.resize(samples());
+	output.resize(result * spectrum_size());
+	if( (m_frame.count() != samples()) || (output.count() != result * spectrum_size()) ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	//forward transform with the bins in natural order
+	u8 is_bit_reversal = instance()->bitReverseFlagR;
+	instance()->ifftFlagR = 0;
+	instance()->bitReverseFlagR = 1;
+	for(int i=0; i < result; i++){
+		api_q15()->mult((q15_t*)input.vector_data_const() + i*hop, (q15_t*)window.vector_data_const(), m_frame.vector_data(), samples());
+		api_q15()->rfft(instance(), m_frame.vector_data(), output.vector_data() + i*spectrum_size());
+	}
+	instance()->bitReverseFlagR = is_bit_reversal;
+	return result;
+}
+
+int FftRealQ31::stft(const SignalQ31 & input, const SignalQ31 & window, u32 hop, u32 frames, SignalQ31 & output){
+	int result = stft_frames(samples(), input.count(), window.count(), hop, frames);
+	if( result < 0 ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+
+	m_frame.resize(samples());
+	output.resize(result * spectrum_size());
+	if( (m_frame.count() != samples()) || (output.count() != result * spectrum_size()) ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	//forward transform with the bins in natural order
+	u8 is_bit_reversal = instance()->bitReverseFlagR;
+	instance()->ifftFlagR = 0;
+	instance()->bitReverseFlagR = 1;
+	for(int i=0; i < result; i++){
+		api_q31()->mult((q31_t*)input.vector_data_const() + i*hop, (q31_t*)window.vector_data_const(), m_frame.vector_data(), samples());
+		api_q31()->rfft(instance(), m_frame.vector_data(), output.vector_data() + i*spectrum_size());
+	}
+	instance()->bitReverseFlagR = is_bit_reversal;
+	return result;
+}
+
+int FftRealF32::stft(const SignalF32 & input, const SignalF32 & window, u32 hop, u32 frames, SignalF32 & output){
+	int result = stft_frames(samples(), input.count(), window.count(), hop, frames);
+	if( result < 0 ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+
+	m_frame.resize(samples());
+	output.resize(result * spectrum_size());
+	if( (m_frame.count() != samples()) || (output.count() != result * spectrum_size()) ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	for(int i=0; i < result; i++){
+		api_f32()->mult((float32_t*)input.vector_data_const() + i*hop, (float32_t*)window.vector_data_const(), m_frame.vector_data(), samples());
+		api_f32()->rfft_fast(instance(), m_frame.vector_data(), output.vector_data() + i*spectrum_size(), 0);
+	}
+	return result;
+}
@@ -3,6 +3,7 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <cstdlib>
 #include "var/Token.hpp"
 #include "fmt/Xml.hpp"
 
@@ -349,6 +350,13 @@ int Xml::write_element(const var::ConstString & name, const var::ConstString & d
 
 //find str in the current context and define a target context that defines str
 int Xml::find_context(const var::ConstString & str, const context_t & current, context_t & target) const{
+	if( m_index.count() ){
+		int result = find_indexed_context(str, current, target);
+		if( result != -2 ){
+			return result;
+		}
+	}
+
 	Tokenizer tokens(str, ".");
 	String s0;
 	String s1;
@@ -730,3 +738,543 @@ int Xml::find_attribute(String & key, String & value, context_t & target) const{
 }
 
 
+int Xml::build_index(){
+	return m_index.build(*this);
+}
+
+int Xml::find_indexed_context(const var::ConstString & str, const context_t & current, context_t & target) const {
+	int parent;
+	int entry;
+
+	if( current.cursor != 0 ){
+		//the index doesn't know about cursors -- scan instead
+		return -2;
+	}
+
+	if( (current.offset == 0) && (current.size == file_size) ){
+		parent = -1;
+	} else if( (parent = m_index.find_offset(current.offset)) < 0 ){
+		return -2;
+	}
+
+	entry = m_index.find(*this, str, parent);
+	if( entry < 0 ){
+		return -1;
+	}
+
+	const XmlIndex::entry_t & e = m_index.at(entry);
+	target.offset = e.offset;
+	target.size = e.size;
+	target.start_tag_size = e.start_tag_size;
+	target.end_tag_size = e.end_tag_size;
+	target.cursor = 0;
+	return 0;
+}
+
+XmlParser::XmlParser(u32 buffer_size){
+	m_handler = 0;
+	m_state = STATE_TEXT;
+	m_depth = 0;
+	m_tag_offset = 0;
+	m_tag_size = 0;
+	m_match_count = 0;
+	m_bracket_depth = 0;
+	m_attribute_count = 0;
+	m_quote = '"';
+	m_is_empty_element = false;
+	m_buffer.set_size(buffer_size ? buffer_size : 1);
+}
+
+int XmlParser::parse(const sys::File & file, XmlHandler & handler, u32 offset, u32 size){
+	u32 position = offset;
+	u32 end = size == 0xffffffff ? 0xffffffff : offset + size;
+	int result;
+
+	m_handler = &handler;
+	m_name.clear();
+	m_text.clear();
+	m_attributes.clear();
+	m_attribute_count = 0;
+	m_state = STATE_TEXT;
+	m_depth = 0;
+	m_tag_offset = offset;
+	m_tag_size = 0;
+	m_match_count = 0;
+	m_bracket_depth = 0;
+	m_is_empty_element = false;
+
+	while( position < end ){
+		u32 page_size = m_buffer.size();
+		if( end - position < page_size ){
+			page_size = end - position;
+		}
+
+		result = file.read(position, m_buffer.to_void(), page_size);
+		if( result < 0 ){
+			set_error_number(file.error_number());
+			return -1;
+		}
+
+		if( result == 0 ){
+			break;
+		}
+
+		const char * p = m_buffer.to_char();
+		for(int i=0; i < result; i++){
+			int handler_result = process(p[i], position + i);
+			if( handler_result != 0 ){
+				return handler_result;
+			}
+		}
+		position += result;
+	}
+
+	if( m_state == STATE_TEXT ){
+		return flush_text();
+	}
+
+	return 0;
+}
+
+static bool is_space(char c){
+	return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+int XmlParser::flush_text(){
+	int result = 0;
+	const char * p = m_text.cstring();
+	u32 i;
+	for(i=0; i < m_text.length(); i++){
+		if( !is_space(p[i]) ){
+			result = m_handler->cdata(*this, m_text.cstring());
+			break;
+		}
+	}
+	m_text.clear();
+	return result;
+}
+
+void XmlParser::add_attribute(){
+	m_attributes.append(m_attribute_name.cstring(), m_attribute_name.length() + 1);
+	m_attributes.append(m_attribute_value.cstring(), m_attribute_value.length() + 1);
+	m_attribute_count++;
+	m_attribute_name.clear();
+	m_attribute_value.clear();
+}
+
+int XmlParser::finish_start_tag(u32 position, bool is_empty){
+	int result;
+	const char * p;
+	u32 i;
+
+	m_tag_size = position - m_tag_offset + 1;
+	m_is_empty_element = is_empty;
+	m_state = STATE_TEXT;
+
+	result = m_handler->start_element(*this, m_name.cstring());
+
+	p = m_attributes.cstring();
+	for(i=0; (i < m_attribute_count) && (result == 0); i++){
+		const char * value = p + strlen(p) + 1;
+		result = m_handler->attribute(*this, p, value);
+		p = value + strlen(value) + 1;
+	}
+	m_attributes.clear();
+	m_attribute_count = 0;
+
+	if( result == 0 ){
+		if( is_empty ){
+			result = m_handler->end_element(*this, m_name.cstring());
+		} else {
+			m_depth++;
+		}
+	}
+
+	m_is_empty_element = false;
+	m_name.clear();
+	return result;
+}
+
+int XmlParser::finish_end_tag(u32 position){
+	int result;
+	m_tag_size = position - m_tag_offset + 1;
+	m_state = STATE_TEXT;
+	if( m_depth ){
+		m_depth--;
+	}
+	result = m_handler->end_element(*this, m_name.cstring());
+	m_name.clear();
+	return result;
+}
+
+int XmlParser::process(char c, u32 position){
+	switch(m_state){
+		case STATE_TEXT:
+			if( c == '<' ){
+				m_tag_offset = position;
+				m_state = STATE_TAG_OPEN;
+				return flush_text();
+			}
+			m_text << c;
+			return 0;
+
+		case STATE_TAG_OPEN:
+			if( c == '/' ){
+				m_state = STATE_END_NAME;
+			} else if( c == '?' ){
+				m_match_count = 0;
+				m_state = STATE_PROCESSING_INSTRUCTION;
+			} else if( c == '!' ){
+				m_name.clear();
+				m_state = STATE_MARKUP;
+			} else {
+				m_name << c;
+				m_state = STATE_START_NAME;
+			}
+			return 0;
+
+		case STATE_START_NAME:
+			if( is_space(c) ){
+				m_state = STATE_IN_TAG;
+			} else if( c == '>' ){
+				return finish_start_tag(position, false);
+			} else if( c == '/' ){
+				m_state = STATE_EMPTY_TAG_CLOSE;
+			} else {
+				m_name << c;
+			}
+			return 0;
+
+		case STATE_IN_TAG:
+			if( c == '>' ){
+				return finish_start_tag(position, false);
+			} else if( c == '/' ){
+				m_state = STATE_EMPTY_TAG_CLOSE;
+			} else if( !is_space(c) ){
+				m_attribute_name << c;
+				m_state = STATE_ATTRIBUTE_NAME;
+			}
+			return 0;
+
+		case STATE_ATTRIBUTE_NAME:
+			if( c == '=' ){
+				m_state = STATE_BEFORE_VALUE;
+			} else if( is_space(c) ){
+				m_state = STATE_AFTER_ATTRIBUTE_NAME;
+			} else if( (c == '>') || (c == '/') ){
+				add_attribute();
+				m_state = STATE_IN_TAG;
+				return process(c, position);
+			} else {
+				m_attribute_name << c;
+			}
+			return 0;
+
+		case STATE_AFTER_ATTRIBUTE_NAME:
+			if( c == '=' ){
+				m_state = STATE_BEFORE_VALUE;
+			} else if( !is_space(c) ){
+				//attribute without a value
+				add_attribute();
+				m_state = STATE_IN_TAG;
+				return process(c, position);
+			}
+			return 0;
+
+		case STATE_BEFORE_VALUE:
+			if( (c == '"') || (c == '\'') ){
+				m_quote = c;
+				m_state = STATE_QUOTED_VALUE;
+			} else if( !is_space(c) ){
+				m_attribute_value << c;
+				m_state = STATE_VALUE;
+			}
+			return 0;
+
+		case STATE_QUOTED_VALUE:
+			if( c == m_quote ){
+				add_attribute();
+				m_state = STATE_IN_TAG;
+			} else {
+				m_attribute_value << c;
+			}
+			return 0;
+
+		case STATE_VALUE:
+			if( is_space(c) || (c == '>') ){
+				add_attribute();
+				m_state = STATE_IN_TAG;
+				if( c == '>' ){
+					return process(c, position);
+				}
+			} else {
+				m_attribute_value << c;
+			}
+			return 0;
+
+		case STATE_EMPTY_TAG_CLOSE:
+			if( c == '>' ){
+				return finish_start_tag(position, true);
+			}
+			m_state = STATE_IN_TAG;
+			return process(c, position);
+
+		case STATE_END_NAME:
+			if( c == '>' ){
+				return finish_end_tag(position);
+			} else if( !is_space(c) ){
+				m_name << c;
+			}
+			return 0;
+
+		case STATE_PROCESSING_INSTRUCTION:
+			if( (c == '>') && m_match_count ){
+				m_state = STATE_TEXT;
+			}
+			m_match_count = (c == '?');
+			return 0;
+
+		case STATE_MARKUP:
+			//decide between a comment, a CDATA section and a declaration like <!DOCTYPE ...>
+			m_name << c;
+			if( strcmp(m_name.cstring(), "--") == 0 ){
+				m_match_count = 0;
+				m_state = STATE_COMMENT;
+				m_name.clear();
+			} else if( strcmp(m_name.cstring(), "[CDATA[") == 0 ){
+				m_match_count = 0;
+				m_state = STATE_CDATA;
+				m_name.clear();
+			} else if( (strncmp("--", m_name.cstring(), m_name.length()) != 0) &&
+						  (strncmp("[CDATA[", m_name.cstring(), m_name.length()) != 0) ){
+				m_name.clear();
+				m_bracket_depth = 0;
+				m_state = STATE_DECLARATION;
+				return process(c, position);
+			}
+			return 0;
+
+		case STATE_DECLARATION:
+			if( c == '[' ){
+				m_bracket_depth++;
+			} else if( (c == ']') && m_bracket_depth ){
+				m_bracket_depth--;
+			} else if( (c == '>') && (m_bracket_depth == 0) ){
+				m_state = STATE_TEXT;
+			}
+			return 0;
+
+		case STATE_COMMENT:
+			if( c == '-' ){
+				m_match_count++;
+			} else {
+				if( (c == '>') && (m_match_count >= 2) ){
+					m_state = STATE_TEXT;
+				}
+				m_match_count = 0;
+			}
+			return 0;
+
+		case STATE_CDATA:
+			if( c == ']' ){
+				m_match_count++;
+				return 0;
+			}
+
+			if( (c == '>') && (m_match_count >= 2) ){
+				//keep any extra ']' that were part of the data
+				while( m_match_count > 2 ){
+					m_text << ']';
+					m_match_count--;
+				}
+				m_match_count = 0;
+				m_state = STATE_TEXT;
+				return flush_text();
+			}
+
+			while( m_match_count ){
+				m_text << ']';
+				m_match_count--;
+			}
+			m_text << c;
+			return 0;
+	}
+
+	return 0;
+}
+
+u32 XmlIndex::calculate_hash(const char * name, u32 length){
+	//FNV-1a
+	u32 hash = 2166136261UL;
+	for(u32 i=0; i < length; i++){
+		hash ^= (u8)name[i];
+		hash *= 16777619UL;
+	}
+	return hash;
+}
+
+int XmlIndex::build(const sys::File & file){
+	XmlParser parser;
+	int result;
+	clear();
+	result = parser.parse(file, *this);
+	m_open.free();
+	if( result < 0 ){
+		m_entries.free();
+		return -1;
+	}
+	if( result > 0 ){
+		//an entry couldn't be stored
+		m_entries.free();
+		return -1;
+	}
+	return 0;
+}
+
+int XmlIndex::start_element(const XmlParser & parser, const var::ConstString & name){
+	entry_t entry;
+	u32 length = name.length();
+	entry.offset = parser.tag_offset();
+	entry.size = parser.tag_size();
+	entry.start_tag_size = parser.tag_size();
+	entry.end_tag_size = 0;
+	entry.name_hash = calculate_hash(name.cstring(), length);
+	entry.name_length = length;
+	entry.resd = 0;
+	if( m_entries.push_back(entry) < 0 ){
+		return 1;
+	}
+	if( parser.is_empty_element() == false ){
+		if( m_open.push_back(m_entries.count()-1) < 0 ){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int XmlIndex::end_element(const XmlParser & parser, const var::ConstString & name){
+	MCU_UNUSED_ARGUMENT(name);
+	if( parser.is_empty_element() ){
+		return 0;
+	}
+	if( m_open.count() ){
+		entry_t & entry = m_entries.at(m_open.at(m_open.count()-1));
+		entry.end_tag_size = parser.tag_size();
+		entry.size = parser.tag_offset() + parser.tag_size() - entry.offset;
+		m_open.pop_back();
+	}
+	return 0;
+}
+
+int XmlIndex::find_offset(u32 offset) const {
+	//entries are in document order so they are sorted by offset
+	u32 low = 0;
+	u32 high = m_entries.count();
+	while( low < high ){
+		u32 mid = (low + high) / 2;
+		if( m_entries.at(mid).offset < offset ){
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	if( (low < m_entries.count()) && (m_entries.at(low).offset == offset) ){
+		return low;
+	}
+	return -1;
+}
+
+u32 XmlIndex::next_outside(u32 entry) const {
+	//first entry that starts after the end of entry (skips all of its descendants)
+	u32 end_offset = m_entries.at(entry).offset + m_entries.at(entry).size;
+	u32 low = entry + 1;
+	u32 high = m_entries.count();
+	while( low < high ){
+		u32 mid = (low + high) / 2;
+		if( m_entries.at(mid).offset < end_offset ){
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return low;
+}
+
+bool XmlIndex::is_name_match(const sys::File & file, u32 entry, const char * name, u32 length, u32 hash) const {
+	const entry_t & e = m_entries.at(entry);
+	char buffer[32];
+	u32 offset = 0;
+	if( (e.name_hash != hash) || (e.name_length != length) ){
+		return false;
+	}
+	//confirm the hash match against the file (a piece at a time so long names don't need a large buffer)
+	while( offset < length ){
+		u32 page = length - offset;
+		if( page > sizeof(buffer) ){ page = sizeof(buffer); }
+		if( file.read(e.offset + 1 + offset, buffer, page) != (int)page ){
+			return false;
+		}
+		if( memcmp(buffer, name + offset, page) != 0 ){
+			return false;
+		}
+		offset += page;
+	}
+	return true;
+}
+
+int XmlIndex::find(const sys::File & file, const var::ConstString & path, int parent) const {
+	ConstTokenizer segments(path, ".");
+	u32 begin;
+	u32 end;
+	int found = parent;
+
+	if( parent < 0 ){
+		begin = 0;
+		end = m_entries.count();
+	} else {
+		begin = parent + 1;
+		end = next_outside(parent);
+	}
+
+	for(ConstTokenizer::Iterator it = segments.begin(); it != segments.end(); ++it){
+		TokenView segment = *it;
+		u32 length = segment.length();
+		u32 array_index = 0;
+		u32 j = 0;
+		u32 i;
+
+		//split name[n]
+		for(i=0; i < segment.length(); i++){
+			if( segment.at(i) == '[' ){
+				length = i;
+				array_index = atoi(segment.data() + i + 1);
+				break;
+			}
+		}
+
+		u32 hash = calculate_hash(segment.data(), length);
+		found = -1;
+		i = begin;
+		while( i < end ){
+			if( is_name_match(file, i, segment.data(), length, hash) ){
+				if( j == array_index ){
+					found = i;
+					break;
+				}
+				j++;
+				i = next_outside(i);
+			} else {
+				i++;
+			}
+		}
+
+		if( found < 0 ){
+			return -1;
+		}
+
+		begin = found + 1;
+		end = next_outside(found);
+	}
+
+	return found;
+}
@@ -2,11 +2,16 @@
 
 #include "../../include/hal/DisplayDevice.hpp"
 
+#include <cstring>
+#include <errno.h>
 #include "sys.hpp"
 
 namespace hal {
 
-DisplayDevice::DisplayDevice(){}
+DisplayDevice::DisplayDevice(){
+	m_refresh_mode = REFRESH_FULL;
+	m_is_shadow_valid = false;
+}
 
 /*! \brief Pure virtual function to initialize the LCD */
 int DisplayDevice::initialize(const var::ConstString & name){
@@ -84,9 +89,127 @@ int DisplayDevice::set_mode(enum mode value){
 
 void DisplayDevice::refresh() const {
 
-	//write the bitmap to the display
+	if( (m_refresh_mode == REFRESH_FULL) || (is_damage_tracking() == false) ){
+		//write the bitmap to the display
+		ioctl(I_DISPLAY_REFRESH);
+		return;
+	}
+
+	if( (m_refresh_mode == REFRESH_CHANGED) &&
+			((m_is_shadow_valid == false) || (m_shadow.size() != size())) ){
+		//the panel contents are unknown until the first full frame is written
+		ioctl(I_DISPLAY_REFRESH);
+		m_is_shadow_valid = false;
+
+		//full frames are written until the shadow can be allocated for the current bitmap size
+		if( (size() != 0) && ((m_shadow.size() == size()) || (m_shadow.allocate(size()) == 0)) ){
+			memcpy(m_shadow.data(), read_only_data(), m_shadow.size());
+			m_is_shadow_valid = true;
+		}
+		clear_damage();
+		return;
+	}
+
+	u32 count = damage_count();
+	for(u32 i=0; i < count; i++){
+		if( m_refresh_mode == REFRESH_CHANGED ){
+			refresh_changed_rows(damage_at(i).region());
+		} else {
+			refresh_window(damage_at(i).region());
+		}
+	}
+
+	if( count ){
+		//leave the window covering the whole display for the next full refresh
+		display_attr_t attr;
+		attr.o_flags = DISPLAY_FLAG_SET_WINDOW;
+		attr.window_x = 0;
+		attr.window_y = 0;
+		attr.window_width = width();
+		attr.window_height = height();
+		ioctl(I_DISPLAY_SETATTR, &attr);
+	}
+	clear_damage();
+}
+
+int DisplayDevice::refresh_window(const sg_region_t & region) const {
+	display_attr_t attr;
+
+	//windows are written one at a time
+	wait(chrono::MicroTime(100));
+
+	attr.o_flags = DISPLAY_FLAG_SET_WINDOW;
+	attr.window_x = region.point.x;
+	attr.window_y = region.point.y;
+	attr.window_width = region.area.width;
+	attr.window_height = region.area.height;
+	if( ioctl(I_DISPLAY_SETATTR, &attr) < 0 ){
+		return -1;
+	}
+	return ioctl(I_DISPLAY_REFRESH);
+}
+
+void DisplayDevice::refresh_changed_rows(sg_region_t region) const {
+	//compare whole memory words so the shadow never holds pixels that weren't written
+	sg_int_t pixels_per_word = sizeof(sg_bmap_data_t)*8 / bits_per_pixel();
+	sg_int_t x0 = region.point.x - (region.point.x % pixels_per_word);
+	sg_int_t x1 = region.point.x + region.area.width;
+	if( x1 % pixels_per_word ){ x1 += pixels_per_word - (x1 % pixels_per_word); }
+	if( x1 > width() ){ x1 = width(); }
+	region.point.x = x0;
+	region.area.width = x1 - x0;
+
+	const u8 * frame = (const u8*)read_only_data();
+	u8 * shadow = (u8*)m_shadow.data();
+	sg_int_t y_end = region.point.y + region.area.height;
+	sg_int_t run_start = -1;
+
+	for(sg_int_t y = region.point.y; y <= y_end; y++){
+		bool is_changed = false;
+		u32 offset = 0;
+		u32 length = 0;
+		if( y < y_end ){
+			offset = (const u8*)bmap_data(Point(x0, y)) - frame;
+			length = (const u8*)bmap_data(Point(x1 - 1, y)) - frame - offset + sizeof(sg_bmap_data_t);
+			is_changed = memcmp(frame + offset, shadow + offset, length) != 0;
+		}
+
+		if( is_changed ){
+			memcpy(shadow + offset, frame + offset, length);
+			if( run_start < 0 ){ run_start = y; }
+		} else if( run_start >= 0 ){
+			//write the run of changed rows that just ended
+			sg_region_t run = region;
+			run.point.y = run_start;
+			run.area.height = y - run_start;
+			refresh_window(run);
+			run_start = -1;
+		}
+	}
+}
+
+int DisplayDevice::set_refresh_mode(enum refresh_mode value){
+	m_refresh_mode = value;
+	m_is_shadow_valid = false;
+
+	if( value == REFRESH_FULL ){
+		m_shadow.free();
+		return set_damage_tracking(false);
+	}
+
+	if( value == REFRESH_CHANGED ){
+		//before initialize() the size isn't known so refresh() allocates the shadow
+		if( (size() != 0) && (m_shadow.allocate(size()) < 0) ){
+			m_refresh_mode = REFRESH_DAMAGED;
+			set_error_number(ENOMEM);
+			set_damage_tracking();
+			return -1;
+		}
+	} else {
+		m_shadow.free();
+	}
 
-	ioctl(I_DISPLAY_REFRESH);
+	return set_damage_tracking();
 }
 
 int DisplayDevice::enable() const {
@@ -99,6 +222,7 @@ void DisplayDevice::clear(){
 	if( ioctl(I_DISPLAY_CLEAR) < 0 ){
 		Data::clear();
 	}
+	add_damage(sgfx::Region(sgfx::Point(0,0), area()));
 }
 
 int DisplayDevice::disable() const {
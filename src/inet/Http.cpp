@@ -12,7 +12,7 @@ using namespace inet;
 Http::Http(Socket & socket) : m_socket(socket){
 }
 
-HttpClient::HttpClient(Socket & socket) : Http(socket){
+HttpClient::HttpClient(Socket & socket) : Http(socket), m_socket_buffer(socket){
 #if defined __link
 	m_transfer_size = 1024;
 #else
@@ -171,6 +171,7 @@ int HttpClient::send_string(const var::ConstString & str){
 
 
 int HttpClient::close_connection(){
+	m_socket_buffer.clear();
 	return socket().close();
 }
 
@@ -190,6 +191,7 @@ int HttpClient::connect_to_server(const var::ConstString & domain_name, u16 port
 	}
 
 	m_alive_domain.clear();
+	m_socket_buffer.clear();
 
 	var::Vector<SocketAddressInfo> address_list = address_info.fetch_node(domain_name);
 	if( address_list.count() > 0 ){
@@ -219,6 +221,15 @@ int HttpClient::build_header(const var::ConstString & method, const var::ConstSt
 	bool is_user_agent_present = false;
 	bool is_accept_present = false;
 	bool is_keep_alive_present = false;
+	u32 header_length;
+
+	//size the header up front so it is allocated at most once (and not at all when reused)
+	header_length = method.length() + path.length() + host.length() + 128;
+	for(u32 i = 0; i < header_request_pairs().count(); i++){
+		header_length += header_request_pairs().at(i).key().length() + header_request_pairs().at(i).value().length() + 4;
+	}
+	m_header.set_capacity(header_length);
+
 	m_header.clear();
 	m_header << method << " " << path << " HTTP/1.1\r\n";
 	m_header << "Host: " << host << "\r\n";
@@ -226,9 +237,7 @@ int HttpClient::build_header(const var::ConstString & method, const var::ConstSt
 	for(u32 i = 0; i < header_request_pairs().count(); i++){
 		String key = header_request_pairs().at(i).key();
 		if( key.is_empty() == false ){
-			String entry;
-			entry << key << ": " << header_request_pairs().at(i).value() << "\r\n";
-			m_header << entry;
+			m_header << key << ": " << header_request_pairs().at(i).value() << "\r\n";
 			key.to_lower();
 			if( key == "user-Agent" ){ is_user_agent_present = true; }
 			if( key == "accept" ){ is_accept_present = true; }
@@ -245,7 +254,9 @@ int HttpClient::build_header(const var::ConstString & method, const var::ConstSt
 	if( !is_accept_present ){ m_header << "Accept: */*\r\n"; }
 
 	if( length > 0 ){
-		m_header << "Content-Length: " << String().format(F32U, length) << "\r\n";
+		char length_string[16];
+		snprintf(length_string, sizeof(length_string), F32U, length);
+		m_header << "Content-Length: " << length_string << "\r\n";
 	}
 	m_header << "\r\n";
 
@@ -292,7 +303,7 @@ int HttpClient::listen_for_header(){
 	m_transfer_encoding = "";
 	socket().clear_error_number();
 	do {
-		line = socket().gets('\n');
+		line = m_socket_buffer.gets('\n');
 		if( line.length() > 2 ){
 
 			m_header << line;
@@ -349,12 +360,12 @@ int HttpClient::listen_for_data(const sys::File & file, const sys::ProgressCallb
 	if( m_transfer_encoding == "CHUNKED" ){
 		u32 bytes_incoming = 0;
 		do {
-			String line = socket().gets();
+			String line = m_socket_buffer.gets();
 			//convert line from hex
 			bytes_incoming = line.to_unsigned_long(16);
 
 			//read bytes_incoming from the socket and write it to the output file
-			if( file.write(socket(), bytes_incoming, bytes_incoming) != (int)bytes_incoming ){
+			if( file.write(m_socket_buffer, bytes_incoming, bytes_incoming) != (int)bytes_incoming ){
 				set_error_number(FAILED_TO_WRITE_INCOMING_DATA_TO_FILE);
 				return -1;
 			}
@@ -366,7 +377,7 @@ int HttpClient::listen_for_data(const sys::File & file, const sys::ProgressCallb
 	} else {
 		//read the response from the socket
 		if( m_content_length != 0 ){
-			int result = file.write(socket(), m_transfer_size, m_content_length, progress_callback);
+			int result = file.write(m_socket_buffer, m_transfer_size, m_content_length, progress_callback);
 			if( result != (int)m_content_length ){
 				return -1;
 			}
@@ -2,6 +2,7 @@
 
 
 #include <stdlib.h>
+#include <errno.h>
 
 #include "calc/Rle.hpp"
 #include "sys/File.hpp"
@@ -96,6 +97,130 @@ void Bitmap::initialize_members(){
 	m_bmap.pen.thickness = 1;
 	m_bmap.pen.o_flags = 0;
 	m_bmap.pen.color = 65535;
+	m_damage = 0;
+}
+
+int Bitmap::set_damage_tracking(bool value){
+	if( value ){
+		if( m_damage == 0 ){
+			m_damage = (damage_t*)malloc(sizeof(damage_t));
+			if( m_damage == 0 ){
+				set_error_number(ENOMEM);
+				return -1;
+			}
+			m_damage->count = 0;
+		}
+		damage_all();
+	} else if( m_damage ){
+		::free(m_damage);
+		m_damage = 0;
+	}
+	return 0;
+}
+
+Region Bitmap::damage_at(u32 i) const {
+	if( i < damage_count() ){
+		return Region(m_damage->region[i]);
+	}
+	return Region();
+}
+
+static bool is_damage_touching(const sg_region_t & a, const sg_region_t & b){
+	//regions that share an edge are merged too
+	return (a.point.x <= b.point.x + b.area.width) &&
+			(b.point.x <= a.point.x + a.area.width) &&
+			(a.point.y <= b.point.y + b.area.height) &&
+			(b.point.y <= a.point.y + a.area.height);
+}
+
+static sg_region_t merge_damage(const sg_region_t & a, const sg_region_t & b){
+	sg_region_t result;
+	sg_int_t x1 = a.point.x + a.area.width > b.point.x + b.area.width ? a.point.x + a.area.width : b.point.x + b.area.width;
+	sg_int_t y1 = a.point.y + a.area.height > b.point.y + b.area.height ? a.point.y + a.area.height : b.point.y + b.area.height;
+	result.point.x = a.point.x < b.point.x ? a.point.x : b.point.x;
+	result.point.y = a.point.y < b.point.y ? a.point.y : b.point.y;
+	result.area.width = x1 - result.point.x;
+	result.area.height = y1 - result.point.y;
+	return result;
+}
+
+Region Bitmap::damage_bounds() const {
+	if( damage_count() == 0 ){
+		return Region();
+	}
+	sg_region_t result = m_damage->region[0];
+	for(u32 i=1; i < m_damage->count; i++){
+		result = merge_damage(result, m_damage->region[i]);
+	}
+	return Region(result);
+}
+
+void Bitmap::add_damage(const Region & region) const {
+	sg_region_t damage;
+	s32 x0, y0, x1, y1;
+	u32 i;
+
+	if( m_damage == 0 ){ return; }
+
+	//clip to the bitmap
+	x0 = region.point().x() < 0 ? 0 : region.point().x();
+	y0 = region.point().y() < 0 ? 0 : region.point().y();
+	x1 = region.point().x() + region.area().width();
+	y1 = region.point().y() + region.area().height();
+	if( x1 > width() ){ x1 = width(); }
+	if( y1 > height() ){ y1 = height(); }
+	if( (x1 <= x0) || (y1 <= y0) ){ return; }
+
+	damage.point.x = x0;
+	damage.point.y = y0;
+	damage.area.width = x1 - x0;
+	damage.area.height = y1 - y0;
+
+	do {
+		//absorb every region that touches the new one (the new region grows so check again)
+		for(i=0; i < m_damage->count; i++){
+			if( is_damage_touching(damage, m_damage->region[i]) ){
+				damage = merge_damage(damage, m_damage->region[i]);
+				m_damage->region[i] = m_damage->region[--m_damage->count];
+				i = (u32)-1;
+			}
+		}
+
+		if( m_damage->count < DAMAGE_REGION_MAX ){
+			break;
+		}
+
+		//the list is full -- merge with the region that adds the least area
+		u32 best = 0;
+		u32 best_growth = (u32)-1;
+		for(i=0; i < m_damage->count; i++){
+			sg_region_t merged = merge_damage(damage, m_damage->region[i]);
+			u32 growth = (u32)merged.area.width*merged.area.height -
+					(u32)m_damage->region[i].area.width*m_damage->region[i].area.height;
+			if( growth < best_growth ){
+				best = i;
+				best_growth = growth;
+			}
+		}
+		damage = merge_damage(damage, m_damage->region[best]);
+		m_damage->region[best] = m_damage->region[--m_damage->count];
+	} while( 1 );
+
+	m_damage->region[m_damage->count++] = damage;
+}
+
+void Bitmap::add_damage_points(const Point & p1, const Point & p2, const Point & p3, const Point & p4) const {
+	sg_int_t x0 = p1.x(), x1 = p1.x(), y0 = p1.y(), y1 = p1.y();
+	const Point * points[3] = { &p2, &p3, &p4 };
+	for(u32 i=0; i < 3; i++){
+		if( points[i]->x() < x0 ){ x0 = points[i]->x(); }
+		if( points[i]->x() > x1 ){ x1 = points[i]->x(); }
+		if( points[i]->y() < y0 ){ y0 = points[i]->y(); }
+		if( points[i]->y() > y1 ){ y1 = points[i]->y(); }
+	}
+	//the pen thickness can extend past the points
+	sg_int_t t = m_bmap.pen.thickness;
+	add_damage(Region(Point(x0 - t, y0 - t), Area(x1 - x0 + 2*t + 1, y1 - y0 + 2*t + 1)));
 }
 
 void Bitmap::set_data(sg_bmap_data_t * mem, sg_size_t w, sg_size_t h, bool readonly){
@@ -172,6 +297,7 @@ Bitmap::Bitmap(const Area & area, u8 bits_per_pixel){
 
 Bitmap::~Bitmap(){
 	free();
+	set_damage_tracking(false);
 }
 
 Point Bitmap::center() const{
@@ -233,6 +359,7 @@ int Bitmap::load(const var::ConstString & path){
 		return -1;
 	}
 
+	damage_all();
 	return 0;
 }
 
@@ -288,9 +415,114 @@ int Bitmap::save(const var::ConstString & path) const{
 	return 0;
 }
 
+/*
+ * The scans below read the bitmap one memory word at a time. Pixels
+ * that share a word with pixels outside of the span being scanned
+ * (at either end of a row) are read one at a time with get_pixel()
+ * so the scans don't depend on how pixels are ordered within a word.
+ *
+ */
+
+static sg_int_t pixels_per_word(u8 bits_per_pixel){
+	return sizeof(sg_bmap_data_t)*8 / bits_per_pixel;
+}
+
+static int count_bits(sg_bmap_data_t value){
+	return __builtin_popcountll((unsigned long long)value);
+}
+
+//selects bit 0 of every pixel in a word
+static sg_bmap_data_t first_plane(u8 bits_per_pixel){
+	sg_bmap_data_t plane = 0;
+	for(sg_int_t i=0; i < pixels_per_word(bits_per_pixel); i++){
+		plane |= (sg_bmap_data_t)1 << (i*bits_per_pixel);
+	}
+	return plane;
+}
+
+//a word's pixel values are summed one bit plane at a time
+static sg_color_t sum_word(sg_bmap_data_t word, sg_bmap_data_t plane, u8 bits_per_pixel){
+	sg_color_t color = 0;
+	for(u32 k=0; k < bits_per_pixel; k++){
+		color += (sg_color_t)count_bits(word & (plane << k)) << k;
+	}
+	return color;
+}
+
+bool Bitmap::clip_region(sg_region_t & region) const {
+	if( region.point.x < 0 ){
+		if( -region.point.x >= (sg_int_t)region.area.width ){ return false; }
+		region.area.width += region.point.x;
+		region.point.x = 0;
+	}
+	if( region.point.y < 0 ){
+		if( -region.point.y >= (sg_int_t)region.area.height ){ return false; }
+		region.area.height += region.point.y;
+		region.point.y = 0;
+	}
+	if( (region.point.x >= width()) || (region.point.y >= height()) ){
+		return false;
+	}
+	if( region.point.x + region.area.width > width() ){
+		region.area.width = width() - region.point.x;
+	}
+	if( region.point.y + region.area.height > height() ){
+		region.area.height = height() - region.point.y;
+	}
+	return (region.area.width > 0) && (region.area.height > 0);
+}
+
+sg_int_t Bitmap::find_pixel(sg_int_t y, sg_int_t x0, sg_int_t x1, bool is_reverse) const {
+	sg_int_t ppw = pixels_per_word(bits_per_pixel());
+	sg_int_t head = x0 + (ppw - x0 % ppw) % ppw;
+	sg_int_t tail = x1 - x1 % ppw;
+	const sg_bmap_data_t * words = 0;
+	sg_int_t count = 0;
+
+	if( head > x1 ){ head = x1; }
+	if( tail < head ){ tail = head; }
+	if( tail > head ){
+		words = bmap_data(Point(head, y));
+		count = (tail - head) / ppw;
+	}
+
+	if( is_reverse == false ){
+		for(sg_int_t x = x0; x < head; x++){
+			if( get_pixel(Point(x,y)) ){ return x; }
+		}
+		for(sg_int_t i = 0; i < count; i++){
+			if( words[i] ){
+				sg_int_t x = head + i*ppw;
+				for(sg_int_t j = 0; j < ppw; j++){
+					if( get_pixel(Point(x+j,y)) ){ return x+j; }
+				}
+			}
+		}
+		for(sg_int_t x = tail; x < x1; x++){
+			if( get_pixel(Point(x,y)) ){ return x; }
+		}
+	} else {
+		for(sg_int_t x = x1-1; x >= tail; x--){
+			if( get_pixel(Point(x,y)) ){ return x; }
+		}
+		for(sg_int_t i = count-1; i >= 0; i--){
+			if( words[i] ){
+				sg_int_t x = head + i*ppw;
+				for(sg_int_t j = ppw-1; j >= 0; j--){
+					if( get_pixel(Point(x+j,y)) ){ return x+j; }
+				}
+			}
+		}
+		for(sg_int_t x = head-1; x >= x0; x--){
+			if( get_pixel(Point(x,y)) ){ return x; }
+		}
+	}
+
+	return -1;
+}
+
 Region Bitmap::calculate_active_region() const {
 	Region result;
-	sg_point_t point;
 	sg_point_t top_left;
 	sg_point_t bottom_right;
 
@@ -299,28 +531,19 @@ Region Bitmap::calculate_active_region() const {
 	bottom_right.x = 0;
 	bottom_right.y = 0;
 
-	for(point.y = 0; point.y < height(); point.y++){
-		for(point.x = 0; point.x < width(); point.x++){
-
-			if( get_pixel(point) ){
-
-				if( point.x < top_left.x ){
-					top_left.x = point.x;
-				}
-
-				if( point.x > bottom_right.x ){
-					bottom_right.x = point.x;
-				}
+	for(sg_int_t y = 0; y < height(); y++){
+		sg_int_t left = find_pixel(y, 0, width(), false);
+		if( left < 0 ){
+			continue;
+		}
 
-				if( point.y < top_left.y ){
-					top_left.y = point.y;
-				}
+		//the row has at least one pixel so the reverse search always finds one
+		sg_int_t right = find_pixel(y, left, width(), true);
 
-				if( point.y > bottom_right.y ){
-					bottom_right.y = point.y;
-				}
-			}
-		}
+		if( left < top_left.x ){ top_left.x = left; }
+		if( right > bottom_right.x ){ bottom_right.x = right; }
+		if( y < top_left.y ){ top_left.y = y; }
+		bottom_right.y = y;
 	}
 
 	result.set_region(top_left, bottom_right);
@@ -329,18 +552,16 @@ Region Bitmap::calculate_active_region() const {
 }
 
 bool Bitmap::is_empty(const Region & region) const {
-	Cursor x_cursor;
-	Cursor y_cursor;
-	y_cursor.set(*this, region.point());
-	for(u32 h = 0; h < region.area().height(); h++){
-		x_cursor = y_cursor;
-		for(u32 w = 0; w < region.area().width(); w++){
-			//get pixel increments the cursor
-			if( x_cursor.get_pixel() != 0 ){
-				return false;
-			}
+	sg_region_t bounds = region.region();
+
+	if( clip_region(bounds) == false ){
+		return true;
+	}
+
+	for(sg_int_t y = bounds.point.y; y < bounds.point.y + bounds.area.height; y++){
+		if( find_pixel(y, bounds.point.x, bounds.point.x + bounds.area.width, false) >= 0 ){
+			return false;
 		}
-		y_cursor.increment_y();
 	}
 	return true;
 }
@@ -354,22 +575,52 @@ void Bitmap::downsample_bitmap(const Bitmap & source, const Area & factor){
 	if( factor.width() > source.width() ){ return; }
 	if( factor.height() > source.height() ){ return; }
 
+	sg_int_t ppw = pixels_per_word(source.bits_per_pixel());
+	sg_bmap_data_t plane = first_plane(source.bits_per_pixel());
+	u32 columns = (source.width() - factor.width()/2) / factor.width() + 1;
+	var::Data sums(columns * sizeof(sg_color_t));
 
-	Bitmap sample(factor);
+	if( sums.size() < columns * sizeof(sg_color_t) ){
+		set_error_number(ENOMEM);
+		return;
+	}
 
 	cursor_y.set(*this, Point(0,0));
 
 	for(sg_int_t y = 0; y <= source.height() - factor.height()/2; y+=factor.height()){
+		sg_int_t y_end = y + factor.height();
+		sg_color_t * sum = sums.to<sg_color_t>();
+
+		if( y_end > source.height() ){ y_end = source.height(); }
+		sums.fill(0);
+
+		//each row of the band is read once and each pixel is added to the sum of its cell
+		for(sg_int_t j = y; j < y_end; j++){
+			const sg_bmap_data_t * words = source.bmap_data(Point(0,j));
+			for(sg_int_t x = 0; x < source.width(); x += ppw){
+				sg_bmap_data_t word = words[x / ppw];
+				sg_int_t x_end = x + ppw;
+				u32 column = x / factor.width();
+
+				if( word == 0 ){ continue; }
+
+				if( (x_end <= source.width()) && ((u32)(x_end - 1) / factor.width() == column) ){
+					//the whole word is in one cell
+					if( column < columns ){ sum[column] += sum_word(word, plane, source.bits_per_pixel()); }
+				} else {
+					if( x_end > source.width() ){ x_end = source.width(); }
+					for(sg_int_t i = x; i < x_end; i++){
+						column = i / factor.width();
+						if( column < columns ){ sum[column] += source.get_pixel(Point(i,j)); }
+					}
+				}
+			}
+		}
 
 		cursor_x = cursor_y;
 
-		for(sg_int_t x = 0; x <= source.width() - factor.width()/2; x+=factor.width()){
-			Region region(Point(x,y), factor);
-			sample.clear();
-			sample.draw_sub_bitmap(Point(0,0), source, region);
-
-			u32 color = sample.calculate_color_sum();
-			if( color >= factor.calculate_area()/2 ){
+		for(u32 i=0; i < columns; i++){
+			if( sum[i] >= factor.calculate_area()/2 ){
 				bmap()->pen.color = 1;
 			} else {
 				bmap()->pen.color = 0;
@@ -381,24 +632,6 @@ void Bitmap::downsample_bitmap(const Bitmap & source, const Area & factor){
 		cursor_y.increment_y();
 	}
 
+	damage_all();
 }
 
-sg_color_t Bitmap::calculate_color_sum(){
-	sg_color_t color = 0;
-	Cursor cursor_y, cursor_x;
-	cursor_y.set(*this, Point(0,0));
-	for(sg_size_t y = 0; y < height(); y++){
-		cursor_x = cursor_y;
-		for(sg_size_t x = 0; x < width(); x++){
-			color += cursor_x.get_pixel();
-		}
-		cursor_y.increment_y();
-	}
-	return color;
-}
-
-
-
-
-
-
@@ -6,8 +6,7 @@
 namespace sgfx {
 
 Cursor::Cursor() {
-	// TODO Auto-generated constructor stub
-
+	m_bitmap = 0;
 }
 
 Cursor::~Cursor() {
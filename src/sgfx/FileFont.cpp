@@ -1,16 +1,24 @@
 //Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
 
 
+#include <cstdlib>
+#include <cstring>
 #include "sgfx/FileFont.hpp"
 using namespace sgfx;
 using namespace sys;
 
 FileFont::FileFont() {
 	m_kerning_pairs = 0;
+	m_glyph_cache_used = 0;
+	m_glyph_age = 0;
+	m_glyph_cache_size = GLYPH_CACHE_SIZE_DEFAULT;
 }
 
 FileFont::FileFont(const var::ConstString & name, int offset) {
 	m_kerning_pairs = 0;
+	m_glyph_cache_used = 0;
+	m_glyph_age = 0;
+	m_glyph_cache_size = GLYPH_CACHE_SIZE_DEFAULT;
 	set_file(name, offset);
 }
 
@@ -25,8 +33,12 @@ int FileFont::set_file(const var::ConstString & name, int offset){
 
 	if( m_kerning_pairs ){
 		free(m_kerning_pairs);
+		m_kerning_pairs = 0;
 	}
 
+	clear_glyph_cache();
+	m_characters.free();
+
 	//close if not already closed
 	m_file.close();
 
@@ -57,7 +69,21 @@ int FileFont::set_file(const var::ConstString & name, int offset){
 	m_kerning_pairs = (sg_font_kerning_pair_t*)malloc(pair_size);
 
 	if( m_kerning_pairs ){
-		m_file.read(m_offset + sizeof(sg_font_header_t), m_kerning_pairs, pair_size);
+		if( m_file.read(m_offset + sizeof(sg_font_header_t), m_kerning_pairs, pair_size) == (int)pair_size ){
+			//sorted so load_kerning() can use a binary search
+			qsort(m_kerning_pairs, m_header.kerning_pair_count, sizeof(sg_font_kerning_pair_t), compare_kerning_pairs);
+		} else {
+			free(m_kerning_pairs);
+			m_kerning_pairs = 0;
+		}
+	}
+
+	//the metrics table is small -- read it all at once rather than once per character
+	u32 character_size = sizeof(sg_font_char_t)*m_header.character_count;
+	if( m_characters.set_size(character_size) == 0 ){
+		if( m_file.read(m_offset + sizeof(sg_font_header_t) + pair_size, m_characters.to_void(), character_size) != (int)character_size ){
+			m_characters.free();
+		}
 	}
 
 	set_space_size(m_header.max_word_width);
@@ -69,6 +95,16 @@ int FileFont::set_file(const var::ConstString & name, int offset){
 sg_size_t FileFont::get_height() const { return m_header.max_height; }
 sg_size_t FileFont::get_width() const { return m_header.max_word_width*32; }
 
+void FileFont::set_glyph_cache_size(u32 value){
+	m_glyph_cache_size = value;
+	while( m_glyph_cache_used > m_glyph_cache_size ){
+		evict_glyph();
+	}
+	if( m_glyph_cache_size == 0 ){
+		clear_glyph_cache();
+	}
+}
+
 int FileFont::load_char(sg_font_char_t & ch, char c, bool ascii) const {
 	int offset;
 	int ind;
@@ -83,6 +119,14 @@ int FileFont::load_char(sg_font_char_t & ch, char c, bool ascii) const {
 		return -1;
 	}
 
+	if( m_characters.size() ){
+		if( (u32)ind >= m_header.character_count ){
+			return -1;
+		}
+		memcpy(&ch, m_characters.to_u8() + ind*sizeof(sg_font_char_t), sizeof(ch));
+		return 0;
+	}
+
 	offset = m_offset + sizeof(sg_font_header_t) + sizeof(sg_font_kerning_pair_t)*m_header.kerning_pair_count + ind*sizeof(sg_font_char_t);
 	if( (ret = m_file.read(offset, &ch, sizeof(ch))) != sizeof(ch) ){
 		return -1;
@@ -91,31 +135,195 @@ int FileFont::load_char(sg_font_char_t & ch, char c, bool ascii) const {
 	return 0;
 }
 
+int FileFont::compare_kerning_pairs(const void * a, const void * b){
+	const sg_font_kerning_pair_t * pair_a = (const sg_font_kerning_pair_t*)a;
+	const sg_font_kerning_pair_t * pair_b = (const sg_font_kerning_pair_t*)b;
+	if( pair_a->unicode_first != pair_b->unicode_first ){
+		return pair_a->unicode_first < pair_b->unicode_first ? -1 : 1;
+	}
+	if( pair_a->unicode_second != pair_b->unicode_second ){
+		return pair_a->unicode_second < pair_b->unicode_second ? -1 : 1;
+	}
+	return 0;
+}
+
 int FileFont::load_kerning(u16 first, u16 second) const {
-	int kerning_count = m_header.kerning_pair_count;
-	int i;
+	sg_font_kerning_pair_t key;
+	const sg_font_kerning_pair_t * pair;
 
 	if( m_kerning_pairs == 0 ){ return 0; }
 
-	for(i=0; i < kerning_count; i++){
-		if( (m_kerning_pairs[i].unicode_first == first) && (m_kerning_pairs[i].unicode_second == second) ){
-			return m_kerning_pairs[i].horizontal_kerning;
-		}
+	key.unicode_first = first;
+	key.unicode_second = second;
+	pair = (const sg_font_kerning_pair_t*)bsearch(&key, m_kerning_pairs, m_header.kerning_pair_count, sizeof(sg_font_kerning_pair_t), compare_kerning_pairs);
+	if( pair ){
+		return pair->horizontal_kerning;
 	}
 
 	return 0;
 }
 
-void FileFont::draw_char_on_bitmap(const sg_font_char_t & ch, Bitmap & dest, const Point & point) const {
+int FileFont::load_canvas(u8 canvas_idx) const {
 	u32 canvas_offset;
-	if( ch.canvas_idx != m_current_canvas ){
-		canvas_offset = m_canvas_start + ch.canvas_idx*m_canvas_size;
+	if( canvas_idx != m_current_canvas ){
+		canvas_offset = m_canvas_start + canvas_idx*m_canvas_size;
 
-		//need to read the character row by row
 		if( m_file.read(m_offset + canvas_offset, m_canvas.to_void(), m_canvas_size) != (int)m_canvas_size ){
-			return;
+			m_current_canvas = 255;
+			return -1;
 		}
-		m_current_canvas = ch.canvas_idx;
+		m_current_canvas = canvas_idx;
+	}
+	return 0;
+}
+
+const FileFont::Glyph * FileFont::find_glyph(const sg_font_char_t & ch) const {
+	u32 key = glyph_key(ch);
+	for(u32 i=0; i < m_glyphs.count(); i++){
+		if( m_glyphs.at(i).m_is_valid && (m_glyphs.at(i).m_key == key) ){
+			m_glyphs.at(i).m_age = ++m_glyph_age;
+			return &m_glyphs.at(i);
+		}
+	}
+	return 0;
+}
+
+void FileFont::evict_glyph() const {
+	u32 i;
+	u32 oldest = m_glyphs.count();
+	for(i=0; i < m_glyphs.count(); i++){
+		if( m_glyphs.at(i).m_is_valid ){
+			if( (oldest == m_glyphs.count()) || (m_glyphs.at(i).m_age < m_glyphs.at(oldest).m_age) ){
+				oldest = i;
+			}
+		}
+	}
+
+	if( oldest < m_glyphs.count() ){
+		Glyph & glyph = m_glyphs.at(oldest);
+		m_glyph_cache_used -= glyph.m_bitmap.calculate_size();
+		glyph.m_bitmap.free();
+		glyph.m_is_valid = false;
+	} else {
+		m_glyph_cache_used = 0;
+	}
+}
+
+const FileFont::Glyph * FileFont::add_glyph(const sg_font_char_t & ch) const {
+	u32 i;
+	Bitmap bitmap;
+	u32 need;
+
+	bitmap.set_bits_per_pixel(m_header.bits_per_pixel);
+	need = bitmap.calculate_size(Area(ch.width, ch.height));
+	if( (need == 0) || (need > m_glyph_cache_size) ){
+		return 0;
+	}
+
+	if( load_canvas(ch.canvas_idx) < 0 ){
+		return 0;
+	}
+
+	while( m_glyph_cache_used && (m_glyph_cache_used + need > m_glyph_cache_size) ){
+		evict_glyph();
+	}
+
+	//reuse an evicted entry if there is one
+	for(i=0; i < m_glyphs.count(); i++){
+		if( m_glyphs.at(i).m_is_valid == false ){
+			break;
+		}
+	}
+
+	if( i == m_glyphs.count() ){
+		if( m_glyphs.push_back(Glyph()) < 0 ){
+			return 0;
+		}
+	}
+
+	Glyph & glyph = m_glyphs.at(i);
+	glyph.m_bitmap.set_bits_per_pixel(m_header.bits_per_pixel);
+	if( glyph.m_bitmap.allocate(Area(ch.width, ch.height)) < 0 ){
+		return 0;
+	}
+	glyph.m_bitmap.clear();
+	glyph.m_bitmap.draw_sub_bitmap(Point(0,0), m_canvas, Region(Point(ch.canvas_x, ch.canvas_y), Area(ch.width, ch.height)));
+	glyph.m_key = glyph_key(ch);
+	glyph.m_age = ++m_glyph_age;
+	glyph.m_is_valid = true;
+	//charged the same size that was checked against the limit
+	m_glyph_cache_used += glyph.m_bitmap.calculate_size();
+
+	return &glyph;
+}
+
+void FileFont::clear_glyph_cache() const {
+	m_glyphs.free();
+	m_glyph_cache_used = 0;
+	m_glyph_age = 0;
+}
+
+int FileFont::preload(const var::ConstString & charset){
+	var::Vector<sg_font_char_t> pending;
+	sg_font_char_t ch;
+	u32 i;
+	int result = 0;
+
+	if( m_glyph_cache_size == 0 ){
+		return 0;
+	}
+
+	for(i=0; i < charset.length(); i++){
+		if( charset.at(i) == ' ' ){ continue; }
+		if( load_char(ch, charset.at(i), true) < 0 ){ continue; }
+		if( find_glyph(ch) ){ continue; }
+		pending.push_back(ch);
+	}
+
+	//start with the canvas that is already loaded then take each remaining canvas in order
+	while( pending.count() ){
+		u8 canvas_idx = pending.at(0).canvas_idx;
+		for(i=0; i < pending.count(); i++){
+			if( pending.at(i).canvas_idx == m_current_canvas ){
+				canvas_idx = m_current_canvas;
+				break;
+			}
+		}
+
+		for(i=0; i < pending.count();){
+			if( pending.at(i).canvas_idx == canvas_idx ){
+				//the same character may be in the charset more than once
+				if( find_glyph(pending.at(i)) == 0 && add_glyph(pending.at(i)) ){
+					result++;
+				}
+				pending.at(i) = pending.at(pending.count()-1);
+				pending.pop_back();
+			} else {
+				i++;
+			}
+		}
+	}
+
+	return result;
+}
+
+void FileFont::draw_char_on_bitmap(const sg_font_char_t & ch, Bitmap & dest, const Point & point) const {
+	const Glyph * glyph = 0;
+
+	if( m_glyph_cache_size ){
+		glyph = find_glyph(ch);
+		if( glyph == 0 ){
+			glyph = add_glyph(ch);
+		}
+	}
+
+	if( glyph ){
+		dest.draw_sub_bitmap(point, glyph->m_bitmap, Region(Point(0,0), Area(ch.width, ch.height)));
+		return;
+	}
+
+	if( load_canvas(ch.canvas_idx) < 0 ){
+		return;
 	}
 
 	Region region(Point(ch.canvas_x, ch.canvas_y), Area(ch.width, ch.height));
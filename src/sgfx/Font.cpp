@@ -89,9 +89,12 @@ Font::Font() {
 }
 
 int Font::calculate_length(const var::ConstString & str) const {
+	return calculate_length(str.cstring(), (u32)-1);
+}
+
+int Font::calculate_length(const char * s, u32 count) const {
 	u32 length = 0;
-	const char * s = str.cstring();
-	while( *s != 0 ){
+	while( count-- && (*s != 0) ){
 
 		if( *s == ' ' ){
 			length += space_size();
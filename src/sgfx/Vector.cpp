@@ -107,6 +107,7 @@ void VectorPath::scale(float scale){
 
 void Vector::draw(Bitmap & bitmap, VectorPath & path, const VectorMap & map){
 	api()->vector_draw_path(bitmap.bmap(), &path.path(), &map.map());
+	bitmap.add_damage(map.map().region);
 }
 
 sg_vector_path_description_t Vector::get_path_move(const Point & p){
@@ -0,0 +1,224 @@
+//Copyright 2011-2019 Tyler Gilbert; All Rights Reserved
+
+#include <cstring>
+#include <errno.h>
+#include "sm/EventStateMachine.hpp"
+#include "chrono/Clock.hpp"
+
+using namespace sm;
+
+EventEngine::EventEngine(u16 state_count, u16 event_count, u16 queue_size){
+	m_state = 0;
+	m_state_count = state_count;
+	m_event_count = event_count;
+	m_transition_limit = 0;
+	m_queue_size = queue_size;
+	m_queue_head = 0;
+	m_queue_count = 0;
+	m_overflow_count = 0;
+	m_transition_count = 0;
+	m_is_running = true;
+
+	//the lookup table uses u16 indices so the table size is limited
+	if( (u32)state_count * event_count >= NO_TRANSITION ){
+		set_error_number(EINVAL);
+		m_state_count = 0;
+		m_event_count = 0;
+	}
+
+	if( m_queue.allocate(queue_size * sizeof(u16)) < 0 ){
+		set_error_number(ENOMEM);
+		m_queue_size = 0;
+	}
+
+	m_sem.init(&m_sem_handle, 0, 0);
+}
+
+EventEngine::~EventEngine(){
+	m_sem.destroy();
+}
+
+int EventEngine::allocate_table(u16 transition_count){
+	u32 lookup_count = (u32)m_state_count * m_event_count;
+
+	if( (m_state_count == 0) || (transition_count >= NO_TRANSITION) ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+
+	//each transition also has an entry that points to the next transition with the same state and event
+	if( m_table.allocate((lookup_count + transition_count) * sizeof(u16)) < 0 ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	m_table.fill(0xff); //every entry is NO_TRANSITION
+	m_transition_limit = transition_count;
+	return 0;
+}
+
+int EventEngine::add_transition(u16 transition, u16 state, u16 event, u16 next_state){
+	u16 * entry;
+
+	if( (transition >= m_transition_limit) ||
+			(state >= m_state_count) ||
+			(event >= m_event_count) ||
+			(next_state >= m_state_count) ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+
+	//keep table order so the first matching guard wins
+	entry = lookup() + state * m_event_count + event;
+	while( *entry != NO_TRANSITION ){
+		entry = lookup() + m_state_count * m_event_count + *entry;
+	}
+	*entry = transition;
+	return 0;
+}
+
+int EventEngine::set_state(u16 state){
+	if( state >= m_state_count ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+	enter_state(state);
+	return 0;
+}
+
+int EventEngine::post(u16 event){
+	if( event >= m_event_count ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+
+	m_mutex.lock();
+	if( m_queue_count == m_queue_size ){
+		m_overflow_count++;
+		m_mutex.unlock();
+		set_error_number(ENOBUFS);
+		return -1;
+	}
+	queue()[(m_queue_head + m_queue_count) % m_queue_size] = event;
+	m_queue_count++;
+	m_mutex.unlock();
+
+	//the semaphore counts the pending events
+	return m_sem.post();
+}
+
+int EventEngine::pop_event(u16 * event){
+	m_mutex.lock();
+	if( m_queue_count == 0 ){
+		m_mutex.unlock();
+		return -1;
+	}
+	*event = queue()[m_queue_head];
+	m_queue_head = (m_queue_head + 1) % m_queue_size;
+	m_queue_count--;
+	m_mutex.unlock();
+	return 0;
+}
+
+int EventEngine::execute(){
+	u16 event;
+
+	//a stop() that comes before execute() is kept so this returns right away
+	while( m_is_running ){
+		//sleeps until an event is posted
+		if( m_sem.wait() < 0 ){
+			if( m_sem.error_number() == EINTR ){ continue; }
+			set_error_number(m_sem.error_number());
+			return -1;
+		}
+
+		//stop() posts without adding an event
+		if( pop_event(&event) == 0 ){
+			dispatch(event);
+		}
+	}
+
+	//allows execute() to be called again
+	m_is_running = true;
+	return 0;
+}
+
+int EventEngine::process_events(){
+	u16 event;
+	int count = 0;
+	u16 limit = m_queue_count;
+
+	//only the events already posted are dispatched so actions that post events can't keep this from returning
+	while( (count < limit) && (m_sem.try_wait() == 0) ){
+		if( pop_event(&event) == 0 ){
+			dispatch(event);
+			count++;
+		}
+	}
+	return count;
+}
+
+void EventEngine::stop(){
+	m_is_running = false;
+	m_sem.post();
+}
+
+void EventEngine::complete_transition(u16 next_state){
+	if( is_profiling_enabled() ){
+		profile_list()[m_state].event_count++;
+		m_transition_count++;
+	}
+	enter_state(next_state);
+}
+
+void EventEngine::ignore_event(){
+	if( is_profiling_enabled() ){
+		profile_list()[m_state].event_count++;
+		profile_list()[m_state].unhandled_count++;
+	}
+}
+
+void EventEngine::enter_state(u16 state){
+	if( is_profiling_enabled() ){
+		chrono::ClockTime now = chrono::Clock::get_time();
+		chrono::ClockTime duration = now - m_entry_time;
+		profile_list()[m_state].microseconds += (u64)duration.seconds() * 1000000UL + duration.nanoseconds() / 1000;
+		profile_list()[state].entry_count++;
+		m_entry_time = now;
+	}
+	m_state = state;
+}
+
+int EventEngine::set_profiling_enabled(bool value){
+	if( value == false ){
+		m_profile.free();
+		return 0;
+	}
+
+	if( m_profile.allocate(m_state_count * sizeof(sm_state_profile_t)) < 0 ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+	reset_profile();
+	return 0;
+}
+
+void EventEngine::reset_profile(){
+	m_profile.clear();
+	m_transition_count = 0;
+	m_entry_time = chrono::Clock::get_time();
+}
+
+sm_state_profile_t EventEngine::profile(u16 state) const {
+	sm_state_profile_t result;
+
+	memset(&result, 0, sizeof(result));
+	if( is_profiling_enabled() && (state < m_state_count) ){
+		result = profile_list()[state];
+		if( state == m_state ){
+			chrono::ClockTime duration = m_entry_time.age();
+			result.microseconds += (u64)duration.seconds() * 1000000UL + duration.nanoseconds() / 1000;
+		}
+	}
+	return result;
+}
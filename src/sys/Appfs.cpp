@@ -9,6 +9,7 @@
 #include "sys/Appfs.hpp"
 #include "sys/Dir.hpp"
 #include "sys/File.hpp"
+#include "sys/FileTransfer.hpp"
 
 using namespace sys;
 
@@ -31,18 +32,122 @@ void AppfsFileAttributes::apply(appfs_file_t * dest) const {
 }
 
 #if defined __link
-int Appfs::create(const var::ConstString & name, const sys::File & source_data, const var::ConstString & mount, const ProgressCallback * progress_callback, link_transport_mdriver_t * driver){
-	File file(driver);
+AppfsInstallFile::AppfsInstallFile(enum request request, link_transport_mdriver_t * driver) : File(driver){
 #else
-int Appfs::create(const var::ConstString & name, const sys::File & source_data, const var::ConstString & mount, const ProgressCallback * progress_callback){
-	File file;
+AppfsInstallFile::AppfsInstallFile(enum request request){
+#endif
+	m_request = request;
+	m_page_size = 0;
+	m_location = 0;
+	m_request_result = 0;
+}
+
+AppfsInstallFile::~AppfsInstallFile(){
+	//a file that wasn't closed explicitly is an aborted install
+	discard();
+}
+
+int AppfsInstallFile::open(const var::ConstString & name, int flags){
+	m_page_size = 0;
+	m_location = 0;
+	m_request_result = 0;
+	m_crc.start();
+	return File::open(name, flags);
+}
+
+int AppfsInstallFile::close(){
+	int result = 0;
+	if( fileno() < 0 ){
+		return 0;
+	}
+	if( flush() < 0 ){
+		result = -1;
+	}
+	if( File::close() < 0 ){
+		result = -1;
+	}
+	return result;
+}
+
+int AppfsInstallFile::discard(){
+	m_page_size = 0;
+	if( fileno() < 0 ){
+		return 0;
+	}
+	return File::close();
+}
+
+int AppfsInstallFile::write(const void * buf, int nbyte) const {
+	if( nbyte <= 0 ){
+		return 0;
+	}
+	if( copy(buf, nbyte) < 0 ){
+		return -1;
+	}
+	m_crc.update(buf, nbyte);
+	return nbyte;
+}
+
+int AppfsInstallFile::write_header(const void * header, u32 size) const {
+	return copy(header, size);
+}
+
+int AppfsInstallFile::flush() const {
+	return write_page();
+}
+
+int AppfsInstallFile::copy(const void * buf, u32 nbyte) const {
+	const u8 * data = (const u8*)buf;
+	while( nbyte ){
+		u32 page = APPFS_PAGE_SIZE - m_page_size;
+		if( page > nbyte ){ page = nbyte; }
+		memcpy(m_attr.buffer + m_page_size, data, page);
+		m_page_size += page;
+		data += page;
+		nbyte -= page;
+		if( (m_page_size == APPFS_PAGE_SIZE) && (write_page() < 0) ){
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int AppfsInstallFile::write_page() const {
+	if( m_page_size == 0 ){
+		return 0;
+	}
+
+	//the rest of the last page is left erased
+	memset(m_attr.buffer + m_page_size, 0xff, APPFS_PAGE_SIZE - m_page_size);
+
+	//location gets modified by the driver so it needs to be set for each page
+	u32 page_size = m_page_size;
+	m_attr.loc = m_location;
+	m_attr.nbyte = page_size;
+	m_page_size = 0;
+
+	m_request_result = ioctl(m_request == CREATE ? I_APPFS_CREATE : I_APPFS_INSTALL, &m_attr);
+	if( m_request_result < 0 ){
+		return -1;
+	}
+
+	m_location += page_size;
+	return 0;
+}
+
+#if defined __link
+int Appfs::create(const var::ConstString & name, const sys::File & source_data, const var::ConstString & mount, const ProgressCallback * progress_callback, link_transport_mdriver_t * driver, bool is_verify){
+	AppfsInstallFile file(AppfsInstallFile::CREATE, driver);
+	File installed_file(driver);
+#else
+int Appfs::create(const var::ConstString & name, const sys::File & source_data, const var::ConstString & mount, const ProgressCallback * progress_callback, bool is_verify){
+	AppfsInstallFile file(AppfsInstallFile::CREATE);
+	File installed_file;
 #endif
 	char buffer[LINK_PATH_MAX];
-	int tmp;
-	appfs_createattr_t attr;
-	int loc;
-	unsigned int bw; //bytes written
 	appfs_file_t f;
+	u32 size = source_data.size();
+	FileTransfer transfer;
 	strcpy(buffer, mount.cstring());
 	strcat(buffer, "/flash/");
 	strcat(buffer, name.str());
@@ -51,7 +156,7 @@ int Appfs::create(const var::ConstString & name, const sys::File & source_data,
 	//delete the settings if they exist
 	strncpy(f.hdr.name, name.str(), LINK_NAME_MAX);
 	f.hdr.mode = 0666;
-	f.exec.code_size = source_data.size() + sizeof(f); //total number of bytes in file
+	f.exec.code_size = size + sizeof(f); //total number of bytes in file
 	f.exec.signature = APPFS_CREATE_SIGNATURE;
 
 #if defined __link
@@ -61,46 +166,39 @@ int Appfs::create(const var::ConstString & name, const sys::File & source_data,
 #endif
 
 
-	if( file.open("/app/.install", File::WRONLY) < 0 ){
+	if( file.open() < 0 ){
 		return -1;
 	}
 
-	memcpy(attr.buffer, &f, sizeof(f));
-	//now copy some bytes
-	attr.nbyte = APPFS_PAGE_SIZE - sizeof(f);
-	if( source_data.size() < (u32)attr.nbyte ){
-		attr.nbyte = source_data.size();
+	//the header is copied into the first page
+	if( file.write_header(&f, sizeof(f)) < 0 ){
+		file.discard();
+		return -1;
 	}
 
-	source_data.read(attr.buffer + sizeof(f), attr.nbyte);
-	attr.nbyte += sizeof(f);
-	loc = 0;
-	bw = 0;
-	do {
-		if( loc != 0 ){ //when loc is 0 -- header is copied in
-			if( (f.exec.code_size - bw) > APPFS_PAGE_SIZE ){
-				attr.nbyte = APPFS_PAGE_SIZE;
-			} else {
-				attr.nbyte = f.exec.code_size - bw;
-			}
-			source_data.read(attr.buffer, attr.nbyte);
-		}
-
-		//location gets modified by the driver so it needs to be fixed on each loop
-		attr.loc = loc;
-
-		if( (tmp = file.ioctl(I_APPFS_CREATE, &attr)) < 0 ){
-			return tmp;
-		}
+	//the next chunk of the source is read while the current pages are written
+	transfer.set_chunk_size(APPFS_PAGE_SIZE, INSTALL_CHUNK_SIZE);
+	if( transfer.transfer(source_data, file, size, progress_callback) != (int)size ){
+		//don't send the partial page of an aborted transfer
+		file.discard();
+		return -1;
+	}
 
-		bw += attr.nbyte;
-		loc += attr.nbyte;
+	if( file.close() < 0 ){
+		return -1;
+	}
 
-		if( progress_callback ){
-			progress_callback->update(bw, f.exec.code_size);
+	if( is_verify ){
+		//one CRC of the data instead of comparing each page
+		calc::Crc crc;
+		if( (installed_file.open(buffer, File::RDONLY) < 0) ||
+				(installed_file.seek(sizeof(f)) < 0) ||
+				(crc.update(installed_file, size) != (int)size) ||
+				(crc.value() != file.crc()) ){
+			errno = EIO;
+			return -1;
 		}
-
-	} while( bw < f.exec.code_size);
+	}
 
 	return f.exec.code_size;
 }
@@ -1,6 +1,7 @@
 //Copyright 2011-2017 Tyler Gilbert; All Rights Reserved
 
 #include <limits.h>
+#include <cstdlib>
 
 #include "sys/Sys.hpp"
 #include "sys/Dir.hpp"
@@ -15,6 +16,7 @@ using namespace sgfx;
 
 var::Vector<sgfx::FontInfo> Assets::m_font_info_list;
 var::Vector<fmt::Svic> Assets::m_vector_path_list;
+var::Vector<Assets::icon_index_t> Assets::m_icon_index;
 bool Assets::m_is_initialized = false;
 
 int Assets::initialize(){
@@ -32,6 +34,7 @@ int Assets::initialize(){
 	find_icons_in_directory("/assets");
 	find_icons_in_directory("/home");
 	find_icons_in_directory("/home/assets");
+	build_icon_index();
 
 	m_is_initialized = true;
 	return 0;
@@ -65,13 +68,73 @@ void Assets::find_icons_in_directory(const var::ConstString & path){
 	}
 }
 
-sgfx::VectorPath Assets::find_vector_path(const var::ConstString & name){
-	initialize();
+u32 Assets::calculate_hash(const var::ConstString & name){
+	//FNV-1a
+	u32 hash = 2166136261UL;
+	const char * c = name.cstring();
+	while( *c ){
+		hash ^= (u8)*c++;
+		hash *= 16777619UL;
+	}
+	return hash;
+}
+
+int Assets::compare_icon_index(const void * a, const void * b){
+	const icon_index_t * entry_a = (const icon_index_t*)a;
+	const icon_index_t * entry_b = (const icon_index_t*)b;
+	if( entry_a->hash != entry_b->hash ){
+		return entry_a->hash < entry_b->hash ? -1 : 1;
+	}
+	//keep the file search order for duplicate names
+	if( entry_a->svic != entry_b->svic ){
+		return entry_a->svic < entry_b->svic ? -1 : 1;
+	}
+	return entry_a->icon < entry_b->icon ? -1 : (entry_a->icon > entry_b->icon);
+}
+
+void Assets::build_icon_index(){
+	u32 total = 0;
+	for(u32 i=0; i < m_vector_path_list.count(); i++){
+		total += m_vector_path_list.at(i).count();
+	}
+
+	m_icon_index.free();
+	m_icon_index.reserve(total);
 	for(u32 i=0; i < m_vector_path_list.count(); i++){
 		for(u32 j=0; j < m_vector_path_list.at(i).count(); j++){
-			if( m_vector_path_list.at(i).name_at(j) == name ){
-				return m_vector_path_list.at(i).at(j);
-			}
+			icon_index_t entry;
+			entry.hash = calculate_hash(m_vector_path_list.at(i).name_at(j));
+			entry.svic = i;
+			entry.icon = j;
+			m_icon_index.push_back(entry);
+		}
+	}
+
+	//sorted so find_vector_path() can use a binary search
+	qsort(m_icon_index.vector_data(), m_icon_index.count(), sizeof(icon_index_t), compare_icon_index);
+}
+
+sgfx::VectorPath Assets::find_vector_path(const var::ConstString & name){
+	initialize();
+	u32 hash = calculate_hash(name);
+	u32 low = 0;
+	u32 high = m_icon_index.count();
+
+	//find the first entry with a matching hash
+	while( low < high ){
+		u32 middle = (low + high) / 2;
+		if( m_icon_index.at(middle).hash < hash ){
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	for(u32 i=low; (i < m_icon_index.count()) && (m_icon_index.at(i).hash == hash); i++){
+		const icon_index_t & entry = m_icon_index.at(i);
+		const fmt::Svic & svic = m_vector_path_list.at(entry.svic);
+		if( svic.name_at(entry.icon) == name ){
+			return svic.at(entry.icon);
 		}
 	}
 	return sgfx::VectorPath();
@@ -8,6 +8,9 @@
 #include "sys/File.hpp"
 #include "sys/FileInfo.hpp"
 #include "sys/Dir.hpp"
+#if defined __link
+#include "sys/LinkBatch.hpp"
+#endif
 using namespace sys;
 
 
@@ -236,6 +239,95 @@ var::Vector<var::String> Dir::read_list(const var::ConstString & path){
 }
 
 
+static bool is_walk_entry(const var::String & entry){
+	return (entry != ".") && (entry != "..") && (entry.is_empty() == false);
+}
+
+static var::String join_path(const var::ConstString & path, const var::ConstString & entry){
+	var::String result;
+	result.set_capacity(path.length() + entry.length() + 1);
+	result << path;
+	if( (path.length() == 0) || (path.at(path.length()-1) != '/') ){
+		result << "/";
+	}
+	result << entry;
+	return result;
+}
+
+#if defined __link
+var::Vector<var::String> Dir::read_tree(const var::ConstString & path, link_transport_mdriver_t * driver){
+#else
+var::Vector<var::String> Dir::read_tree(const var::ConstString & path){
+#endif
+	var::Vector<var::String> result;
+	var::Vector<var::String> directories;
+
+#if defined __link
+	if( driver ){
+		//walk one level at a time so each level costs two batches
+		directories.push_back(var::String(path));
+		while( directories.count() ){
+			LinkBatch read_batch;
+			LinkBatch stat_batch;
+
+			for(u32 i=0; i < directories.count(); i++){
+				read_batch.add_read_dir(directories.at(i));
+			}
+			if( read_batch.execute(driver) < 0 ){
+				break;
+			}
+
+			for(u32 i=0; i < read_batch.count(); i++){
+				const var::Vector<var::String> & entries = read_batch.at(i).entries();
+				for(u32 j=0; j < entries.count(); j++){
+					if( is_walk_entry(entries.at(j)) ){
+						stat_batch.add_stat(join_path(read_batch.at(i).path(), entries.at(j)));
+					}
+				}
+			}
+			if( stat_batch.execute(driver) < 0 ){
+				break;
+			}
+
+			directories.clear();
+			for(u32 i=0; i < stat_batch.count(); i++){
+				result.push_back(stat_batch.at(i).path());
+				if( stat_batch.at(i).is_success() && stat_batch.at(i).is_directory() ){
+					directories.push_back(stat_batch.at(i).path());
+				}
+			}
+		}
+		return result;
+	}
+#endif
+
+	directories.push_back(var::String(path));
+	while( directories.count() ){
+		var::String directory = directories.at(directories.count()-1);
+		directories.pop_back();
+#if defined __link
+		var::Vector<var::String> entries = read_list(directory, driver);
+#else
+		var::Vector<var::String> entries = read_list(directory);
+#endif
+		for(u32 i=0; i < entries.count(); i++){
+			if( is_walk_entry(entries.at(i)) ){
+				var::String entry_path = join_path(directory, entries.at(i));
+#if defined __link
+				if( File::get_info(entry_path, driver).is_directory() ){
+#else
+				if( File::get_info(entry_path).is_directory() ){
+#endif
+					directories.push_back(entry_path);
+				}
+				result.push_back(entry_path);
+			}
+		}
+	}
+
+	return result;
+}
+
 var::Vector<var::String> Dir::read_list(){
 	var::Vector<var::String> result;
 	var::String entry;
@@ -3,6 +3,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <errno.h>
 #include <fcntl.h>
 
 #include "sys/File.hpp"
@@ -599,3 +600,225 @@ int NullFile::seek(int loc, int whence) const {
 
 }
 
+
+#if defined __link
+BufferedFile::BufferedFile(const File & file, u32 buffer_size) : File(file.driver()), m_file(file){
+#else
+BufferedFile::BufferedFile(const File & file, u32 buffer_size) : m_file(file){
+#endif
+	//share the fileno for fileno() and fstat() but never close it
+	set_fileno(file);
+	set_keep_open();
+	m_head = 0;
+	m_tail = 0;
+	set_buffer_size(buffer_size);
+}
+
+BufferedFile::~BufferedFile(){
+	discard();
+}
+
+int BufferedFile::set_buffer_size(u32 value){
+	discard();
+	if( value == 0 ){ value = 1; }
+	if( m_buffer.set_size(value) < 0 ){
+		set_error_number_to_errno();
+		return -1;
+	}
+	return 0;
+}
+
+int BufferedFile::open(const var::ConstString & name, int flags){
+	MCU_UNUSED_ARGUMENT(name);
+	MCU_UNUSED_ARGUMENT(flags);
+	set_error_number(EINVAL);
+	return -1;
+}
+
+int BufferedFile::close(){
+	discard();
+	return 0;
+}
+
+void BufferedFile::discard() const {
+	u32 unread = available();
+	m_head = 0;
+	m_tail = 0;
+	if( unread ){
+		//move the wrapped file back to the last byte that was consumed
+		m_file.seek(-1*(int)unread, CURRENT);
+	}
+}
+
+int BufferedFile::fill() const {
+	if( m_head == m_tail ){
+		m_head = 0;
+		m_tail = 0;
+	} else if( m_head > 0 ){
+		//move unread bytes to the front to make room
+		::memmove(m_buffer.to_u8(), m_buffer.to_u8() + m_head, available());
+		m_tail -= m_head;
+		m_head = 0;
+	}
+
+	if( m_tail == m_buffer.size() ){
+		return 0;
+	}
+
+	int result = m_file.read(m_buffer.to_u8() + m_tail, m_buffer.size() - m_tail);
+	if( result > 0 ){
+		m_tail += result;
+	} else if( result < 0 ){
+		set_error_number(m_file.error_number());
+	}
+	return result;
+}
+
+int BufferedFile::read(void * buf, int nbyte) const {
+	if( nbyte <= 0 ){ return 0; }
+
+	if( available() == 0 ){
+		if( (u32)nbyte >= m_buffer.size() ){
+			//large reads bypass the buffer
+			int result = m_file.read(buf, nbyte);
+			if( result < 0 ){
+				set_error_number(m_file.error_number());
+			}
+			return result;
+		}
+
+		int result = fill();
+		if( result <= 0 ){
+			return result;
+		}
+	}
+
+	int size_ready = available();
+	if( size_ready > nbyte ){
+		size_ready = nbyte;
+	}
+
+	::memcpy(buf, m_buffer.to_u8() + m_head, size_ready);
+	m_head += size_ready;
+	return size_ready;
+}
+
+int BufferedFile::write(const void * buf, int nbyte) const {
+	discard();
+	int result = m_file.write(buf, nbyte);
+	if( result < 0 ){
+		set_error_number(m_file.error_number());
+	}
+	return result;
+}
+
+int BufferedFile::seek(int loc, int whence) const {
+	discard();
+	int result = m_file.seek(loc, whence);
+	if( result < 0 ){
+		set_error_number(m_file.error_number());
+	}
+	return result;
+}
+
+int BufferedFile::peek(void * buf, int nbyte) const {
+	if( nbyte <= 0 ){ return 0; }
+	if( (u32)nbyte > m_buffer.size() ){
+		nbyte = m_buffer.size();
+	}
+
+	while( available() < (u32)nbyte ){
+		if( fill() <= 0 ){
+			break;
+		}
+	}
+
+	int size_ready = available();
+	if( size_ready > nbyte ){
+		size_ready = nbyte;
+	}
+
+	::memcpy(buf, m_buffer.to_u8() + m_head, size_ready);
+	return size_ready;
+}
+
+int BufferedFile::peek() const {
+	u8 c;
+	if( peek(&c, 1) == 1 ){
+		return c;
+	}
+	return -1;
+}
+
+var::String BufferedFile::gets(char term) const {
+	var::String ret;
+	gets(ret, term);
+	return ret;
+}
+
+char * BufferedFile::gets(var::String & s, char term) const {
+	s.clear();
+	u32 length = 0;
+	do {
+		if( available() == 0 ){
+			if( fill() <= 0 ){
+				return 0;
+			}
+		}
+
+		const char * start = m_buffer.to_char() + m_head;
+		const char * end = (const char*)::memchr(start, term, available());
+		u32 segment_size = end ? (end - start + 1) : available();
+
+		//copy the whole segment rather than one character at a time
+		if( s.set_capacity(length + segment_size) < 0 ){
+			return 0;
+		}
+		::memcpy(s.cdata() + length, start, segment_size);
+		length += segment_size;
+		s.cdata()[length] = 0;
+		m_head += segment_size;
+
+		if( end ){
+			return s.cdata();
+		}
+	} while( 1 );
+
+	return 0;
+}
+
+int BufferedFile::readline(char * buf, int nbyte, int timeout, char term) const {
+	int t = 0;
+	int bytes_recv = 0;
+	do {
+		if( available() == 0 ){
+			if( fill() <= 0 ){
+				t++;
+#if !defined __link
+				chrono::Timer::wait_milliseconds(1);
+#endif
+				continue;
+			}
+		}
+
+		const char * start = m_buffer.to_char() + m_head;
+		int segment_size = available();
+		if( segment_size > nbyte - bytes_recv ){
+			segment_size = nbyte - bytes_recv;
+		}
+		const char * end = (const char*)::memchr(start, term, segment_size);
+		if( end ){
+			segment_size = end - start + 1;
+		}
+
+		::memcpy(buf + bytes_recv, start, segment_size);
+		bytes_recv += segment_size;
+		m_head += segment_size;
+
+		if( end ){
+			return bytes_recv;
+		}
+	} while( (bytes_recv < nbyte) && (t < timeout) );
+
+	return bytes_recv;
+}
@@ -0,0 +1,261 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#include "sys/FileTransfer.hpp"
+#include "sys/Thread.hpp"
+#include "chrono/Timer.hpp"
+
+using namespace sys;
+
+//reader thread stack -- desktop pthreads reject stacks smaller than PTHREAD_STACK_MIN
+#if defined __link
+#define READER_STACK_SIZE (64*1024)
+#else
+#define READER_STACK_SIZE 2048
+#endif
+
+//how long the reader or writer sleeps while waiting on the other side of the window
+#define WINDOW_POLL_MICROSECONDS 200
+
+FileTransfer::FileTransfer(){
+	m_chunk_size_minimum = 256;
+	m_chunk_size_maximum = 16*1024;
+	m_window_depth_initial = 2;
+	m_window_depth_maximum = WINDOW_DEPTH_MAX;
+	m_target_round_trip = chrono::MicroTime::from_milliseconds(20);
+	m_source = 0;
+	m_size = 0;
+	m_head = 0;
+	m_tail = 0;
+	m_chunk_size = m_chunk_size_minimum;
+	m_window_depth = m_window_depth_initial;
+	m_is_read_complete = false;
+	m_is_abort = false;
+	m_stall_count = 0;
+}
+
+void FileTransfer::set_chunk_size(u32 minimum, u32 maximum){
+	if( minimum == 0 ){ minimum = 1; }
+	if( maximum < minimum ){ maximum = minimum; }
+	m_chunk_size_minimum = minimum;
+	m_chunk_size_maximum = maximum;
+}
+
+void FileTransfer::set_window_depth(u32 initial, u32 maximum){
+	if( maximum > WINDOW_DEPTH_MAX ){ maximum = WINDOW_DEPTH_MAX; }
+	if( maximum == 0 ){ maximum = 1; }
+	if( initial == 0 ){ initial = 1; }
+	if( initial > maximum ){ initial = maximum; }
+	m_window_depth_initial = initial;
+	m_window_depth_maximum = maximum;
+}
+
+bool FileTransfer::is_shared_driver(const File & source, const File & dest) const {
+#if defined __link
+	//a null driver means the file is on the host
+	return (source.driver() != 0) && (source.driver() == dest.driver());
+#else
+	MCU_UNUSED_ARGUMENT(source);
+	MCU_UNUSED_ARGUMENT(dest);
+	return false;
+#endif
+}
+
+u32 FileTransfer::pending_count(){
+	u32 result;
+	m_mutex.lock();
+	result = m_head - m_tail;
+	m_mutex.unlock();
+	return result;
+}
+
+void FileTransfer::adapt_chunk_size(){
+	u32 chunk_size = m_chunk_size;
+	if( m_round_trip.microseconds() < m_target_round_trip.microseconds()/2 ){
+		chunk_size = chunk_size * 2;
+		if( chunk_size > m_chunk_size_maximum ){
+			chunk_size = m_chunk_size_maximum;
+		}
+	} else if( m_round_trip > m_target_round_trip ){
+		chunk_size = chunk_size / 2;
+		if( chunk_size < m_chunk_size_minimum ){
+			chunk_size = m_chunk_size_minimum;
+		}
+	}
+	m_chunk_size = chunk_size;
+}
+
+void FileTransfer::read_source(){
+	u32 size_read = 0;
+	int result;
+
+	while( (m_is_abort == false) && (size_read < m_size) ){
+
+		//wait for a free slot in the window
+		if( pending_count() >= m_window_depth ){
+			chrono::wait_microseconds(WINDOW_POLL_MICROSECONDS);
+			continue;
+		}
+
+		u32 page_size = m_chunk_size;
+		if( m_size - size_read < page_size ){
+			page_size = m_size - size_read;
+		}
+
+		u32 slot = m_head % WINDOW_DEPTH_MAX;
+		result = m_source->read(m_window.to_u8() + slot*m_chunk_size_maximum, page_size);
+		m_slot_bytes[slot] = result;
+
+		m_mutex.lock();
+		m_head = m_head + 1;
+		m_mutex.unlock();
+
+		if( result <= 0 ){
+			break;
+		}
+		size_read += result;
+	}
+
+	m_is_read_complete = true;
+}
+
+int FileTransfer::transfer(const File & source, const File & dest, u32 size, const ProgressCallback * progress_callback){
+	u32 size_processed = 0;
+	int result = 0;
+	chrono::Timer timer;
+
+	m_chunk_size = m_chunk_size_minimum;
+	m_window_depth = m_window_depth_initial;
+	m_stall_count = 0;
+
+	if( is_shared_driver(source, dest) ){
+		return transfer_sequential(source, dest, size, progress_callback);
+	}
+
+	if( m_window.set_size(m_chunk_size_maximum * WINDOW_DEPTH_MAX) < 0 ){
+		set_error_number_to_errno();
+		return -1;
+	}
+
+	m_source = &source;
+	m_size = size;
+	m_head = 0;
+	m_tail = 0;
+	m_is_read_complete = false;
+	m_is_abort = false;
+
+	Thread reader(READER_STACK_SIZE, false);
+	if( reader.create(read_worker, this) < 0 ){
+		//no thread available -- still get the adaptive chunk size
+		return transfer_sequential(source, dest, size, progress_callback);
+	}
+
+	while( m_is_abort == false ){
+
+		if( pending_count() == 0 ){
+			if( m_is_read_complete && (pending_count() == 0) ){
+				break;
+			}
+			//the writer is starved -- read further ahead
+			m_stall_count++;
+			if( m_window_depth < m_window_depth_maximum ){
+				m_window_depth = m_window_depth + 1;
+			}
+			chrono::wait_microseconds(WINDOW_POLL_MICROSECONDS);
+			continue;
+		}
+
+		u32 slot = m_tail % WINDOW_DEPTH_MAX;
+		int page_size = m_slot_bytes[slot];
+		if( page_size <= 0 ){
+			result = page_size;
+			m_is_abort = true;
+		} else {
+			timer.restart();
+			result = dest.write(m_window.to_u8() + slot*m_chunk_size_maximum, page_size);
+			timer.stop();
+			m_round_trip = chrono::MicroTime(timer.microseconds());
+
+			if( result > 0 ){
+				size_processed += result;
+				adapt_chunk_size();
+			}
+
+			if( result != page_size ){
+				m_is_abort = true;
+			}
+		}
+
+		m_mutex.lock();
+		m_tail = m_tail + 1;
+		m_mutex.unlock();
+
+		if( progress_callback ){
+			//abort the transaction
+			if( progress_callback->update(size_processed, size) == true ){
+				m_is_abort = true;
+			}
+		}
+
+	}
+
+	m_is_abort = true;
+	reader.join();
+
+	//this will terminate the progress operation
+	if( progress_callback ){ progress_callback->update(0,0); }
+
+	if( (size_processed == 0) && (result < 0) ){
+		return result;
+	}
+
+	return size_processed;
+}
+
+int FileTransfer::transfer_sequential(const File & source, const File & dest, u32 size, const ProgressCallback * progress_callback){
+	u32 size_processed = 0;
+	int result;
+	chrono::Timer timer;
+
+	if( m_window.set_size(m_chunk_size_maximum) < 0 ){
+		set_error_number_to_errno();
+		return -1;
+	}
+
+	m_window_depth = 1;
+
+	do {
+		u32 page_size = m_chunk_size;
+		if( size - size_processed < page_size ){
+			page_size = size - size_processed;
+		}
+
+		result = source.read(m_window.to_void(), page_size);
+		if( result > 0 ){
+			timer.restart();
+			result = dest.write(m_window.to_void(), result);
+			timer.stop();
+			m_round_trip = chrono::MicroTime(timer.microseconds());
+			if( result > 0 ){
+				size_processed += result;
+				adapt_chunk_size();
+			}
+		}
+
+		if( progress_callback ){
+			//abort the transaction
+			if( progress_callback->update(size_processed, size) == true ){
+				break;
+			}
+		}
+
+	} while( (result > 0) && (size > size_processed) );
+
+	//this will terminate the progress operation
+	if( progress_callback ){ progress_callback->update(0,0); }
+
+	if( (size_processed == 0) && (result < 0) ){
+		return result;
+	}
+
+	return size_processed;
+}
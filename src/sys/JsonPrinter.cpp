@@ -1,6 +1,7 @@
 /*! \file */ //Copyright 2011-2017 Tyler Gilbert; All Rights Reserved
 
-
+#include <cstring>
+#include <errno.h>
 #include "sys/JsonPrinter.hpp"
 
 using namespace var;
@@ -8,150 +9,363 @@ using namespace var;
 namespace sys {
 
 JsonPrinter::JsonPrinter(bool is_object) {
-	// TODO Auto-generated constructor stub
+	m_file = 0;
+	m_is_object = is_object;
+	start();
+}
 
-	m_is_first = true;
+JsonPrinter::JsonPrinter(const File & file, bool is_object) : m_buffer(BUFFER_SIZE) {
+	m_file = &file;
 	m_is_object = is_object;
+	if( m_buffer.size() != BUFFER_SIZE ){
+		set_error_number(ENOMEM);
+	}
+	start();
+}
 
-	if( is_object ){
-		append("\n{");
-	} else {
-		append("\n[");
+JsonPrinter::~JsonPrinter(){
+	flush();
+}
+
+void JsonPrinter::start(){
+	m_buffer_size = 0;
+	m_length = 0;
+	m_depth = 1;
+	m_indent = 0;
+	m_is_first = true;
+	write(m_is_object ? "{" : "[", 1);
+}
+
+int JsonPrinter::flush(){
+	int result;
+
+	if( m_file == 0 ){ return 0; }
+
+	result = write_output(m_buffer.to_u8(), m_buffer_size);
+	m_buffer_size = 0;
+	return result;
+}
+
+int JsonPrinter::write_output(const void * data, u32 size){
+	u32 offset = 0;
+	int result;
+
+	//sockets may accept less than the whole buffer
+	while( offset < size ){
+		result = m_file->write((const u8*)data + offset, size - offset);
+		if( result <= 0 ){
+			set_error_number(m_file->error_number());
+			return -1;
+		}
+		offset += result;
+	}
+	return 0;
+}
+
+void JsonPrinter::write(const char * data, u32 size){
+	if( m_file == 0 ){
+		//the length is tracked so each write doesn't have to find the end of the string
+		if( set_capacity(m_length + size) < 0 ){ return; }
+		memcpy(to_char() + m_length, data, size);
+		m_length += size;
+		to_char()[m_length] = 0;
+		return;
 	}
 
+	if( m_buffer_size + size > m_buffer.size() ){
+		if( flush() < 0 ){ return; }
+		if( size > m_buffer.size() ){
+			//too big to buffer
+			write_output(data, size);
+			return;
+		}
+	}
+
+	memcpy(m_buffer.to_u8() + m_buffer_size, data, size);
+	m_buffer_size += size;
 }
 
-void JsonPrinter::end(){
-	if( m_is_object ){
-		append("}\n");
-	} else {
-		append("]\n");
+void JsonPrinter::write_string(const ConstString & value){
+	static const char hex[] = "0123456789abcdef";
+	const char * str = value.cstring();
+	u32 length = value.length();
+	u32 start = 0;
+
+	write("\"", 1);
+	for(u32 i=0; i < length; i++){
+		u8 c = str[i];
+		if( (c >= 0x20) && (c != '"') && (c != '\\') ){
+			continue;
+		}
+
+		//write the characters that don't need escaping in one step
+		write(str + start, i - start);
+		start = i + 1;
+
+		char escape[6] = { '\\', (char)c, 0, 0, 0, 0 };
+		u32 escape_length = 2;
+		switch(c){
+			case '"':
+			case '\\': break;
+			case '\b': escape[1] = 'b'; break;
+			case '\f': escape[1] = 'f'; break;
+			case '\n': escape[1] = 'n'; break;
+			case '\r': escape[1] = 'r'; break;
+			case '\t': escape[1] = 't'; break;
+			default:
+				escape[1] = 'u';
+				escape[2] = '0';
+				escape[3] = '0';
+				escape[4] = hex[c >> 4];
+				escape[5] = hex[c & 0x0f];
+				escape_length = 6;
+				break;
+		}
+		write(escape, escape_length);
+	}
+	write(str + start, length - start);
+	write("\"", 1);
+}
+
+void JsonPrinter::write_newline(){
+	static const char spaces[] = "                ";
+	u32 count = m_depth * m_indent;
+
+	if( m_indent == 0 ){ return; }
+
+	write("\n", 1);
+	while( count ){
+		u32 page = count < sizeof(spaces)-1 ? count : sizeof(spaces)-1;
+		write(spaces, page);
+		count -= page;
 	}
 }
 
-void JsonPrinter::append_separator(){
+void JsonPrinter::write_integer(int number){
+	char buffer[12];
+	u32 i = sizeof(buffer);
+	//the magnitude is unsigned so the most negative value is converted correctly
+	u32 magnitude = number < 0 ? 0U - (u32)number : (u32)number;
+
+	do {
+		buffer[--i] = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while( magnitude );
+
+	if( number < 0 ){
+		buffer[--i] = '-';
+	}
+	write(buffer + i, sizeof(buffer) - i);
+}
+
+void JsonPrinter::write_float(float number){
+	char buffer[24];
+	u32 length = 0;
+	double value = number;
+	int exponent = 0;
+	bool is_scientific;
+	u32 integer;
+	u32 fraction;
+
+	if( value != value ){
+		//JSON can't represent NaN or infinity
+		write("null", 4);
+		return;
+	}
+
+	if( value < 0 ){
+		buffer[length++] = '-';
+		value = -value;
+	}
+
+	if( value > 3.5e38 ){
+		write("null", 4);
+		return;
+	}
+
+	//small and large values use an exponent; others are written with up to 6 decimal places
+	is_scientific = (value >= 1e9) || ((value != 0) && (value < 1e-5));
+	if( is_scientific ){
+		while( value >= 10.0 ){ value /= 10.0; exponent++; }
+		while( value < 1.0 ){ value *= 10.0; exponent--; }
+	}
+
+	integer = (u32)value;
+	fraction = (u32)((value - integer) * 1000000.0 + 0.5);
+	if( fraction >= 1000000 ){
+		integer++;
+		fraction -= 1000000;
+		if( is_scientific && (integer == 10) ){
+			integer = 1;
+			exponent++;
+		}
+	}
+
+	char digits[10];
+	u32 i = sizeof(digits);
+	do {
+		digits[--i] = '0' + integer % 10;
+		integer /= 10;
+	} while( integer );
+	memcpy(buffer + length, digits + i, sizeof(digits) - i);
+	length += sizeof(digits) - i;
+
+	if( fraction ){
+		u32 places = 6;
+		while( fraction % 10 == 0 ){
+			fraction /= 10;
+			places--;
+		}
+		buffer[length++] = '.';
+		for(i = places; i > 0; i--){
+			buffer[length + i - 1] = '0' + fraction % 10;
+			fraction /= 10;
+		}
+		length += places;
+	}
+
+	if( is_scientific ){
+		buffer[length++] = 'e';
+		if( exponent < 0 ){
+			buffer[length++] = '-';
+			exponent = -exponent;
+		}
+		if( exponent >= 10 ){
+			buffer[length++] = '0' + exponent / 10;
+		}
+		buffer[length++] = '0' + exponent % 10;
+	}
+
+	write(buffer, length);
+}
+
+void JsonPrinter::end(){
+	//the top level value is at depth one
+	m_depth = 1;
+	close_container(m_is_object ? '}' : ']');
+	if( m_indent ){ write("\n", 1); }
+	flush();
+}
+
+void JsonPrinter::append_separator(const ConstString * key){
 	if( m_is_first ){
 		m_is_first = false;
 	} else {
-		append(",");
+		write(",", 1);
+	}
+
+	write_newline();
+	if( key ){
+		write_string(*key);
+		if( m_indent ){
+			write(": ", 2);
+		} else {
+			write(":", 1);
+		}
 	}
 }
 
-void JsonPrinter::append_object(const ConstString & key){
-	String str;
-	str.sprintf("\"%s\": {", key.str());
-	append_separator();
-	append(str.str());
+void JsonPrinter::open_container(const ConstString * key, char bracket){
+	append_separator(key);
+	write(&bracket, 1);
+	m_depth++;
 	m_is_first = true;
 }
 
+void JsonPrinter::close_container(char bracket){
+	if( m_depth ){ m_depth--; }
+	if( m_is_first == false ){
+		//empty containers are printed as {} or []
+		write_newline();
+	}
+	write(&bracket, 1);
+	m_is_first = false;
+}
+
+void JsonPrinter::append_object(const ConstString & key){
+	open_container(&key, '{');
+}
+
 void JsonPrinter::append_array(const ConstString & key){
-	String str;
-	str.sprintf("\"%s\": [", key.str());
-	append_separator();
-	append(str.str());
-	m_is_first = true;
+	open_container(&key, '[');
 }
 
 void JsonPrinter::end_object(){
-	append("}");
+	close_container('}');
 }
 
 void JsonPrinter::end_array(){
-	append("]");
+	close_container(']');
 }
 
 void JsonPrinter::append_string(const ConstString & key, const ConstString & value){
-	String str;
-	str.sprintf("\"%s\": \"%s\"", key.str(), value.str());
-	append_separator();
-	append(str.str());
+	append_separator(&key);
+	write_string(value);
 }
 
 void JsonPrinter::append_number(const ConstString & key, int number){
-	String str;
-	str.sprintf("\"%s\": \"%d\"", key.str(), number);
-	append_separator();
-	append(str.str());
+	append_separator(&key);
+	write_integer(number);
 }
 
 void JsonPrinter::append_float(const ConstString & key, float number){
-	String str;
-	str.sprintf("\"%s\": \"%f\"", key.str(), number);
-	append_separator();
-	append(str.str());
+	append_separator(&key);
+	write_float(number);
 }
 
 
 void JsonPrinter::append_true(const ConstString & key){
-	String str;
-	str.sprintf("\"%s\":true", key.str());
-	append_separator();
-	append(str.str());
+	append_separator(&key);
+	write("true", 4);
 }
 
 void JsonPrinter::append_false(const ConstString & key){
-	String str;
-	str.sprintf("\"%s\":false", key.str());
-	append_separator();
-	append(str.str());
+	append_separator(&key);
+	write("false", 5);
 }
 
 void JsonPrinter::append_null(const ConstString & key){
-	String str;
-	str.sprintf("\"%s\": null", key.str());
-	append_separator();
-	append(str.str());
+	append_separator(&key);
+	write("null", 4);
 }
 
 void JsonPrinter::append_object(){
-	append_separator();
-	append("{");
-	m_is_first = true;
+	open_container(0, '{');
 }
 
 void JsonPrinter::append_array(){
-	append_separator();
-	append("[");
-	m_is_first = true;
+	open_container(0, '[');
 }
 
 void JsonPrinter::append_string(const ConstString & value){
 	append_separator();
-	append("\"");
-	append(value);
-	append("\"");
+	write_string(value);
 }
 
 void JsonPrinter::append_number(int number){
-	String str;
-	str.sprintf("\"%d\"", number);
 	append_separator();
-	append(str.str());
+	write_integer(number);
 }
 
 void JsonPrinter::append_float(float number){
-	String str;
-	str.sprintf("\"%f\"", number);
 	append_separator();
-	append(str.str());
+	write_float(number);
 }
 
 
 void JsonPrinter::append_true(){
 	append_separator();
-	append("true");
+	write("true", 4);
 }
 
 void JsonPrinter::append_false(){
 	append_separator();
-	append(", false");
-
+	write("false", 5);
 }
 
 void JsonPrinter::append_null(){
 	append_separator();
-	append(", null");
+	write("null", 4);
 }
 
 
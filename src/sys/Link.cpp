@@ -13,6 +13,7 @@
 #include "sys/File.hpp"
 #include "sys/Link.hpp"
 #include "sys/Appfs.hpp"
+#include "sys/FileTransfer.hpp"
 #include "chrono/Timer.hpp"
 
 using namespace sys;
@@ -527,31 +528,41 @@ int Link::rmdir(const var::ConstString & directory){
 }
 
 var::Vector<var::String> Link::get_dir_list(const var::ConstString & directory){
-
-	var::Vector<var::String> list;
-	int dirp;
-	struct link_dirent entry;
-	struct link_dirent * result;
+	LinkBatch batch;
 
 	if ( m_is_bootloader ){
-		return list;
+		return var::Vector<var::String>();
 	}
 
-	dirp = opendir(directory);
-
-	if( dirp == 0 ){
-		return list;
+	//one batch opens, reads and closes the directory under a single device lock
+	batch.add_read_dir(directory);
+	if( execute(batch) < 0 ){
+		return var::Vector<var::String>();
 	}
 
-	while( readdir_r(dirp, &entry, &result) == 0 ){
-		list.push_back(var::String(entry.d_name));
+	if( batch.at(0).is_success() == false ){
+		m_error_message.format("Failed to read directory %s (%d)", directory.cstring(), batch.at(0).error_number());
+		return var::Vector<var::String>();
 	}
 
-	if( closedir(dirp) < 0 ){
-		m_error_message.sprintf("Failed to close dir (%d)", link_errno);
-	}
+	return batch.at(0).entries();
+}
 
-	return list;
+int Link::execute(LinkBatch & batch){
+	int err;
+	if ( m_is_bootloader ){
+		m_error_message = "can't execute a batch on the bootloader";
+		return -1;
+	}
+	lock_device();
+	err = batch.execute(m_driver);
+	unlock_device();
+	if( err < 0 ){
+		m_error_message.format("Failed to execute batch (%d)", link_errno);
+	} else if( err > 0 ){
+		m_error_message.format("%d of %d batch operations failed", err, batch.count());
+	}
+	return check_error(err);
 }
 
 var::String Link::convert_permissions(link_mode_t mode){
@@ -775,9 +786,12 @@ int Link::copy(const var::ConstString & src, const var::ConstString & dest, link
 			} else {
 
 				m_error_message = "";
-				int result = device_file.write(host_file, APPFS_PAGE_SIZE, host_file.size(), progress_callback);
+				FileTransfer file_transfer;
+				file_transfer.set_chunk_size(APPFS_PAGE_SIZE, APPFS_PAGE_SIZE*64);
+				int result = file_transfer.transfer(host_file, device_file, host_file.size(), progress_callback);
 				if( result < 0 ){
-
+					m_error_message.format("Failed to write file %s on device (%d)", dest.cstring(), link_errno);
+					err = -1;
 				}
 				if( device_file.close() < 0 ){
 					m_error_message.sprintf("Failed to close Link device file (%d)", link_errno);
@@ -818,8 +832,10 @@ int Link::copy(const var::ConstString & src, const var::ConstString & dest, link
 		} else {
 			m_progress_max = st.st_size;
 
-			if( host_file.write(device_file, APPFS_PAGE_SIZE, device_file.size(), progress_callback) < 0 ){
-
+			FileTransfer file_transfer;
+			file_transfer.set_chunk_size(APPFS_PAGE_SIZE, APPFS_PAGE_SIZE*64);
+			if( file_transfer.transfer(device_file, host_file, st.st_size, progress_callback) < 0 ){
+				m_error_message.sprintf("Failed to read file %s from device (%d)", src.cstring(), link_errno);
 			}
 			host_file.close();
 
@@ -1081,12 +1097,15 @@ int Link::update_os(const sys::File & image, bool verify, const ProgressCallback
 			memset(buffer, 0xFF, 256);
 		}
 
-		if ( (err = link_writeflash(m_driver, loc, buffer, bytesRead)) != bytesRead ){
-			m_error_message.format("Failed to write to link flash (%d) -> try the operation again", link_errno);
-			if ( err < 0 ){
-				err = -1;
+		//the flash was just erased so blocks of 0xFF don't need to be written
+		if( is_erased(buffer, bytesRead) == false ){
+			if ( (err = link_writeflash(m_driver, loc, buffer, bytesRead)) != bytesRead ){
+				m_error_message.format("Failed to write to link flash (%d) -> try the operation again", link_errno);
+				if ( err < 0 ){
+					err = -1;
+				}
+				break;
 			}
-			break;
 		}
 
 		loc += bytesRead;
@@ -1191,6 +1210,102 @@ int Link::update_os(const sys::File & image, bool verify, const ProgressCallback
 	return check_error(err);
 }
 
+int Link::update_os_delta(const sys::File & image, bool verify, const ProgressCallback * progress_callback, u32 bootloader_retry_total){
+	int err;
+	u32 loc;
+	int bytes_read;
+	const int buffer_size = 1024;
+	unsigned char buffer[buffer_size];
+	unsigned char flash_buffer[buffer_size];
+	u32 image_id;
+	u32 block_count = 0;
+	u32 changed_count = 0;
+
+	if ( m_is_bootloader == false ){
+		m_error_message = "Target is not a bootloader";
+		return -1;
+	}
+
+	if( image.read(BOOTLOADER_HARDWARE_ID_OFFSET, &image_id, sizeof(u32)) != sizeof(u32) ){
+		m_error_message = "Failed to read bootloader image id";
+		return -1;
+	}
+
+	if( image.seek(0, LINK_SEEK_SET) < 0 ){
+		m_error_message = "Failed to seek bootloader image start";
+		return -1;
+	}
+
+	m_progress = 0;
+	m_progress_max = image.size();
+	m_status_message = "Comparing OS with Target...";
+
+	loc = m_bootloader_attributes.startaddr;
+
+	lock_device();
+	while( (bytes_read = image.read(buffer, buffer_size)) > 0 ){
+
+		if( (err = link_readflash(m_driver, loc, flash_buffer, bytes_read)) != bytes_read ){
+			unlock_device();
+			m_error_message.format("Failed to read flash memory (%d)", link_errno);
+			if( progress_callback ){ progress_callback->update(0,0); }
+			return check_error(err < 0 ? err : -1);
+		}
+
+		if( (loc == m_bootloader_attributes.startaddr) &&
+			 (image_id != m_bootloader_attributes.hardware_id) ){
+			//update_os() corrects the LSb of the hardware ID when it installs the image
+			memcpy(buffer + BOOTLOADER_HARDWARE_ID_OFFSET, &m_bootloader_attributes.hardware_id, sizeof(u32));
+		}
+
+		if( memcmp(buffer, flash_buffer, bytes_read) != 0 ){
+			changed_count++;
+		}
+
+		block_count++;
+		loc += bytes_read;
+		m_progress += bytes_read;
+		if( progress_callback && (progress_callback->update(m_progress, m_progress_max) == true)){
+			unlock_device();
+			progress_callback->update(0,0);
+			m_error_message = "Aborted before comparing the image";
+			return -1;
+		}
+	}
+	unlock_device();
+
+	if( block_count == 0 ){
+		m_error_message = "Failed to read bootloader image";
+		if( progress_callback ){ progress_callback->update(0,0); }
+		return -1;
+	}
+
+	if( changed_count == 0 ){
+		m_status_message = "Done (OS is up to date)";
+		if( progress_callback ){ progress_callback->update(0,0); }
+		return 0;
+	}
+
+	if( progress_callback ){ progress_callback->update(0,0); }
+
+	if( image.seek(0, LINK_SEEK_SET) < 0 ){
+		m_error_message = "Failed to seek bootloader image start";
+		return -1;
+	}
+
+	return update_os(image, verify, progress_callback, bootloader_retry_total);
+}
+
+bool Link::is_erased(const void * buffer, u32 size){
+	const u8 * p = (const u8*)buffer;
+	for(u32 i=0; i < size; i++){
+		if( p[i] != 0xFF ){
+			return false;
+		}
+	}
+	return true;
+}
+
 int Link::update_binary_install_options(const sys::File & file, const AppfsFileAttributes & attributes){
 	var::Data image(sizeof(appfs_file_t));
 	int result;
@@ -1211,68 +1326,53 @@ int Link::update_binary_install_options(const sys::File & file, const AppfsFileA
 }
 
 int Link::install_app(const sys::File & image_source, const var::ConstString & dest, const var::ConstString & name, const ProgressCallback * progress_callback){
-	int bytes_read;
-	int fd;
-	appfs_installattr_t attr;
-	int bytes_cumm;
-	int bytes_total;
-	int loc_err;
 
 	if( dest.find("/app") == 0 ){
-		fd = this->open("/app/.install", LINK_O_WRONLY);
-		if( fd < 0 ){
-			m_error_message.format("Failed to open destination: %s (%d, %d)", dest.c_str(), link_errno, fd);
+		AppfsInstallFile install_file(AppfsInstallFile::INSTALL, driver());
+		FileTransfer file_transfer;
+		u32 size = image_source.size();
+		int result;
+
+		lock_device();
+		if( install_file.open() < 0 ){
+			m_error_message.format("Failed to open destination: %s (%d)", dest.c_str(), link_errno);
+			unlock_device();
 			return -1;
 		}
 
-		attr.loc = 0;
-
-		bytes_total = image_source.size();
-		bytes_cumm = 0;
-
-		do {
-			memset(attr.buffer, 0xFF, APPFS_PAGE_SIZE);
-			//bytes_read = fread((char*)attr.buffer, 1, APPFS_PAGE_SIZE, source_file);
-			bytes_read = bytes_total - bytes_cumm;
-			if( bytes_read > APPFS_PAGE_SIZE ){
-				bytes_read = APPFS_PAGE_SIZE;
-			}
-
-			image_source.read(attr.buffer, bytes_read);
-
-			if( bytes_cumm == 0 ){
-				//app_file = (link_appfs_file_t *)attr.buffer;
-			}
+		//the next chunk of the image is read from the host while the current pages are installed
+		file_transfer.set_chunk_size(APPFS_PAGE_SIZE, Appfs::INSTALL_CHUNK_SIZE);
+		result = file_transfer.transfer(image_source, install_file, size, progress_callback);
+		if( (result == (int)size) && (install_file.flush() < 0) ){
+			result = -1;
+		}
 
-			if( bytes_read > 0 ){
-				attr.nbyte = bytes_read;
-				bytes_cumm += attr.nbyte;
-				if( (loc_err = ioctl(fd, I_APPFS_INSTALL, &attr)) < 0 ){
-					if( link_errno == 5 ){ //EIO
-						if( loc_err < -1 ){
-							m_error_message.format("Failed to install because of missing symbol on device near " F32D, loc_err+1);
-						} else {
-							m_error_message = "Failed to install because of unknown symbol error";
-						}
-					} if( link_errno == 8 ){ //ENOEXEC
-						m_error_message = "Failed to install because of symbol table signature mismatch";
-					} else {
-						m_error_message.format("Failed to install file on device with device errno %d", link_errno);
-					}
-					close(fd);
-					return -1;
+		if( result != (int)size ){
+			int loc_err = install_file.request_result();
+			if( link_errno == 5 ){ //EIO
+				if( loc_err < -1 ){
+					m_error_message.format("Failed to install because of missing symbol on device near " F32D, loc_err+1);
+				} else {
+					m_error_message = "Failed to install because of unknown symbol error";
 				}
-				if( progress_callback ){ progress_callback->update(bytes_cumm,bytes_total); }
-				attr.loc += APPFS_PAGE_SIZE;
+			} else if( link_errno == 8 ){ //ENOEXEC
+				m_error_message = "Failed to install because of symbol table signature mismatch";
+			} else {
+				m_error_message.format("Failed to install file on device with device errno %d", link_errno);
 			}
-		} while( bytes_read == APPFS_PAGE_SIZE );
+			//don't send the partial page of an aborted install
+			install_file.discard();
+			unlock_device();
+			return -1;
+		}
 
-		if( close(fd) < 0 ){
+		if( install_file.close() < 0 ){
 			m_error_message.sprintf("Failed to close file on device", link_errno);
+			unlock_device();
 			return -1;
 		}
+		unlock_device();
 
-		if( progress_callback ){ progress_callback->update(0,0); }
 	} else {
 
 		File f(driver());
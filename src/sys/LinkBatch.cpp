@@ -0,0 +1,151 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#include <errno.h>
+#include "sys/LinkBatch.hpp"
+
+using namespace sys;
+
+int LinkBatch::add(const LinkOperation & operation){
+	if( m_operations.push_back(operation) < 0 ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+	return 0;
+}
+
+int LinkBatch::add_mkdir(const var::ConstString & path, link_mode_t mode){
+	LinkOperation operation(LinkOperation::MKDIR, path);
+	operation.set_mode(mode);
+	return add(operation);
+}
+
+int LinkBatch::add_read(const var::ConstString & path, u32 offset, u32 size){
+	LinkOperation operation(LinkOperation::READ, path);
+	if( size > READ_SIZE_MAX ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+	operation.set_offset(offset);
+	operation.set_size(size);
+	return add(operation);
+}
+
+int LinkBatch::execute(link_transport_mdriver_t * driver){
+	int failed = 0;
+	int err;
+
+	if( driver == 0 ){
+		set_error_number(EINVAL);
+		return -1;
+	}
+
+	for(u32 i=0; i < m_operations.count(); i++){
+		LinkOperation & operation = m_operations.at(i);
+		err = execute_operation(driver, operation);
+		if( err == LINK_PHY_ERROR ){
+			//the connection is gone -- don't try the rest
+			set_error_number(EIO);
+			return LINK_PHY_ERROR;
+		}
+		if( err < 0 ){
+			operation.m_error_number = link_errno;
+			failed++;
+		}
+		operation.m_result = err;
+	}
+
+	return failed;
+}
+
+int LinkBatch::execute_operation(link_transport_mdriver_t * driver, LinkOperation & operation){
+	int err = -1;
+	int fd;
+	const char * path = operation.path().cstring();
+
+	switch(operation.type()){
+		case LinkOperation::STAT:
+			for(int tries = 0; tries < RETRY_COUNT; tries++){
+				err = link_stat(driver, path, &operation.m_stat);
+				if(err != LINK_PROT_ERROR) break;
+			}
+			return err;
+
+		case LinkOperation::UNLINK:
+			for(int tries = 0; tries < RETRY_COUNT; tries++){
+				err = link_unlink(driver, path);
+				if(err != LINK_PROT_ERROR) break;
+			}
+			return err;
+
+		case LinkOperation::MKDIR:
+			for(int tries = 0; tries < RETRY_COUNT; tries++){
+				err = link_mkdir(driver, path, operation.mode());
+				if(err != LINK_PROT_ERROR) break;
+			}
+			return err;
+
+		case LinkOperation::READ_DIR:
+			for(int tries = 0; tries < RETRY_COUNT; tries++){
+				fd = link_opendir(driver, path);
+				if(fd != LINK_PROT_ERROR) break;
+			}
+			if( fd <= 0 ){
+				return fd < 0 ? fd : -1;
+			}
+
+			operation.m_entries.clear();
+			{
+				struct link_dirent entry;
+				struct link_dirent * result;
+				while( (err = link_readdir_r(driver, fd, &entry, &result)) == 0 ){
+					operation.m_entries.push_back(var::String(entry.d_name));
+				}
+			}
+			if( err == LINK_PHY_ERROR ){
+				return err;
+			}
+
+			err = link_closedir(driver, fd);
+			if( err < 0 ){
+				return err;
+			}
+			return operation.m_entries.count();
+
+		case LinkOperation::READ:
+			for(int tries = 0; tries < RETRY_COUNT; tries++){
+				fd = link_open(driver, path, LINK_O_RDONLY, 0);
+				if(fd != LINK_PROT_ERROR) break;
+			}
+			if( fd < 0 ){
+				return fd;
+			}
+
+			if( operation.m_data.set_size(operation.size()) < 0 ){
+				link_close(driver, fd);
+				return -1;
+			}
+
+			err = 0;
+			if( operation.offset() ){
+				err = link_lseek(driver, fd, operation.offset(), LINK_SEEK_SET);
+			}
+
+			if( err >= 0 ){
+				for(int tries = 0; tries < RETRY_COUNT; tries++){
+					err = link_read(driver, fd, operation.m_data.to_void(), operation.size());
+					if(err != LINK_PROT_ERROR) break;
+				}
+			}
+
+			if( err >= 0 ){
+				operation.m_data.set_size(err);
+			}
+
+			if( link_close(driver, fd) == LINK_PHY_ERROR ){
+				return LINK_PHY_ERROR;
+			}
+			return err;
+	}
+
+	return err;
+}
@@ -0,0 +1,817 @@
+//Copyright 2011-2019 Tyler Gilbert; All Rights Reserved
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include "sys/LogPrinter.hpp"
+#include "var/Data.hpp"
+#include "var/String.hpp"
+#include "var/Vector.hpp"
+#include "chrono.hpp"
+
+using namespace sys;
+
+/*
+ * Binary logs start with LOG_HEADER_SIZE bytes: "SLOG", the version,
+ * and 1 if the writer was little endian. Each record is then:
+ *
+ * - u8 type (RECORD_FORMAT, RECORD_ENTRY or RECORD_TEXT)
+ * - u8 reserved
+ * - u16 payload size
+ * - u32 format ID (unused for RECORD_TEXT)
+ * - payload
+ *
+ * The payload of RECORD_FORMAT is the format string. The payload of
+ * RECORD_ENTRY is the arguments in the order they are used: int and
+ * '*' widths are 4 bytes; long, long long, pointers and doubles are
+ * 8 bytes; strings are a u16 length followed by the characters.
+ * Messages that can't be recorded that way are stored as RECORD_TEXT.
+ *
+ */
+enum {
+	LOG_HEADER_SIZE = 8,
+	LOG_VERSION = 1,
+	RECORD_HEADER_SIZE = 8,
+	RECORD_FORMAT = 1,
+	RECORD_ENTRY = 2,
+	RECORD_TEXT = 3,
+	EXPAND_OUTPUT_SIZE = 4096
+};
+
+enum {
+	ARGUMENT_NONE,
+	ARGUMENT_INT,
+	ARGUMENT_LONG,
+	ARGUMENT_LONG_LONG,
+	ARGUMENT_DOUBLE,
+	ARGUMENT_STRING,
+	ARGUMENT_POINTER,
+	ARGUMENT_UNSUPPORTED
+};
+
+typedef struct {
+	u8 type;
+	u8 star_count; //number of '*' (int) arguments before the value
+} log_conversion_t;
+
+static const char log_magic[4] = { 'S', 'L', 'O', 'G' };
+
+static bool is_little_endian(){
+	u16 value = 1;
+	return *(u8*)&value == 1;
+}
+
+static u32 load_acquire(const volatile u32 * value){
+	return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static void store_release(volatile u32 * value, u32 next){
+	__atomic_store_n(value, next, __ATOMIC_RELEASE);
+}
+
+//parses the conversion that starts after a '%' and returns the character after it
+static const char * parse_conversion(const char * p, log_conversion_t * conversion){
+	u8 length = 0; //1 for 'l' and 2 for 'll'
+	conversion->type = ARGUMENT_UNSUPPORTED;
+	conversion->star_count = 0;
+
+	if( *p == '%' ){
+		conversion->type = ARGUMENT_NONE;
+		return p+1;
+	}
+
+	while( *p && strchr("-+ #0", *p) ){ p++; }
+	if( *p == '*' ){
+		conversion->star_count++;
+		p++;
+	} else {
+		while( (*p >= '0') && (*p <= '9') ){ p++; }
+	}
+	if( *p == '.' ){
+		p++;
+		if( *p == '*' ){
+			conversion->star_count++;
+			p++;
+		} else {
+			while( (*p >= '0') && (*p <= '9') ){ p++; }
+		}
+	}
+
+	switch(*p){
+		case 'h':
+			p++;
+			if( *p == 'h' ){ p++; }
+			break;
+		case 'l':
+			p++;
+			length = 1;
+			if( *p == 'l' ){ p++; length = 2; }
+			break;
+		case 'j':
+		case 'z':
+		case 't':
+		case 'L':
+			//the argument size depends on the platform
+			p++;
+			length = 3;
+			break;
+	}
+
+	if( *p == 0 ){
+		return p;
+	}
+
+	switch(*p){
+		case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+			if( length == 0 ){ conversion->type = ARGUMENT_INT; }
+			else if( length == 1 && *p != 'c' ){ conversion->type = ARGUMENT_LONG; }
+			else if( length == 2 && *p != 'c' ){ conversion->type = ARGUMENT_LONG_LONG; }
+			break;
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+			if( length == 0 ){ conversion->type = ARGUMENT_DOUBLE; }
+			break;
+		case 's':
+			if( length == 0 ){ conversion->type = ARGUMENT_STRING; }
+			break;
+		case 'p':
+			if( length == 0 ){ conversion->type = ARGUMENT_POINTER; }
+			break;
+	}
+	return p+1;
+}
+
+LogPrinter::LogPrinter(enum mode mode, u32 buffer_size) : m_thread(STACK_SIZE, false){
+	m_stdout.set_fileno(1);
+	m_stdout.set_keep_open();
+	init(m_stdout, mode, buffer_size);
+}
+
+LogPrinter::LogPrinter(const File & file, enum mode mode, u32 buffer_size) : m_thread(STACK_SIZE, false){
+	init(file, mode, buffer_size);
+}
+
+void LogPrinter::init(const File & file, enum mode mode, u32 buffer_size){
+	m_file = &file;
+	m_mode = mode;
+	//a binary record must always fit in an empty buffer
+	m_buffer_size = buffer_size < LINE_SIZE*2 ? LINE_SIZE*2 : buffer_size;
+	m_slot_count = 0;
+	m_format_count = 0;
+	memset(m_slot, 0, sizeof(m_slot));
+
+	if( m_mode == MODE_BINARY ){
+		u8 header[LOG_HEADER_SIZE] = { 0 };
+		memcpy(header, log_magic, sizeof(log_magic));
+		header[4] = LOG_VERSION;
+		header[5] = is_little_endian();
+		write_output(header, LOG_HEADER_SIZE);
+	}
+
+	m_is_running = true;
+	if( m_thread.create(writer_thread, this) < 0 ){
+		//without the writer, the buffers are written when they fill up
+		m_is_running = false;
+		set_error_number(m_thread.error_number());
+	}
+}
+
+LogPrinter::~LogPrinter(){
+	if( m_is_running ){
+		m_is_running = false;
+		m_thread.join();
+	}
+
+	flush();
+
+	for(u32 i=0; i < m_slot_count; i++){
+		free(m_slot[i].buffer);
+	}
+}
+
+void * LogPrinter::writer_thread(void * args){
+	return ((LogPrinter*)args)->run();
+}
+
+void * LogPrinter::run(){
+	while( m_is_running ){
+		chrono::wait_milliseconds(FLUSH_INTERVAL);
+		flush();
+	}
+	return 0;
+}
+
+u32 LogPrinter::stall_count() const {
+	u32 result = 0;
+	u32 count = load_acquire(&m_slot_count);
+	for(u32 i=0; i < count; i++){
+		result += m_slot[i].stall_count;
+	}
+	return result;
+}
+
+int LogPrinter::flush(){
+	int result;
+	m_write_mutex.lock();
+	result = drain();
+	m_write_mutex.unlock();
+	return result;
+}
+
+int LogPrinter::drain(){
+	int result = 0;
+	u32 count = load_acquire(&m_slot_count);
+
+	for(u32 i=0; i < count; i++){
+		log_printer_slot_t * slot = m_slot + i;
+		u32 head = load_acquire(&slot->head);
+		u32 tail = slot->tail;
+
+		if( head == tail ){ continue; }
+
+		if( head < tail ){
+			if( write_output(slot->buffer + tail, m_buffer_size - tail) < 0 ){ result = -1; }
+			tail = 0;
+		}
+		if( write_output(slot->buffer + tail, head - tail) < 0 ){ result = -1; }
+
+		//the space is released even if the output failed so the threads don't block
+		store_release(&slot->tail, head);
+	}
+	return result;
+}
+
+int LogPrinter::write_output(const void * data, u32 size){
+	u32 offset = 0;
+	int result;
+
+	//sockets may accept less than the whole buffer
+	while( offset < size ){
+		result = m_file->write((const u8*)data + offset, size - offset);
+		if( result <= 0 ){
+			set_error_number(m_file->error_number());
+			return -1;
+		}
+		offset += result;
+	}
+	return 0;
+}
+
+log_printer_slot_t * LogPrinter::slot(){
+	pthread_t self = pthread_self();
+	u32 count = load_acquire(&m_slot_count);
+	for(u32 i=0; i < count; i++){
+		if( pthread_equal(m_slot[i].thread, self) ){
+			return m_slot + i;
+		}
+	}
+	return register_slot(self);
+}
+
+log_printer_slot_t * LogPrinter::register_slot(pthread_t thread){
+	log_printer_slot_t * result = 0;
+	u32 size = m_buffer_size;
+
+	if( m_mode == MODE_BINARY ){
+		size += FORMAT_CACHE_SIZE * sizeof(log_printer_format_t);
+	}
+
+	m_mutex.lock();
+	if( m_slot_count < THREAD_LIMIT ){
+		u8 * buffer = (u8*)malloc(size);
+		if( buffer ){
+			result = m_slot + m_slot_count;
+			result->thread = thread;
+			result->buffer = buffer;
+			if( m_mode == MODE_BINARY ){
+				result->format_list = (log_printer_format_t*)(buffer + m_buffer_size);
+				memset(result->format_list, 0, FORMAT_CACHE_SIZE * sizeof(log_printer_format_t));
+			}
+			//the slot is complete before it is published to the other threads
+			store_release(&m_slot_count, m_slot_count + 1);
+		}
+	}
+	m_mutex.unlock();
+	return result;
+}
+
+u32 LogPrinter::free_size(const log_printer_slot_t * slot) const {
+	u32 tail = load_acquire(&slot->tail);
+	u32 used = (slot->head + m_buffer_size - tail) % m_buffer_size;
+	//one byte is always free so that a full buffer isn't mistaken for an empty one
+	return m_buffer_size - 1 - used - slot->pending;
+}
+
+bool LogPrinter::reserve(log_printer_slot_t * slot, u32 size){
+	if( size <= free_size(slot) ){
+		return true;
+	}
+
+	slot->stall_count++;
+	flush();
+	if( size <= free_size(slot) ){
+		return true;
+	}
+
+	//the entry is too big for the buffer so it is published in parts
+	commit(slot);
+	flush();
+	return size <= free_size(slot);
+}
+
+void LogPrinter::copy(log_printer_slot_t * slot, const void * data, u32 size){
+	u32 position = (slot->head + slot->pending) % m_buffer_size;
+	u32 page = m_buffer_size - position;
+
+	if( page > size ){ page = size; }
+	memcpy(slot->buffer + position, data, page);
+	memcpy(slot->buffer, (const u8*)data + page, size - page);
+	slot->pending += size;
+}
+
+void LogPrinter::commit(log_printer_slot_t * slot){
+	if( slot->pending ){
+		store_release(&slot->head, (slot->head + slot->pending) % m_buffer_size);
+		slot->pending = 0;
+	}
+}
+
+void LogPrinter::write(log_printer_slot_t * slot, const void * data, u32 size){
+	if( reserve(slot, size) ){
+		copy(slot, data, size);
+		return;
+	}
+	//the buffer is empty so writing directly keeps the output in order
+	write_direct(data, size);
+}
+
+void LogPrinter::write_direct(const void * data, u32 size){
+	m_write_mutex.lock();
+	drain();
+	write_output(data, size);
+	m_write_mutex.unlock();
+}
+
+void LogPrinter::write_text(log_printer_slot_t * slot, const char * text, u32 length){
+	if( m_mode == MODE_TEXT ){
+		if( slot ){
+			write(slot, text, length);
+		} else {
+			write_direct(text, length);
+		}
+		return;
+	}
+
+	do {
+		u8 header[RECORD_HEADER_SIZE] = { RECORD_TEXT };
+		u16 page = length < LINE_SIZE - RECORD_HEADER_SIZE ? length : LINE_SIZE - RECORD_HEADER_SIZE;
+		memcpy(header + 2, &page, sizeof(page));
+
+		if( slot && reserve(slot, RECORD_HEADER_SIZE + page) ){
+			copy(slot, header, RECORD_HEADER_SIZE);
+			copy(slot, text, page);
+		} else {
+			m_write_mutex.lock();
+			drain();
+			write_output(header, RECORD_HEADER_SIZE);
+			write_output(text, page);
+			m_write_mutex.unlock();
+		}
+
+		text += page;
+		length -= page;
+	} while( length );
+}
+
+void LogPrinter::format(log_printer_slot_t * slot, const char * fmt, va_list list){
+	char line[LINE_SIZE];
+	va_list copy;
+	int length;
+
+	va_copy(copy, list);
+	length = vsnprintf(line, LINE_SIZE, fmt, copy);
+	va_end(copy);
+
+	if( length < 0 ){ return; }
+
+	if( length < LINE_SIZE ){
+		write_text(slot, line, length);
+		return;
+	}
+
+	var::Data buffer(length+1);
+	if( buffer.size() < (u32)length+1 ){
+		write_text(slot, line, LINE_SIZE-1);
+		return;
+	}
+	vsnprintf(buffer.to_char(), length+1, fmt, list);
+	write_text(slot, buffer.to_char(), length);
+}
+
+int LogPrinter::format_id(log_printer_slot_t * slot, const char * fmt, u32 * id){
+	u32 index = (u32)(((size_t)fmt >> 2) * 2654435761UL) % FORMAT_CACHE_SIZE;
+	log_printer_format_t * entry = 0;
+	u32 length;
+
+	for(u32 i=0; i < FORMAT_CACHE_SIZE; i++){
+		log_printer_format_t * candidate = slot->format_list + (index + i) % FORMAT_CACHE_SIZE;
+		if( candidate->format == fmt ){
+			*id = candidate->id;
+			return 0;
+		}
+		if( candidate->format == 0 ){
+			entry = candidate;
+			break;
+		}
+	}
+
+	length = strlen(fmt);
+	if( length > LINE_SIZE - RECORD_HEADER_SIZE ){
+		return -1;
+	}
+
+	if( entry == 0 ){
+		//the cache is full so the format strings are recorded again as they are used
+		memset(slot->format_list, 0, FORMAT_CACHE_SIZE * sizeof(log_printer_format_t));
+		entry = slot->format_list + index;
+	}
+
+	if( reserve(slot, RECORD_HEADER_SIZE + length) == false ){
+		return -1;
+	}
+
+	m_mutex.lock();
+	*id = m_format_count++;
+	m_mutex.unlock();
+
+	u8 header[RECORD_HEADER_SIZE] = { RECORD_FORMAT };
+	u16 size = length;
+	memcpy(header + 2, &size, sizeof(size));
+	memcpy(header + 4, id, sizeof(u32));
+	copy(slot, header, RECORD_HEADER_SIZE);
+	copy(slot, fmt, length);
+
+	entry->format = fmt;
+	entry->id = *id;
+	return 0;
+}
+
+void LogPrinter::encode(log_printer_slot_t * slot, const char * fmt, va_list list){
+	u8 record[LINE_SIZE];
+	u32 size = RECORD_HEADER_SIZE;
+	const char * p = fmt;
+	bool is_text = false;
+	va_list copy;
+	u32 id;
+
+	va_copy(copy, list);
+	while( (is_text == false) && (p = strchr(p, '%')) != 0 ){
+		log_conversion_t conversion;
+		p = parse_conversion(p+1, &conversion);
+
+		if( conversion.type == ARGUMENT_UNSUPPORTED ){
+			is_text = true;
+			break;
+		}
+
+		for(u32 i=0; i < conversion.star_count; i++){
+			s32 value = va_arg(copy, int);
+			if( size + sizeof(value) > LINE_SIZE ){ is_text = true; break; }
+			memcpy(record + size, &value, sizeof(value));
+			size += sizeof(value);
+		}
+
+		if( is_text ){ break; }
+
+		u32 argument_size = 8;
+		s32 int_value;
+		s64 long_value;
+		double double_value;
+		const char * string_value;
+		u16 string_length;
+		const void * data = &long_value;
+
+		switch(conversion.type){
+			case ARGUMENT_NONE:
+				continue;
+			case ARGUMENT_INT:
+				int_value = va_arg(copy, int);
+				data = &int_value;
+				argument_size = sizeof(int_value);
+				break;
+			case ARGUMENT_LONG:
+				long_value = va_arg(copy, long);
+				break;
+			case ARGUMENT_LONG_LONG:
+				long_value = va_arg(copy, long long);
+				break;
+			case ARGUMENT_POINTER:
+				long_value = (s64)(size_t)va_arg(copy, void*);
+				break;
+			case ARGUMENT_DOUBLE:
+				double_value = va_arg(copy, double);
+				data = &double_value;
+				break;
+			case ARGUMENT_STRING:
+				string_value = va_arg(copy, const char*);
+				if( string_value == 0 ){ string_value = "(null)"; }
+				argument_size = strlen(string_value);
+				if( size + sizeof(string_length) + argument_size > LINE_SIZE ){
+					is_text = true;
+					break;
+				}
+				string_length = argument_size;
+				memcpy(record + size, &string_length, sizeof(string_length));
+				size += sizeof(string_length);
+				data = string_value;
+				break;
+		}
+
+		if( is_text || (size + argument_size > LINE_SIZE) ){
+			is_text = true;
+			break;
+		}
+		memcpy(record + size, data, argument_size);
+		size += argument_size;
+	}
+	va_end(copy);
+
+	if( is_text || (format_id(slot, fmt, &id) < 0) ){
+		format(slot, fmt, list);
+		return;
+	}
+
+	u16 payload_size = size - RECORD_HEADER_SIZE;
+	record[0] = RECORD_ENTRY;
+	record[1] = 0;
+	memcpy(record + 2, &payload_size, sizeof(payload_size));
+	memcpy(record + 4, &id, sizeof(id));
+	write(slot, record, size);
+}
+
+void LogPrinter::vprint(const char * fmt, va_list list){
+	log_printer_slot_t * slot = this->slot();
+
+	if( slot == 0 ){
+		//too many threads are printing
+		format(0, fmt, list);
+		return;
+	}
+
+	if( m_mode == MODE_BINARY ){
+		encode(slot, fmt, list);
+	} else {
+		format(slot, fmt, list);
+	}
+
+	if( slot->depth == 0 ){
+		commit(slot);
+	}
+}
+
+void LogPrinter::vprint_indented(const var::ConstString & key, const char * fmt, va_list list){
+	log_printer_slot_t * slot = this->slot();
+
+	//the indentation, key, value and color codes are published together
+	if( slot ){ slot->depth++; }
+	Printer::vprint_indented(key, fmt, list);
+	if( slot ){
+		slot->depth--;
+		if( slot->depth == 0 ){
+			commit(slot);
+		}
+	}
+}
+
+/*! \cond */
+typedef struct {
+	const File * file;
+	var::Data buffer;
+	u32 size;
+	int result;
+} log_expand_output_t;
+/*! \endcond */
+
+static void expand_write_all(log_expand_output_t * output, const void * data, u32 size){
+	u32 offset = 0;
+	//like write_output(), a short write is continued rather than treated as an error
+	while( offset < size ){
+		int result = output->file->write((const u8*)data + offset, size - offset);
+		if( result <= 0 ){
+			output->result = -1;
+			return;
+		}
+		offset += result;
+	}
+}
+
+static void expand_flush(log_expand_output_t * output){
+	expand_write_all(output, output->buffer.to_void(), output->size);
+	output->size = 0;
+}
+
+static void expand_write(log_expand_output_t * output, const void * data, u32 size){
+	if( output->size + size > output->buffer.size() ){
+		expand_flush(output);
+		if( size > output->buffer.size() ){
+			expand_write_all(output, data, size);
+			return;
+		}
+	}
+	memcpy(output->buffer.to_u8() + output->size, data, size);
+	output->size += size;
+}
+
+static int read_exact(const File & file, void * data, u32 size){
+	u32 offset = 0;
+	while( offset < size ){
+		int result = file.read((u8*)data + offset, size - offset);
+		if( result <= 0 ){
+			return offset == 0 ? 0 : -1;
+		}
+		offset += result;
+	}
+	return size;
+}
+
+static int format_value(char * buffer, u32 size, const char * spec, u8 type, s64 integer, double real, const char * string){
+	switch(type){
+		case ARGUMENT_INT: return snprintf(buffer, size, spec, (int)integer);
+		case ARGUMENT_LONG: return snprintf(buffer, size, spec, (long)integer);
+		case ARGUMENT_LONG_LONG: return snprintf(buffer, size, spec, (long long)integer);
+		case ARGUMENT_POINTER: return snprintf(buffer, size, spec, (void*)(size_t)integer);
+		case ARGUMENT_DOUBLE: return snprintf(buffer, size, spec, real);
+		case ARGUMENT_STRING: return snprintf(buffer, size, spec, string);
+	}
+	return 0;
+}
+
+static void expand_entry(log_expand_output_t * output, const char * fmt, const u8 * payload, u32 payload_size){
+	const u8 * end = payload + payload_size;
+	const char * p = fmt;
+
+	while( *p ){
+		const char * percent = strchr(p, '%');
+		log_conversion_t conversion;
+		char spec[64];
+		u32 spec_length = 0;
+		s32 star;
+		s64 integer = 0;
+		double real = 0;
+		var::Data string;
+		char text[256];
+		int length;
+
+		if( percent == 0 ){
+			expand_write(output, p, strlen(p));
+			return;
+		}
+
+		expand_write(output, p, percent - p);
+		p = parse_conversion(percent+1, &conversion);
+		if( conversion.type == ARGUMENT_NONE ){
+			expand_write(output, "%", 1);
+			continue;
+		}
+
+		//'*' is replaced with the recorded value so the value is the only argument
+		for(const char * c = percent; c < p; c++){
+			if( spec_length + 12 >= sizeof(spec) ){ break; }
+			if( *c != '*' ){
+				spec[spec_length++] = *c;
+				continue;
+			}
+			star = 0;
+			if( payload + sizeof(star) <= end ){
+				memcpy(&star, payload, sizeof(star));
+				payload += sizeof(star);
+			}
+			if( (star < 0) && (spec_length > 0) && (spec[spec_length-1] == '.') ){
+				//a negative precision is ignored
+				spec_length--;
+				continue;
+			}
+			spec_length += sprintf(spec + spec_length, "%d", (int)star);
+		}
+		spec[spec_length] = 0;
+
+		if( conversion.type == ARGUMENT_INT ){
+			s32 value = 0;
+			if( payload + sizeof(value) <= end ){
+				memcpy(&value, payload, sizeof(value));
+				payload += sizeof(value);
+			}
+			integer = value;
+		} else if( conversion.type == ARGUMENT_DOUBLE ){
+			if( payload + sizeof(real) <= end ){
+				memcpy(&real, payload, sizeof(real));
+				payload += sizeof(real);
+			}
+		} else if( conversion.type == ARGUMENT_STRING ){
+			u16 string_length = 0;
+			if( payload + sizeof(string_length) <= end ){
+				memcpy(&string_length, payload, sizeof(string_length));
+				payload += sizeof(string_length);
+			}
+			if( payload + string_length > end ){ string_length = end - payload; }
+			string.allocate(string_length+1);
+			if( string.size() < (u32)string_length+1 ){
+				output->result = -1;
+				return;
+			}
+			memcpy(string.to_void(), payload, string_length);
+			string.to_char()[string_length] = 0;
+			payload += string_length;
+		} else if( conversion.type != ARGUMENT_UNSUPPORTED ){
+			if( payload + sizeof(integer) <= end ){
+				memcpy(&integer, payload, sizeof(integer));
+				payload += sizeof(integer);
+			}
+		} else {
+			//the writer stores these as RECORD_TEXT
+			expand_write(output, percent, p - percent);
+			continue;
+		}
+
+		length = format_value(text, sizeof(text), spec, conversion.type, integer, real, string.to_char());
+		if( length < 0 ){ continue; }
+		if( (u32)length < sizeof(text) ){
+			expand_write(output, text, length);
+		} else {
+			var::Data buffer(length+1);
+			if( buffer.size() < (u32)length+1 ){
+				output->result = -1;
+				return;
+			}
+			format_value(buffer.to_char(), length+1, spec, conversion.type, integer, real, string.to_char());
+			expand_write(output, buffer.to_char(), length);
+		}
+	}
+}
+
+int LogPrinter::expand(const File & input, const File & output){
+	BufferedFile reader(input);
+	var::Vector<var::String> format_list;
+	var::Data payload(LINE_SIZE);
+	log_expand_output_t expand_output;
+	u8 header[LOG_HEADER_SIZE];
+	int result;
+
+	expand_output.file = &output;
+	expand_output.buffer.allocate(EXPAND_OUTPUT_SIZE);
+	expand_output.size = 0;
+	expand_output.result = 0;
+
+	if( (read_exact(reader, header, LOG_HEADER_SIZE) != LOG_HEADER_SIZE) ||
+			memcmp(header, log_magic, sizeof(log_magic)) ||
+			(header[4] != LOG_VERSION) ||
+			(header[5] != is_little_endian()) ){
+		errno = EINVAL;
+		return -1;
+	}
+
+	while( (result = read_exact(reader, header, RECORD_HEADER_SIZE)) == RECORD_HEADER_SIZE ){
+		u16 size;
+		u32 id;
+		memcpy(&size, header + 2, sizeof(size));
+		memcpy(&id, header + 4, sizeof(id));
+
+		//one byte is kept for a terminator
+		if( payload.size() < (u32)size+1 ){
+			if( payload.allocate(size+1) < 0 ){ return -1; }
+		}
+		if( read_exact(reader, payload.to_void(), size) != size ){
+			errno = EINVAL;
+			return -1;
+		}
+		payload.to_char()[size] = 0;
+
+		switch(header[0]){
+			case RECORD_FORMAT:
+				while( format_list.count() <= id ){
+					format_list.push_back(var::String());
+				}
+				format_list.at(id).assign(payload.to_char());
+				break;
+			case RECORD_ENTRY:
+				if( id >= format_list.count() ){
+					errno = EINVAL;
+					return -1;
+				}
+				expand_entry(&expand_output, format_list.at(id).cstring(), payload.to_u8(), size);
+				break;
+			case RECORD_TEXT:
+				expand_write(&expand_output, payload.to_void(), size);
+				break;
+			default:
+				errno = EINVAL;
+				return -1;
+		}
+	}
+
+	expand_flush(&expand_output);
+	if( (result != 0) || (expand_output.result < 0) ){
+		return -1;
+	}
+	return 0;
+}
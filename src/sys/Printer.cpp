@@ -104,7 +104,7 @@ void Printer::set_color_code(u32 code){
 void Printer::clear_color_code(){
 #if defined __link
 	if( api::ApiInfo::is_macosx() || is_bash() ){
-		printf("\033[0m");
+		print("\033[0m");
 	} else {
 		set_color_code(COLOR_CODE_DEFAULT);
 	}
@@ -141,8 +141,9 @@ void Printer::print_indentation(){
 	if( indent_count < 0 ){
 		indent_count = 0;
 	}
-	for(u16 i = 0; i < indent_count; i++){
-		print("   ");
+	if( indent_count ){
+		//one call for all levels instead of one per level
+		print("%*s", indent_count*3, "");
 	}
 }
 
@@ -223,6 +224,17 @@ Printer & Printer::operator << (const var::DataInfo & a){
 }
 #endif
 
+Printer & Printer::operator << (const var::AllocatorInfo & a){
+	key("arena", F32U, a.arena());
+	key("freeBlockCount", F32U, a.free_block_count());
+	key("freeSize", F32U, a.free_size());
+	key("usedSize", F32U, a.used_size());
+	key("peakUsedSize", F32U, a.peak_used_size());
+	key("allocationCount", F32U, a.allocation_count());
+	key("failureCount", F32U, a.failure_count());
+	return *this;
+}
+
 
 Printer & Printer::operator << (const var::Data & a){
 	u32 o_flags = m_o_flags;
@@ -0,0 +1,163 @@
+//Copyright 2011-2018 Tyler Gilbert; All Rights Reserved
+
+#include <errno.h>
+#include <cstdlib>
+#include "var/Allocator.hpp"
+
+using namespace var;
+
+//all allocations are aligned so any type can be stored
+#define ALLOCATOR_ALIGNMENT 8
+#define ALIGN_SIZE(x) (((x) + ALLOCATOR_ALIGNMENT - 1) & ~(ALLOCATOR_ALIGNMENT - 1))
+
+ArenaAllocator::ArenaAllocator(u32 size){
+	m_mem = (u8*)malloc(size);
+	m_size = m_mem ? size : 0;
+	m_is_internally_managed = true;
+	if( m_mem == 0 ){
+		set_error_number(ENOMEM);
+	}
+	m_info.m_arena = m_size;
+	reset();
+}
+
+ArenaAllocator::ArenaAllocator(void * mem, u32 size){
+	m_mem = (u8*)mem;
+	m_size = size;
+	m_is_internally_managed = false;
+	m_info.m_arena = m_size;
+	reset();
+}
+
+ArenaAllocator::~ArenaAllocator(){
+	if( m_is_internally_managed ){
+		::free(m_mem);
+	}
+}
+
+void ArenaAllocator::reset(){
+	//align the first allocation in case an external buffer is not aligned
+	m_offset = ALIGN_SIZE((u32)((size_t)m_mem)) - (u32)((size_t)m_mem);
+	if( m_offset > m_size ){ m_offset = m_size; }
+	m_last_offset = m_offset;
+	update_info();
+}
+
+void * ArenaAllocator::allocate(u32 size){
+	u32 aligned_size = ALIGN_SIZE(size);
+	if( (aligned_size < size) || (aligned_size > m_size - m_offset) ){
+		m_info.m_failure_count++;
+		set_error_number(ENOMEM);
+		return 0;
+	}
+
+	void * result = m_mem + m_offset;
+	m_last_offset = m_offset;
+	m_offset += aligned_size;
+	m_info.m_allocation_count++;
+	update_info();
+	return result;
+}
+
+void ArenaAllocator::deallocate(void * mem){
+	//only the most recent allocation can be rolled back
+	if( (mem != 0) && (mem == m_mem + m_last_offset) ){
+		m_offset = m_last_offset;
+		update_info();
+	}
+}
+
+int ArenaAllocator::resize(void * mem, u32 size){
+	u32 aligned_size = ALIGN_SIZE(size);
+
+	//only the most recent allocation has free space after it
+	if( (mem == 0) || (mem != m_mem + m_last_offset) ||
+			(aligned_size < size) || (aligned_size > m_size - m_last_offset) ){
+		return -1;
+	}
+
+	m_offset = m_last_offset + aligned_size;
+	update_info();
+	return 0;
+}
+
+void ArenaAllocator::update_info(){
+	update_used_size(m_offset, m_size - m_offset, m_size - m_offset ? 1 : 0);
+}
+
+PoolAllocator::PoolAllocator(u32 block_size, u32 block_count){
+	u32 size;
+	block_size = ALIGN_SIZE(block_size < sizeof(pool_block_t) ? sizeof(pool_block_t) : block_size);
+	size = block_size * block_count;
+	void * mem = malloc(size);
+	if( mem == 0 ){
+		set_error_number(ENOMEM);
+		size = 0;
+	}
+	initialize(block_size, mem, size);
+	m_is_internally_managed = true;
+}
+
+PoolAllocator::PoolAllocator(u32 block_size, void * mem, u32 size){
+	initialize(block_size, mem, size);
+	m_is_internally_managed = false;
+}
+
+PoolAllocator::~PoolAllocator(){
+	if( m_is_internally_managed ){
+		::free(m_mem);
+	}
+}
+
+void PoolAllocator::initialize(u32 block_size, void * mem, u32 size){
+	u32 i;
+	u32 alignment_offset;
+	m_block_size = ALIGN_SIZE(block_size < sizeof(pool_block_t) ? sizeof(pool_block_t) : block_size);
+	m_mem = (u8*)mem;
+
+	alignment_offset = ALIGN_SIZE((u32)((size_t)m_mem)) - (u32)((size_t)m_mem);
+	if( (m_mem == 0) || (alignment_offset > size) ){
+		size = 0;
+		alignment_offset = 0;
+	}
+	m_block_count = (size - alignment_offset) / m_block_size;
+
+	//thread every block onto the free list
+	m_free_list = 0;
+	for(i=m_block_count; i > 0; i--){
+		pool_block_t * block = (pool_block_t*)(m_mem + alignment_offset + (i-1)*m_block_size);
+		block->next = m_free_list;
+		m_free_list = block;
+	}
+	m_free_count = m_block_count;
+	m_info.m_arena = m_block_count * m_block_size;
+	update_info();
+}
+
+void * PoolAllocator::allocate(u32 size){
+	if( (size > m_block_size) || (m_free_list == 0) ){
+		m_info.m_failure_count++;
+		set_error_number(ENOMEM);
+		return 0;
+	}
+
+	pool_block_t * block = m_free_list;
+	m_free_list = block->next;
+	m_free_count--;
+	m_info.m_allocation_count++;
+	update_info();
+	return block;
+}
+
+void PoolAllocator::deallocate(void * mem){
+	if( mem == 0 ){ return; }
+	pool_block_t * block = (pool_block_t*)mem;
+	block->next = m_free_list;
+	m_free_list = block;
+	m_free_count++;
+	update_info();
+}
+
+void PoolAllocator::update_info(){
+	update_used_size((m_block_count - m_free_count)*m_block_size, m_free_count*m_block_size, m_free_count);
+}
@@ -27,6 +27,15 @@ const int Data::m_zero_value MCU_ALIGN(4) = 0;
 #define MALLOC_CHUNK_SIZE 64
 #endif
 
+//how much the capacity grows (as a percentage) when data outgrows its allocation
+#if !defined SAPI_DATA_GROWTH_FACTOR_PERCENT
+#if defined __link
+#define SAPI_DATA_GROWTH_FACTOR_PERCENT 200
+#else
+#define SAPI_DATA_GROWTH_FACTOR_PERCENT 150
+#endif
+#endif
+
 u32 Data::minimum_size(){
 	return MIN_CHUNK_SIZE;
 }
@@ -35,32 +44,50 @@ u32 Data::block_size(){
 	return MALLOC_CHUNK_SIZE;
 }
 
+u32 Data::growth_factor_percent(){
+	return SAPI_DATA_GROWTH_FACTOR_PERCENT;
+}
+
+u32 Data::calculate_growth(u32 capacity, u32 size){
+	u32 grown = (u32)(((u64)capacity * SAPI_DATA_GROWTH_FACTOR_PERCENT) / 100);
+	if( grown > size ){
+		return grown;
+	}
+	return size;
+}
+
 Data::Data(){
+	m_allocator = 0;
 	zero();
 }
 
 Data::Data(void * mem, u32 s){
+	m_allocator = 0;
 	zero();
 	set(mem, s, false);
 }
 
 Data::Data(const void * mem, u32 s){
+	m_allocator = 0;
 	zero();
 	set((void*)mem, s, true);
 }
 
 Data::Data(u32 s){
+	m_allocator = 0;
 	zero();
 	alloc(s);
 }
 
 
 Data::Data(const Data & a){
+	m_allocator = 0;
 	zero();
 	copy_object(a);
 }
 
 Data::Data(Data && a){
+	m_allocator = 0;
 	zero();
 	move_object(a);
 }
@@ -76,9 +103,23 @@ Data& Data::operator=(Data && a){
 }
 
 
+int Data::set_allocator(Allocator * allocator){
+	if( needs_free() ){
+		//memory must be returned to the allocator it came from
+		set_error_number(EINVAL);
+		return -1;
+	}
+	m_allocator = allocator;
+	return 0;
+}
+
 int Data::free(){
 	if( needs_free() ){
-		::free(m_mem_write);
+		if( m_allocator ){
+			m_allocator->deallocate(m_mem_write);
+		} else {
+			::free(m_mem_write);
+		}
 	}
 	zero();
 	return 0;
@@ -132,6 +173,9 @@ void Data::move_object(Data & a){
 		if( a.is_internally_managed() ){
 			//set this memory to the memory of a
 			set(a.to_void(), a.capacity(), false);
+
+			//the memory has to go back to the allocator it came from
+			m_allocator = a.m_allocator;
 			m_size = a.size();
 
 			//setting needs free on this and clearing it on a will complete the transfer
@@ -201,15 +245,27 @@ int Data::allocate(u32 s, bool resize){
 	}
 
 
-	if( s <= minimum_size() ){
-		s = minimum_size();
+	if( m_allocator ){
+		//an arena can grow its most recent block without a copy
+		if( needs_free() && (m_allocator->resize(m_mem_write, s) == 0) ){
+			m_size = original_size;
+			m_capacity = s;
+			return 0;
+		}
+
+		//the allocator decides its own granularity
+		new_data = m_allocator->allocate(s);
 	} else {
-		//change s to allocate an integer multiple of minimum_size()
-		u32 blocks = (s - minimum_size() + block_size() - 1) / block_size();
-		s = minimum_size() + blocks * block_size();
+		if( s <= minimum_size() ){
+			s = minimum_size();
+		} else {
+			//change s to allocate an integer multiple of minimum_size()
+			u32 blocks = (s - minimum_size() + block_size() - 1) / block_size();
+			s = minimum_size() + blocks * block_size();
+		}
+		new_data = malloc(s);
 	}
 
-	new_data = malloc(s);
 	if( set_error_number_if_null(new_data) == 0 ){
 		return -1;
 	}
@@ -235,7 +291,44 @@ int Data::set_size(u32 s){
 		return 0;
 	} //no need to increase size
 
-	return allocate(s, true);
+	if( reserve(calculate_growth(capacity(), s)) < 0 ){
+		return -1;
+	}
+	m_size = s;
+	return 0;
+}
+
+int Data::reserve(u32 s){
+	u32 original_size = m_size;
+	if( s <= capacity() ){
+		return 0;
+	}
+
+	if( allocate(s, true) < 0 ){
+		return -1;
+	}
+	m_size = original_size;
+	return 0;
+}
+
+int Data::shrink_to_fit(){
+	u32 original_size = size();
+	if( !needs_free() ){
+		return 0;
+	}
+
+	if( original_size == 0 ){
+		return free();
+	}
+
+	//allocate() rounds up to a block -- only reallocate if that frees something
+	if( capacity() - original_size >= block_size() ){
+		if( allocate(original_size, true) < 0 ){
+			return -1;
+		}
+	}
+	m_size = original_size;
+	return 0;
 }
 
 void Data::fill(unsigned char d){
@@ -1,4 +1,9 @@
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <errno.h>
 #include "var/Vector.hpp"
+#include "var/Allocator.hpp"
 #include "var/Tokenizer.hpp"
 #include "var/Json.hpp"
 #include "sys/Sys.hpp"
@@ -11,11 +16,606 @@
 
 using namespace var;
 
+typedef struct {
+	u32 offset; //location of the token in the text
+	u32 aux; //opening bracket: index of the closing bracket; closing bracket: child table + 1 (0 if not built)
+} json_lazy_token_t;
+
+namespace var {
+
+/*
+ * A document loaded with JsonDocument::LAZY.
+ *
+ * When the document is loaded, the text is scanned once and each
+ * bracket, separator and value is recorded as a token. Each opening
+ * bracket stores the index of its closing bracket so values can
+ * be skipped without looking at the text again.
+ *
+ * The first time an object or array is accessed, a table of its children
+ * (plus the hash of each key for objects) is allocated from an ArenaAllocator.
+ * The size of every table is known once the document is indexed, so
+ * the arena is allocated once (when the first table is needed) and never
+ * grows. The arena, tokens and text are freed together when the last
+ * JsonValue referring to the document is destroyed.
+ *
+ */
+class JsonLazyDocument {
+public:
+	JsonLazyDocument(u32 flags){
+		m_flags = flags;
+		m_references = 0;
+		m_text = 0;
+		m_length = 0;
+		m_arena = 0;
+		m_arena_size = 0;
+	}
+
+	~JsonLazyDocument(){
+		delete m_arena;
+		free(m_text);
+	}
+
+	void reference(){ m_references++; }
+	bool dereference(){ return --m_references == 0; }
+
+	int read(json_load_callback_t callback, void * context, u32 size_hint);
+	int copy(const char * text, u32 length);
+	int index(json_error_t * error);
+
+	enum JsonValue::type type(u32 token) const;
+	const u32 * children(u32 token);
+	s32 find(u32 token, const char * key, u32 length);
+	int decode_string(u32 token, var::String & result) const;
+	var::String number(u32 token) const;
+	json_t * to_json(u32 token) const;
+
+	enum {
+		OBJECT_STRIDE = 3, //key hash, key token, value token
+		ARRAY_STRIDE = 1
+	};
+
+private:
+	enum {
+		READ_CHUNK_SIZE =
+#if defined __link
+		65536
+#else
+		512
+#endif
+	};
+
+	u32 m_flags;
+	u32 m_references;
+	char * m_text;
+	u32 m_length;
+	var::Vector<json_lazy_token_t> m_tokens;
+	var::Vector<const u32*> m_tables;
+	var::ArenaAllocator * m_arena;
+	u32 m_arena_size; //bytes needed if every table is built
+
+	char first(u32 token) const { return m_text[m_tokens.at(token).offset]; }
+	bool is_container(u32 token) const { return (first(token) == '{') || (first(token) == '['); }
+	u32 next(u32 token) const { return is_container(token) ? m_tokens.at(token).aux + 1 : token + 1; }
+	s32 string_end(u32 offset) const;
+	u32 scalar_end(u32 offset) const;
+	u32 value_end(u32 token) const;
+	u32 walk(u32 token, u32 * table) const;
+	u32 key_hash(u32 token) const;
+	bool is_key_equal(u32 token, const char * key, u32 length) const;
+	int set_error(json_error_t * error, u32 offset, const char * message) const;
+};
+
+}
+
+static u32 hash_key(const char * key, u32 length){
+	//FNV-1a
+	u32 hash = 2166136261U;
+	for(u32 i=0; i < length; i++){
+		hash = (hash ^ (u8)key[i]) * 16777619U;
+	}
+	return hash;
+}
+
+static bool is_number(const char * text, u32 length){
+	u32 i = 0;
+	if( (i < length) && (text[i] == '-') ){ i++; }
+	if( i == length ){ return false; }
+	if( text[i] == '0' ){
+		i++;
+	} else if( (text[i] >= '1') && (text[i] <= '9') ){
+		while( (i < length) && (text[i] >= '0') && (text[i] <= '9') ){ i++; }
+	} else {
+		return false;
+	}
+	if( (i < length) && (text[i] == '.') ){
+		u32 start = ++i;
+		while( (i < length) && (text[i] >= '0') && (text[i] <= '9') ){ i++; }
+		if( i == start ){ return false; }
+	}
+	if( (i < length) && ((text[i] == 'e') || (text[i] == 'E')) ){
+		i++;
+		if( (i < length) && ((text[i] == '+') || (text[i] == '-')) ){ i++; }
+		u32 start = i;
+		while( (i < length) && (text[i] >= '0') && (text[i] <= '9') ){ i++; }
+		if( i == start ){ return false; }
+	}
+	return i == length;
+}
+
+static int decode_error(var::String & result){
+	result.to<char>()[0] = 0;
+	return -1;
+}
+
+static int decode_hex(const char * text){
+	int value = 0;
+	for(u32 i=0; i < 4; i++){
+		char c = text[i];
+		value <<= 4;
+		if( (c >= '0') && (c <= '9') ){
+			value |= c - '0';
+		} else if( (c >= 'a') && (c <= 'f') ){
+			value |= c - 'a' + 10;
+		} else if( (c >= 'A') && (c <= 'F') ){
+			value |= c - 'A' + 10;
+		} else {
+			return -1;
+		}
+	}
+	return value;
+}
+
+static u32 table_size(u32 count, u32 stride){
+	//matches the 8-byte alignment of ArenaAllocator
+	return (((1 + count*stride) * sizeof(u32)) + 7) & ~7;
+}
+
+int JsonLazyDocument::read(json_load_callback_t callback, void * context, u32 size_hint){
+	//the hint leaves room for the terminator and the final read that returns zero
+	u32 capacity = size_hint ? size_hint + 2 : (u32)READ_CHUNK_SIZE;
+	u32 length = 0;
+	char * text = (char*)malloc(capacity);
+	if( text == 0 ){ return -1; }
+
+	while( 1 ){
+		if( capacity - length < 2 ){
+			char * larger = (char*)realloc(text, capacity*2);
+			if( larger == 0 ){
+				free(text);
+				return -1;
+			}
+			text = larger;
+			capacity *= 2;
+		}
+
+		size_t result = callback(text + length, capacity - length - 1, context);
+		if( result == (size_t)-1 ){
+			free(text);
+			return -1;
+		}
+		if( result == 0 ){ break; }
+		length += result;
+	}
+
+	text[length] = 0;
+	m_text = text;
+	m_length = length;
+	return 0;
+}
+
+int JsonLazyDocument::copy(const char * text, u32 length){
+	m_text = (char*)malloc(length+1);
+	if( m_text == 0 ){ return -1; }
+	memcpy(m_text, text, length);
+	m_text[length] = 0;
+	m_length = length;
+	return 0;
+}
+
+int JsonLazyDocument::set_error(json_error_t * error, u32 offset, const char * message) const {
+	int line = 1;
+	int column = 0;
+	for(u32 i=0; (i < offset) && (i < m_length); i++){
+		if( m_text[i] == '\n' ){
+			line++;
+			column = 0;
+		} else {
+			column++;
+		}
+	}
+	error->line = line;
+	error->column = column;
+	error->position = offset;
+	snprintf(error->source, sizeof(error->source), "<lazy>");
+	snprintf(error->text, sizeof(error->text), "%s", message);
+	return -1;
+}
+
+s32 JsonLazyDocument::string_end(u32 offset) const {
+	u32 i = offset + 1;
+	while( i < m_length ){
+		const char * quote = (const char*)memchr(m_text + i, '"', m_length - i);
+		if( quote == 0 ){ return -1; }
+
+		//the quote is escaped if it follows an odd number of backslashes
+		u32 end = quote - m_text;
+		u32 slashes = 0;
+		while( m_text[end - slashes - 1] == '\\' ){ slashes++; }
+		if( (slashes & 1) == 0 ){ return end; }
+		i = end + 1;
+	}
+	return -1;
+}
+
+u32 JsonLazyDocument::scalar_end(u32 offset) const {
+	while( offset < m_length ){
+		switch(m_text[offset]){
+			case ' ': case '\t': case '\n': case '\r':
+			case ',': case ':': case '"':
+			case '[': case ']': case '{': case '}':
+				return offset;
+		}
+		offset++;
+	}
+	return offset;
+}
+
+u32 JsonLazyDocument::value_end(u32 token) const {
+	u32 offset = m_tokens.at(token).offset;
+	switch(m_text[offset]){
+		case '{':
+		case '[':
+			return m_tokens.at(m_tokens.at(token).aux).offset + 1;
+		case '"':
+			return string_end(offset) + 1;
+	}
+	return scalar_end(offset);
+}
+
+int JsonLazyDocument::index(json_error_t * error){
+	enum {
+		EXPECT_VALUE,
+		EXPECT_VALUE_OR_CLOSE,
+		EXPECT_KEY,
+		EXPECT_KEY_OR_CLOSE,
+		EXPECT_COLON,
+		EXPECT_COMMA_OR_CLOSE,
+		EXPECT_END
+	};
+
+	var::Vector<u32> open; //tokens of the brackets that are not closed yet
+	var::Vector<u32> children; //number of children in each open bracket
+	int state = EXPECT_VALUE;
+	u32 i = 0;
+
+	m_tokens.reserve(m_length/8 + 1);
+
+	while( i < m_length ){
+		char c = m_text[i];
+		if( (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') ){
+			i++;
+			continue;
+		}
+
+		if( state == EXPECT_END ){
+			if( m_flags & JsonDocument::DISABLE_EOF_CHECK ){ break; }
+			return set_error(error, i, "end of file expected");
+		}
+
+		json_lazy_token_t token;
+		token.offset = i;
+		token.aux = 0;
+
+		switch(c){
+			case '{':
+			case '[':
+				if( (state != EXPECT_VALUE) && (state != EXPECT_VALUE_OR_CLOSE) ){
+					return set_error(error, i, "unexpected token");
+				}
+				if( open.count() ){ children.at(children.count()-1)++; }
+				if( (open.push_back(m_tokens.count()) < 0) || (children.push_back(0) < 0) ){
+					return set_error(error, i, "out of memory");
+				}
+				state = (c == '{') ? EXPECT_KEY_OR_CLOSE : EXPECT_VALUE_OR_CLOSE;
+				i++;
+				break;
+
+			case '}':
+			case ']':
+				if( (open.count() == 0) || ((c == '}') != (first(open.at(open.count()-1)) == '{')) ){
+					return set_error(error, i, "unexpected token");
+				}
+				if( (state != EXPECT_COMMA_OR_CLOSE) && (state != ((c == '}') ? EXPECT_KEY_OR_CLOSE : EXPECT_VALUE_OR_CLOSE)) ){
+					return set_error(error, i, "unexpected token");
+				}
+				m_tokens.at(open.at(open.count()-1)).aux = m_tokens.count();
+				m_arena_size += table_size(children.at(children.count()-1), (c == '}') ? OBJECT_STRIDE : ARRAY_STRIDE);
+				open.pop_back();
+				children.pop_back();
+				state = open.count() ? EXPECT_COMMA_OR_CLOSE : EXPECT_END;
+				i++;
+				break;
+
+			case ':':
+				if( state != EXPECT_COLON ){
+					return set_error(error, i, "unexpected token");
+				}
+				state = EXPECT_VALUE;
+				i++;
+				break;
+
+			case ',':
+				if( state != EXPECT_COMMA_OR_CLOSE ){
+					return set_error(error, i, "unexpected token");
+				}
+				state = (first(open.at(open.count()-1)) == '{') ? EXPECT_KEY : EXPECT_VALUE;
+				i++;
+				break;
+
+			case '"':
+			{
+				bool is_key = (state == EXPECT_KEY) || (state == EXPECT_KEY_OR_CLOSE);
+				if( (is_key == false) && (state != EXPECT_VALUE) && (state != EXPECT_VALUE_OR_CLOSE) ){
+					return set_error(error, i, "unexpected token");
+				}
+				if( (open.count() == 0) && ((m_flags & JsonDocument::DECODE_ANY) == 0) ){
+					return set_error(error, i, "'[' or '{' expected");
+				}
+				s32 end = string_end(i);
+				if( end < 0 ){
+					return set_error(error, i, "premature end of input");
+				}
+				if( is_key ){
+					state = EXPECT_COLON;
+				} else {
+					if( open.count() ){ children.at(children.count()-1)++; }
+					state = open.count() ? EXPECT_COMMA_OR_CLOSE : EXPECT_END;
+				}
+				i = end + 1;
+				break;
+			}
+
+			default:
+			{
+				if( (state != EXPECT_VALUE) && (state != EXPECT_VALUE_OR_CLOSE) ){
+					return set_error(error, i, "unexpected token");
+				}
+				if( (open.count() == 0) && ((m_flags & JsonDocument::DECODE_ANY) == 0) ){
+					return set_error(error, i, "'[' or '{' expected");
+				}
+
+				//literals and numbers are checked here but converted when accessed
+				u32 end = scalar_end(i);
+				u32 length = end - i;
+				bool is_valid;
+				switch(c){
+					case 't': is_valid = (length == 4) && (strncmp(m_text + i, "true", 4) == 0); break;
+					case 'f': is_valid = (length == 5) && (strncmp(m_text + i, "false", 5) == 0); break;
+					case 'n': is_valid = (length == 4) && (strncmp(m_text + i, "null", 4) == 0); break;
+					default: is_valid = is_number(m_text + i, length); break;
+				}
+				if( is_valid == false ){
+					return set_error(error, i, "invalid token");
+				}
+				if( open.count() ){ children.at(children.count()-1)++; }
+				state = open.count() ? EXPECT_COMMA_OR_CLOSE : EXPECT_END;
+				i = end;
+				break;
+			}
+		}
+
+		if( m_tokens.push_back(token) < 0 ){
+			return set_error(error, token.offset, "out of memory");
+		}
+	}
+
+	if( state != EXPECT_END ){
+		return set_error(error, m_length, m_tokens.count() ? "premature end of input" : "'[' or '{' expected");
+	}
+	return 0;
+}
+
+enum JsonValue::type JsonLazyDocument::type(u32 token) const {
+	u32 offset = m_tokens.at(token).offset;
+	switch(m_text[offset]){
+		case '{': return JsonValue::OBJECT;
+		case '[': return JsonValue::ARRAY;
+		case '"': return JsonValue::STRING;
+		case 't': return JsonValue::TRUE;
+		case 'f': return JsonValue::FALSE;
+		case 'n': return JsonValue::ZERO;
+	}
+
+	if( m_flags & JsonDocument::DECODE_INT_AS_REAL ){
+		return JsonValue::REAL;
+	}
+
+	u32 end = scalar_end(offset);
+	for(u32 i=offset; i < end; i++){
+		char c = m_text[i];
+		if( (c == '.') || (c == 'e') || (c == 'E') ){
+			return JsonValue::REAL;
+		}
+	}
+	return JsonValue::INTEGER;
+}
+
+u32 JsonLazyDocument::walk(u32 token, u32 * table) const {
+	bool is_object = first(token) == '{';
+	u32 close = m_tokens.at(token).aux;
+	u32 count = 0;
+	u32 i = token + 1;
+
+	//object children are key, colon, value; the comma after each child is skipped
+	while( i < close ){
+		u32 value = is_object ? i + 2 : i;
+		if( table ){
+			if( is_object ){
+				*table++ = key_hash(i);
+				*table++ = i;
+			}
+			*table++ = value;
+		}
+		count++;
+		i = next(value) + 1;
+	}
+	return count;
+}
+
+const u32 * JsonLazyDocument::children(u32 token){
+	if( is_container(token) == false ){ return 0; }
+
+	json_lazy_token_t & close = m_tokens.at(m_tokens.at(token).aux);
+	if( close.aux ){
+		return m_tables.at(close.aux - 1);
+	}
+
+	if( m_arena == 0 ){
+		m_arena = new var::ArenaAllocator(m_arena_size);
+	}
+
+	u32 count = walk(token, 0);
+	u32 stride = first(token) == '{' ? OBJECT_STRIDE : ARRAY_STRIDE;
+	u32 * table = (u32*)m_arena->allocate(table_size(count, stride));
+	if( table == 0 ){ return 0; }
+	table[0] = count;
+	walk(token, table + 1);
+
+	if( m_tables.push_back(table) < 0 ){ return table; }
+	close.aux = m_tables.count();
+	return table;
+}
+
+u32 JsonLazyDocument::key_hash(u32 token) const {
+	u32 offset = m_tokens.at(token).offset;
+	u32 length = string_end(offset) - offset - 1;
+	const char * key = m_text + offset + 1;
+	if( memchr(key, '\\', length) ){
+		var::String decoded;
+		decode_string(token, decoded);
+		return hash_key(decoded.cstring(), decoded.length());
+	}
+	return hash_key(key, length);
+}
+
+bool JsonLazyDocument::is_key_equal(u32 token, const char * key, u32 length) const {
+	u32 offset = m_tokens.at(token).offset;
+	u32 raw_length = string_end(offset) - offset - 1;
+	const char * raw = m_text + offset + 1;
+	if( memchr(raw, '\\', raw_length) ){
+		var::String decoded;
+		decode_string(token, decoded);
+		return (decoded.length() == length) && (memcmp(decoded.cstring(), key, length) == 0);
+	}
+	return (raw_length == length) && (memcmp(raw, key, length) == 0);
+}
+
+s32 JsonLazyDocument::find(u32 token, const char * key, u32 length){
+	if( first(token) != '{' ){ return -1; }
+	const u32 * table = children(token);
+	if( table == 0 ){ return -1; }
+
+	u32 hash = hash_key(key, length);
+	//the last duplicate key wins (the same as a regular document)
+	for(u32 i=table[0]; i > 0; i--){
+		const u32 * entry = table + 1 + (i-1)*OBJECT_STRIDE;
+		if( (entry[0] == hash) && is_key_equal(entry[1], key, length) ){
+			return entry[2];
+		}
+	}
+	return -1;
+}
+
+int JsonLazyDocument::decode_string(u32 token, var::String & result) const {
+	u32 offset = m_tokens.at(token).offset;
+	u32 length = string_end(offset) - offset - 1;
+	const char * text = m_text + offset + 1;
+
+	//escapes never decode to more bytes than they use in the text
+	if( result.set_capacity(length + 1) < 0 ){ return -1; }
+	char * output = result.to<char>();
+	if( output == 0 ){ return -1; }
+
+	//string contents are checked here rather than when the document is indexed
+	for(u32 i=0; i < length;){
+		char c = text[i++];
+		if( c != '\\' ){
+			if( (u8)c < 0x20 ){ return decode_error(result); }
+			*output++ = c;
+			continue;
+		}
+
+		c = text[i++];
+		switch(c){
+			case 'b': *output++ = '\b'; break;
+			case 'f': *output++ = '\f'; break;
+			case 'n': *output++ = '\n'; break;
+			case 'r': *output++ = '\r'; break;
+			case 't': *output++ = '\t'; break;
+			case '"': case '\\': case '/': *output++ = c; break;
+			case 'u':
+			{
+				s32 code = (i + 4 <= length) ? decode_hex(text + i) : -1;
+				if( code < 0 ){ return decode_error(result); }
+				i += 4;
+				if( (code >= 0xd800) && (code < 0xdc00) ){
+					s32 low = -1;
+					if( (i + 6 <= length) && (text[i] == '\\') && (text[i+1] == 'u') ){
+						low = decode_hex(text + i + 2);
+					}
+					if( (low < 0xdc00) || (low >= 0xe000) ){ return decode_error(result); }
+					code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+					i += 6;
+				} else if( (code >= 0xdc00) && (code < 0xe000) ){
+					return decode_error(result);
+				}
+
+				if( code < 0x80 ){
+					*output++ = code;
+				} else if( code < 0x800 ){
+					*output++ = 0xc0 | (code >> 6);
+					*output++ = 0x80 | (code & 0x3f);
+				} else if( code < 0x10000 ){
+					*output++ = 0xe0 | (code >> 12);
+					*output++ = 0x80 | ((code >> 6) & 0x3f);
+					*output++ = 0x80 | (code & 0x3f);
+				} else {
+					*output++ = 0xf0 | (code >> 18);
+					*output++ = 0x80 | ((code >> 12) & 0x3f);
+					*output++ = 0x80 | ((code >> 6) & 0x3f);
+					*output++ = 0x80 | (code & 0x3f);
+				}
+				break;
+			}
+			default:
+				return decode_error(result);
+		}
+	}
+
+	*output = 0;
+	return 0;
+}
+
+var::String JsonLazyDocument::number(u32 token) const {
+	u32 offset = m_tokens.at(token).offset;
+	return var::String(var::ConstString(m_text + offset), scalar_end(offset) - offset);
+}
+
+json_t * JsonLazyDocument::to_json(u32 token) const {
+	json_error_t error;
+	u32 offset = m_tokens.at(token).offset;
+	return JsonValue::api()->loadb(m_text + offset, value_end(token) - offset,
+											 JSON_DECODE_ANY | (m_flags & JsonDocument::DECODE_INT_AS_REAL),
+											 &error);
+}
+
 JsonApi JsonValue::m_api;
 
 JsonValue::JsonValue(){
 	if( api().is_valid() == false ){ exit_fatal("json api missing"); }
 	m_value = 0; //create() method from children are not available in the constructor
+	m_document = 0;
+	m_token = 0;
 }
 
 JsonValue::JsonValue(json_t * value){
@@ -25,31 +625,68 @@ JsonValue::JsonValue(json_t * value){
 
 JsonValue::JsonValue(const JsonValue & value){
 	if( api().is_valid() == false ){ exit_fatal("json api missing"); }
-	add_reference(value.m_value);
+	add_reference(value);
+}
+
+JsonValue::JsonValue(JsonLazyDocument * document, u32 token){
+	m_value = 0;
+	m_document = document;
+	m_token = token;
+	document->reference();
 }
 
 JsonValue & JsonValue::operator=(const JsonValue & value){
-	api()->decref(m_value);
-	add_reference(value.m_value);
+	if( this != &value ){
+		api()->decref(m_value);
+		release();
+		add_reference(value);
+	}
 	return *this;
 }
 
 void JsonValue::add_reference(json_t * value){
 	m_value = value;
+	m_document = 0;
+	m_token = 0;
 	api()->incref(value);
 }
 
+void JsonValue::add_reference(const JsonValue & value){
+	add_reference(value.m_value);
+	m_document = value.m_document;
+	m_token = value.m_token;
+	if( m_document ){
+		m_document->reference();
+	}
+}
+
+void JsonValue::release(){
+	//the document (and its arena) is freed with the last value that refers to it
+	if( m_document && m_document->dereference() ){
+		delete m_document;
+	}
+	m_document = 0;
+}
+
 JsonValue::JsonValue(JsonValue && a){
 	if( this != &a ){
 		m_value = a.m_value;
+		m_document = a.m_document;
+		m_token = a.m_token;
 		a.m_value = 0;
+		a.m_document = 0;
 	}
 }
 
 JsonValue& JsonValue::operator=(JsonValue && a){
 	if( this != &a ){
+		api()->decref(m_value);
+		release();
 		m_value = a.m_value;
+		m_document = a.m_document;
+		m_token = a.m_token;
 		a.m_value = 0;
+		a.m_document = 0;
 	}
 	return *this;
 }
@@ -58,6 +695,28 @@ JsonValue::~JsonValue(){
 	//only decref if object was create (not just a reference)
 	api()->decref(m_value);
 	m_value = 0;
+	release();
+}
+
+enum JsonValue::type JsonValue::lazy_type() const {
+	return m_document->type(m_token);
+}
+
+int JsonValue::materialize(){
+	if( m_document == 0 ){ return 0; }
+	m_value = m_document->to_json(m_token);
+	release();
+	if( m_value == 0 ){ return -1; }
+	return 0;
+}
+
+JsonValue JsonValue::to_regular() const {
+	if( m_document ){
+		JsonValue result;
+		result.m_value = m_document->to_json(m_token);
+		return result;
+	}
+	return *this;
 }
 
 
@@ -78,6 +737,7 @@ JsonArray & JsonValue::to_array(){
 }
 
 int JsonValue::create_if_not_valid(){
+	if( materialize() < 0 ){ return -1; }
 	if( is_valid() ){ return 0; }
 	m_value = create();
 	if( m_value == 0 ){ return -1; }
@@ -85,6 +745,7 @@ int JsonValue::create_if_not_valid(){
 }
 
 int JsonValue::assign(const var::ConstString & value){
+	if( materialize() < 0 ){ return -1; }
 	if( is_string() ){
 		return api()->string_set(m_value, value.cstring());
 	} else if( is_real() ){
@@ -117,6 +778,12 @@ int JsonValue::assign(bool value){
 
 int JsonValue::copy(const JsonValue & value, bool is_deep){
 	api()->decref(m_value);
+	release();
+	if( value.m_document ){
+		//converting a lazy value always creates a new (deep) copy
+		m_value = value.m_document->to_json(value.m_token);
+		return m_value ? 0 : -1;
+	}
 	if( is_deep ){
 		m_value = api()->deep_copy(value.m_value);
 	} else {
@@ -127,6 +794,16 @@ int JsonValue::copy(const JsonValue & value, bool is_deep){
 
 var::String JsonValue::to_string() const {
 	var::String result;
+	if( m_document ){
+		//lazy values are converted straight from the document text
+		switch(lazy_type()){
+			case STRING: m_document->decode_string(m_token, result); return result;
+			case REAL: result.format("%f", ::atof(m_document->number(m_token).cstring())); return result;
+			case INTEGER: result.format("%ld", (long)::atoll(m_document->number(m_token).cstring())); return result;
+			default: break;
+		}
+	}
+
 	if( is_string() ){
 		result = api()->string_value(m_value);
 	} else if( is_real() ){
@@ -153,6 +830,10 @@ float JsonValue::to_float() const {
 	if( is_string() ){
 		return to_string().to_float();
 	}
+	if( m_document ){
+		//same as a regular value: only reals have a real value
+		return is_real() ? ::atof(m_document->number(m_token).cstring()) : 0.0f;
+	}
 	return api()->real_value(m_value);
 }
 
@@ -160,6 +841,9 @@ int JsonValue::to_integer() const {
 	if( is_string() ){
 		return to_string().to_integer();
 	}
+	if( m_document ){
+		return is_integer() ? ::atoll(m_document->number(m_token).cstring()) : 0;
+	}
 	return api()->integer_value(m_value);
 }
 
@@ -186,12 +870,15 @@ JsonObject::JsonObject(){
 }
 
 JsonObject::JsonObject(const JsonObject & value){
-	add_reference(value.m_value);
+	add_reference(value);
 }
 
 JsonObject & JsonObject::operator=(const JsonObject & value){
-	api()->decref(m_value);
-	add_reference(value.m_value);
+	if( this != &value ){
+		api()->decref(m_value);
+		release();
+		add_reference(value);
+	}
 	return *this;
 }
 
@@ -233,7 +920,8 @@ int JsonObject::insert(const var::ConstString & key, const JsonValue & value){
 		return -1;
 	}
 
-	int result = api()->object_set(m_value, key.cstring(), value.m_value);
+	JsonValue item = value.to_regular();
+	int result = api()->object_set(m_value, key.cstring(), item.m_value);
 	if( result < 0 ){
 		//printf("Failed to set JSON key %s to %s %p\n", key.cstring(), value.to_string().cstring(), m_value);
 	}
@@ -241,32 +929,56 @@ int JsonObject::insert(const var::ConstString & key, const JsonValue & value){
 }
 
 int JsonObject::update(const JsonValue & value, u8 o_flags){
+	if( materialize() < 0 ){ return -1; }
+	JsonValue item = value.to_regular();
+
 	if( o_flags & UPDATE_EXISTING ){
-		return api()->object_update_existing(m_value, value.m_value);
+		return api()->object_update_existing(m_value, item.m_value);
 	}
 
 	if( o_flags & UPDATE_MISSING ){
-		return api()->object_update_missing(m_value, value.m_value);
+		return api()->object_update_missing(m_value, item.m_value);
 	}
 
-	return api()->object_update(m_value, value.m_value);
+	return api()->object_update(m_value, item.m_value);
 }
 
 int JsonObject::remove(const var::ConstString & key){
+	if( materialize() < 0 ){ return -1; }
 	return api()->object_del(m_value, key.cstring());
 }
 
 u32 JsonObject::count() const {
+	if( m_document ){
+		const u32 * table = is_object() ? m_document->children(m_token) : 0;
+		return table ? table[0] : 0;
+	}
 	return api()->object_size(m_value);
 }
 
-int JsonObject::clear(){ return json_object_clear(m_value); }
+int JsonObject::clear(){
+	if( materialize() < 0 ){ return -1; }
+	return json_object_clear(m_value);
+}
 
 var::Vector<var::String> JsonObject::keys() const {
 	const char *key;
 	json_t *value;
 	var::Vector<var::String> result;
 
+	if( m_document ){
+		const u32 * table = is_object() ? m_document->children(m_token) : 0;
+		if( table ){
+			result.reserve(table[0]);
+			for(u32 i=0; i < table[0]; i++){
+				var::String name;
+				m_document->decode_string(table[1 + i*JsonLazyDocument::OBJECT_STRIDE + 1], name);
+				result.push_back(name);
+			}
+		}
+		return result;
+	}
+
 	for(key = api()->object_iter_key(api()->object_iter(m_value));
 		 key && (value = api()->object_iter_value(api()->object_key_to_iter(key)));
 		 key = api()->object_iter_key(api()->object_iter_next(m_value, api()->object_key_to_iter(key)))){
@@ -277,6 +989,11 @@ var::Vector<var::String> JsonObject::keys() const {
 }
 
 JsonValue JsonObject::at(const var::ConstString & key) const {
+	if( m_document ){
+		s32 token = m_document->find(m_token, key.cstring(), key.length());
+		if( token < 0 ){ return JsonValue(); }
+		return JsonValue(m_document, token);
+	}
 	return api()->object_get(m_value, key.cstring());
 }
 
@@ -285,43 +1002,60 @@ JsonArray::JsonArray(){
 }
 
 JsonArray::JsonArray(const JsonArray & value){
-	add_reference(value.m_value);
+	add_reference(value);
 }
 
 JsonArray & JsonArray::operator=(const JsonArray & value){
-	api()->decref(m_value);
-	add_reference(value.m_value);
+	if( this != &value ){
+		api()->decref(m_value);
+		release();
+		add_reference(value);
+	}
 	return *this;
 }
 
 u32 JsonArray::count() const {
+	if( m_document ){
+		const u32 * table = is_array() ? m_document->children(m_token) : 0;
+		return table ? table[0] : 0;
+	}
 	return api()->array_size(m_value);
 }
 
 JsonValue JsonArray::at(u32 idx) const {
+	if( m_document ){
+		const u32 * table = is_array() ? m_document->children(m_token) : 0;
+		if( (table == 0) || (idx >= table[0]) ){ return JsonValue(); }
+		return JsonValue(m_document, table[1 + idx]);
+	}
 	return api()->array_get(m_value, idx);
 }
 
 int JsonArray::append(const JsonValue & value){
 	if( create_if_not_valid() < 0 ){ return -1; }
-	return api()->array_append(m_value, value.m_value);
+	JsonValue item = value.to_regular();
+	return api()->array_append(m_value, item.m_value);
 }
 
 int JsonArray::append(const JsonArray & array){
 	if( create_if_not_valid() < 0 ){ return -1; }
-	return api()->array_extend(m_value, array.m_value);
+	JsonValue items = array.to_regular();
+	return api()->array_extend(m_value, items.m_value);
 }
 
 int JsonArray::insert(u32 idx, const JsonValue & value){
 	if( create_if_not_valid() < 0 ){ return -1; }
-	return api()->array_insert(m_value, idx, value.m_value);
+	JsonValue item = value.to_regular();
+	return api()->array_insert(m_value, idx, item.m_value);
 }
 
 int JsonArray::remove(u32 idx){
+	if( materialize() < 0 ){ return -1; }
 	return api()->array_remove(m_value, idx);
 }
 
 int JsonArray::clear(){
+	if( materialize() < 0 ){ return -1; }
 	return api()->array_clear(m_value);
 }
 
@@ -378,23 +1112,68 @@ JsonFalse::JsonFalse(){
 
 JsonValue JsonDocument::load_from_file(const var::ConstString & path){
 	JsonValue value;
-	value.m_value = JsonValue::api()->load_file(path.cstring(), flags(), &m_error.m_value);
+	if( flags() & LAZY ){
+		sys::File f;
+		if( f.open(path, sys::File::RDONLY) < 0 ){
+			memset(&m_error.m_value, 0, sizeof(m_error.m_value));
+			snprintf(m_error.m_value.source, sizeof(m_error.m_value.source), "%s", path.cstring());
+			snprintf(m_error.m_value.text, sizeof(m_error.m_value.text), "unable to open %s", path.cstring());
+			return value;
+		}
+		return load_lazy(load_file_data, &f, f.size());
+	}
+	value.m_value = JsonValue::api()->load_file(path.cstring(), jansson_flags(), &m_error.m_value);
 	return value;
 }
 
 JsonValue JsonDocument::load_from_string(const var::ConstString & json){
 	JsonValue value;
-	value.m_value = JsonValue::api()->loadb(json.cstring(), json.length(), flags(), &m_error.m_value);
+	if( flags() & LAZY ){
+		JsonLazyDocument * document = new JsonLazyDocument(flags());
+		memset(&m_error.m_value, 0, sizeof(m_error.m_value));
+		if( document->copy(json.cstring(), json.length()) < 0 ){
+			delete document;
+			set_error_number(ENOMEM);
+			return value;
+		}
+		if( document->index(&m_error.m_value) < 0 ){
+			delete document;
+			return value;
+		}
+		return JsonValue(document, 0);
+	}
+	value.m_value = JsonValue::api()->loadb(json.cstring(), json.length(), jansson_flags(), &m_error.m_value);
 	return value;
 }
 
 //only use on Stratify OS
 JsonValue JsonDocument::load_from_file(const sys::File & file){
 	JsonValue value;
-	value.m_value = JsonValue::api()->loadfd(file.fileno(), flags(), &m_error.m_value);
+	if( flags() & LAZY ){
+		return load_lazy(load_file_data, (void*)&file, 0);
+	}
+	value.m_value = JsonValue::api()->loadfd(file.fileno(), jansson_flags(), &m_error.m_value);
 	return value;
 }
 
+JsonValue JsonDocument::load_lazy(json_load_callback_t callback, void * context, u32 size_hint){
+	JsonLazyDocument * document = new JsonLazyDocument(flags());
+	memset(&m_error.m_value, 0, sizeof(m_error.m_value));
+
+	if( document->read(callback, context, size_hint) < 0 ){
+		delete document;
+		snprintf(m_error.m_value.text, sizeof(m_error.m_value.text), "read error");
+		return JsonValue();
+	}
+
+	if( document->index(&m_error.m_value) < 0 ){
+		delete document;
+		return JsonValue();
+	}
+
+	return JsonValue(document, 0);
+}
+
 size_t JsonDocument::load_file_data(void *buffer, size_t buflen, void *data){
 	const sys::File * f = (const sys::File *)data;
 	return f->read(buffer, buflen);
@@ -402,28 +1181,35 @@ size_t JsonDocument::load_file_data(void *buffer, size_t buflen, void *data){
 
 JsonValue JsonDocument::load(const sys::File & file){
 	JsonValue value;
-	value.m_value = JsonValue::api()->load_callback(load_file_data, (void*)&file, flags(), &m_error.m_value);
+	if( flags() & LAZY ){
+		return load_lazy(load_file_data, (void*)&file, 0);
+	}
+	value.m_value = JsonValue::api()->load_callback(load_file_data, (void*)&file, jansson_flags(), &m_error.m_value);
 	return value;
 }
 
 JsonValue JsonDocument::load(json_load_callback_t callback, void * context){
 	JsonValue value;
-	value.m_value = JsonValue::api()->load_callback(callback, context, flags(), &m_error.m_value);
+	if( flags() & LAZY ){
+		return load_lazy(callback, context, 0);
+	}
+	value.m_value = JsonValue::api()->load_callback(callback, context, jansson_flags(), &m_error.m_value);
 	return value;
 }
 
 int JsonDocument::save_to_file(const JsonValue & value, const var::ConstString & path) const {
+	JsonValue regular = value.to_regular();
 	sys::File f;
 	int result;
 
 #if defined __win32
-	result = JsonValue::api()->dump_file(value.m_value, path.cstring(), flags());
+	result = JsonValue::api()->dump_file(regular.m_value, path.cstring(), jansson_flags());
 #else
 	if( f.create(path) < 0 ){
 		set_error_number(f.error_number());
 		return -1;
 	}
-	result = JsonValue::api()->dumpfd(value.m_value, f.fileno(), flags());
+	result = JsonValue::api()->dumpfd(regular.m_value, f.fileno(), jansson_flags());
 
 	if( f.close() < 0 ){
 		set_error_number(f.error_number());
@@ -435,7 +1221,8 @@ int JsonDocument::save_to_file(const JsonValue & value, const var::ConstString &
 }
 
 var::String JsonDocument::stringify(const JsonValue & value) const {
-	u32 size = JsonValue::api()->dumpb(value.m_value, 0, 0, flags());
+	JsonValue regular = value.to_regular();
+	u32 size = JsonValue::api()->dumpb(regular.m_value, 0, 0, jansson_flags());
 	if( size == 0 ){
 		return var::String();
 	}
@@ -443,18 +1230,78 @@ var::String JsonDocument::stringify(const JsonValue & value) const {
 	if( result.set_capacity(size) < 0 ){
 		return var::String();
 	}
-	if( JsonValue::api()->dumpb(value.m_value, result.to<char>(), result.capacity(), flags()) == 0 ){
+	if( JsonValue::api()->dumpb(regular.m_value, result.to<char>(), result.capacity(), jansson_flags()) == 0 ){
 		return var::String();
 	}
 	return result;
 }
 
+typedef struct {
+	const sys::File * file;
+	var::Data buffer;
+	u32 size; //bytes waiting in buffer
+	int result;
+} json_save_context_t;
+
+static int write_save_data(json_save_context_t * context, const void * data, u32 size){
+	u32 offset = 0;
+	//sockets may accept less than the whole buffer
+	while( offset < size ){
+		int result = context->file->write((const u8*)data + offset, size - offset);
+		if( result <= 0 ){
+			context->result = -1;
+			return -1;
+		}
+		offset += result;
+	}
+	return 0;
+}
+
+static int flush_save_data(json_save_context_t * context){
+	int result = write_save_data(context, context->buffer.to_u8(), context->size);
+	context->size = 0;
+	return result;
+}
+
+static int save_file_data(const char * buffer, size_t size, void * data){
+	json_save_context_t * context = (json_save_context_t*)data;
+
+	//jansson writes one token at a time so the pieces are collected before they are written
+	if( context->size + size > context->buffer.size() ){
+		if( flush_save_data(context) < 0 ){ return -1; }
+		if( size > context->buffer.size() ){
+			return write_save_data(context, buffer, size);
+		}
+	}
+	memcpy(context->buffer.to_u8() + context->size, buffer, size);
+	context->size += size;
+	return 0;
+}
+
 int JsonDocument::save_to_file(const JsonValue & value, const sys::File & file) const {
-	return JsonValue::api()->dumpfd(value.m_value, file.fileno(), flags());
+	JsonValue regular = value.to_regular();
+	json_save_context_t context;
+	int result;
+
+	context.file = &file;
+	context.size = 0;
+	context.result = 0;
+	if( context.buffer.set_size(SAVE_BUFFER_SIZE) < 0 ){
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	result = JsonValue::api()->dump_callback(regular.m_value, save_file_data, &context, jansson_flags());
+	if( (result < 0) || (flush_save_data(&context) < 0) ){
+		set_error_number(file.error_number());
+		return -1;
+	}
+	return result;
 }
 
 int JsonDocument::save(const JsonValue & value, json_dump_callback_t callback, void * context) const {
-	return JsonValue::api()->dump_callback(value.m_value, callback, context, flags());
+	JsonValue regular = value.to_regular();
+	return JsonValue::api()->dump_callback(regular.m_value, callback, context, jansson_flags());
 }
 
 
@@ -1,6 +1,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
+#include <errno.h>
 
 #include "var/LinkedList.hpp"
 
@@ -10,6 +11,32 @@ LinkedList::LinkedList(u32 size){
 	m_list_size = size;
 	m_front = 0;
 	m_back = 0;
+	m_allocator = 0;
+}
+
+int LinkedList::set_allocator(Allocator * allocator){
+	if( m_front ){
+		//items must be returned to the allocator they came from
+		set_error_number(EINVAL);
+		return -1;
+	}
+	m_allocator = allocator;
+	return 0;
+}
+
+LinkedList::item_t * LinkedList::new_item(){
+	if( m_allocator ){
+		return (item_t*)m_allocator->allocate(calc_item_size());
+	}
+	return (item_t*)malloc(calc_item_size());
+}
+
+void LinkedList::delete_item(item_t * item){
+	if( m_allocator ){
+		m_allocator->deallocate(item);
+	} else {
+		::free(item);
+	}
 }
 
 LinkedList::~LinkedList(){
@@ -20,18 +47,25 @@ void LinkedList::swap(LinkedList & list){
 	u16 size;
 	item_t * front;
 	item_t * back;
+	Allocator * allocator;
 	front = this->m_front;
 	back = this->m_back;
 	size = this->m_list_size;
+	allocator = this->m_allocator;
 	this->m_front = list.m_front;
 	this->m_back = list.m_back;
 	this->m_list_size = list.m_list_size;
+	this->m_allocator = list.m_allocator;
 	list.m_front = front;
 	list.m_back = back;
 	list.m_list_size = size;
+	list.m_allocator = allocator;
 }
 
 LinkedList::LinkedList(const LinkedList & list){
+	m_front = 0;
+	m_back = 0;
+	m_allocator = 0;
 	assign(list);
 }
 
@@ -41,6 +75,10 @@ LinkedList & LinkedList::operator=(const LinkedList & list){
 }
 
 LinkedList::LinkedList(LinkedList && list){
+	m_list_size = list.m_list_size;
+	m_front = 0;
+	m_back = 0;
+	m_allocator = 0;
 	swap(list);
 }
 
@@ -87,7 +125,7 @@ void LinkedList::clear(){
 	if( m_front ){
 		do {
 			next_item = next(m_front);
-			::free(m_front);
+			delete_item(m_front);
 			m_front = next_item;
 		} while( m_front );
 		m_front = 0;
@@ -125,11 +163,11 @@ void LinkedList::pop_back(){
 	previous_item = previous(m_back);
 	if( previous_item ){
 		m_back = previous_item;
-		::free(m_back->next);
+		delete_item(next(m_back));
 		m_back->next = 0;
 	} else if( m_back ){
 		//current item is the only item
-		::free(m_back);
+		delete_item(m_back);
 		m_back = 0;
 		m_front = 0;
 	}
@@ -139,12 +177,12 @@ void LinkedList::pop_back(){
 void LinkedList::pop_front(){
 	item_t * next_item = next(m_front);
 	if( next_item ){
-		::free(m_front);
+		delete_item(m_front);
 		m_front = next_item;
 		m_front->previous = 0;
 	} else if( m_front ){
 		//current item is the only item
-		::free(m_front);
+		delete_item(m_front);
 		m_back = 0;
 		m_front = 0;
 	}
@@ -24,6 +24,11 @@ String::String(const ConstString & s, u32 len){
 	assign(s, len);
 }
 
+String::String(char * mem, u32 capacity, bool is_read_only){
+	refer_to(mem, capacity, is_read_only);
+	set_string_pointer(cdata_const());
+}
+
 u32 String::capacity() const {
 	if( Data::capacity() ){
 		return Data::capacity() - 1;
@@ -51,15 +56,19 @@ int String::sprintf(const char * format, ...){
 
 int String::vformat(const char * fmt, va_list list){
 	int result;
+	va_list list_copy;
 	if( capacity() == 0 ){
 		set_size(minimum_size());
 	}
-	result = vsnprintf(to_char(), capacity()-1, fmt, list);
-	if( result >= (int)capacity()-1 ){ //if the data did not fit, make the buffer bigger
-		if( set_capacity(result+1) >= 0 ){
-			vsnprintf(to_char(), capacity()-1, fmt, list);
+	//the list may be needed a second time if the output doesn't fit
+	va_copy(list_copy, list);
+	result = vsnprintf(to_char(), capacity()+1, fmt, list);
+	if( result > (int)capacity() ){ //if the data did not fit, make the buffer bigger
+		if( set_capacity(result) >= 0 ){
+			vsnprintf(to_char(), capacity()+1, fmt, list_copy);
 		}
 	}
+	va_end(list_copy);
 	return result;
 }
 
@@ -73,6 +82,26 @@ int String::set_size(u32 s){
 	return result;
 }
 
+int String::reserve(u32 s){
+	bool is_zero_size = (to_void() == 0);
+	int result = Data::reserve(s+1);
+	set_string_pointer(cdata_const());
+	if( is_zero_size ){
+		fill(0);
+	}
+	return result;
+}
+
+int String::shrink_to_fit(){
+	int result;
+	if( Data::set_size(length()+1) < 0 ){
+		return -1;
+	}
+	result = Data::shrink_to_fit();
+	set_string_pointer(cdata_const());
+	return result;
+}
+
 int String::assign(const ConstString & a){
 	return assign(a, a.length());
 }
@@ -82,8 +111,10 @@ int String::assign(const ConstString & a, u32 n){
 	if( a.cstring() != this->to_char() ){ //check for assignment to self - no action needed
 		if( n == (u32)npos ){ n = a.length(); }
 		if( set_capacity(n) < 0 ){ return -1; }
-		clear();
-		strncpy(to_char(), a.cstring(), n);
+		//copy up to the terminator rather than clearing the whole capacity
+		u32 len = strnlen(a.cstring(), n);
+		::memcpy(to_char(), a.cstring(), len);
+		to_char()[len] = 0;
 	}
 	return 0;
 }
@@ -194,6 +225,7 @@ String String::substr(u32 pos, u32 len) const {
 		return String();
 	}
 	String ret;
+	if( len > length() - pos ){ len = length() - pos; }
 	ret.assign(str() + pos, len);
 	return ret;
 }
@@ -234,6 +266,79 @@ const char * PathString::file_name() const{
 	return c_str();
 }
 
+StringBuilder::StringBuilder(u32 capacity) : m_string(m_inline, INLINE_CAPACITY+1){
+	m_length = 0;
+	m_inline[0] = 0;
+	reserve(capacity);
+}
+
+int StringBuilder::reserve(u32 capacity){
+	if( capacity <= m_string.capacity() ){
+		return 0;
+	}
 
+	if( is_inline() ){
+		String heap;
+		if( heap.set_capacity(capacity) < 0 ){
+			set_error_number(heap.error_number());
+			return -1;
+		}
+		::memcpy(heap.to_char(), m_inline, m_length+1);
+		m_string = std::move(heap);
+		return 0;
+	}
 
+	//grow geometrically so appending n characters is O(n)
+	if( capacity < m_string.capacity()*2 ){
+		capacity = m_string.capacity()*2;
+	}
 
+	if( m_string.set_capacity(capacity) < 0 ){
+		set_error_number(m_string.error_number());
+		return -1;
+	}
+	return 0;
+}
+
+int StringBuilder::append(const char * a, u32 length){
+	if( reserve(m_length + length) < 0 ){
+		return -1;
+	}
+	::memcpy(m_string.to_char() + m_length, a, length);
+	m_length += length;
+	m_string.to_char()[m_length] = 0;
+	return 0;
+}
+
+StringBuilder & StringBuilder::append_format(const char * format, ...){
+	va_list args;
+	int result;
+
+	va_start(args, format);
+	result = vsnprintf(m_string.to_char() + m_length, m_string.capacity() - m_length + 1, format, args);
+	va_end(args);
+
+	if( result < 0 ){
+		m_string.to_char()[m_length] = 0;
+		return *this;
+	}
+
+	if( m_length + result > m_string.capacity() ){
+		//didn't fit -- make room and format again
+		if( reserve(m_length + result) < 0 ){
+			m_string.to_char()[m_length] = 0;
+			return *this;
+		}
+		va_start(args, format);
+		vsnprintf(m_string.to_char() + m_length, m_string.capacity() - m_length + 1, format, args);
+		va_end(args);
+	}
+
+	m_length += result;
+	return *this;
+}
+
+void StringBuilder::clear(){
+	m_length = 0;
+	m_string.to_char()[0] = 0;
+}
@@ -17,6 +17,73 @@ Tokenizer::Tokenizer(const ConstString & src, const ConstString & delim, const C
 	parse(delim, ignore, max_delim);
 }
 
+CharacterSet::CharacterSet(const ConstString & characters){
+	const char * p = characters.cstring();
+	memset(m_table, 0, sizeof(m_table));
+	m_is_empty = true;
+	while( *p != 0 ){
+		m_table[(u8)*p >> 5] |= (1UL << ((u8)*p & 0x1f));
+		m_is_empty = false;
+		p++;
+	}
+}
+
+ConstTokenizer::ConstTokenizer(const ConstString & src, const ConstString & delim, const ConstString & ignore, bool count_empty, u32 max_delim){
+	m_source = "";
+	parse(src, delim, ignore, count_empty, max_delim);
+}
+
+int ConstTokenizer::add_token(u32 offset, u32 length){
+	token_t token;
+	token.offset = offset;
+	token.length = length;
+	if( m_tokens.push_back(token) < 0 ){
+		set_error_number(m_tokens.error_number());
+		return -1;
+	}
+	return 0;
+}
+
+int ConstTokenizer::parse(const ConstString & src, const ConstString & delim, const ConstString & ignore, bool count_empty, u32 max_delim){
+	CharacterSet delimiters(delim);
+	CharacterSet ignores(ignore);
+	const char * s = src.cstring();
+	u32 start = 0;
+	u32 i = 0;
+
+	m_source = s;
+	m_tokens.clear();
+
+	while( s[i] != 0 ){
+		char c = s[i];
+
+		if( !ignores.is_empty() && ignores.is_member(c) ){
+			//skip to the matching character -- delimiters inside don't split the token
+			const char * match = strchr(s + i + 1, c);
+			if( match == 0 ){
+				i += strlen(s + i);
+				break;
+			}
+			i = (match - s) + 1;
+			continue;
+		}
+
+		if( delimiters.is_member(c) && ((max_delim == 0) || (m_tokens.count() < max_delim)) ){
+			if( count_empty || (i > start) ){
+				if( add_token(start, i - start) < 0 ){ return -1; }
+			}
+			start = i+1;
+		}
+		i++;
+	}
+
+	if( count_empty || (i > start) ){
+		if( add_token(start, i - start) < 0 ){ return -1; }
+	}
+
+	return m_tokens.count();
+}
+
 bool Tokenizer::belongs_to(const char c, const ConstString & src, unsigned int len){
 	unsigned int i;
 	const char * s = src.str();
@@ -35,14 +102,18 @@ void Tokenizer::init_members(){
 
 
 void Tokenizer::parse(const ConstString & delim, const ConstString & ignore, u32 max_delim){
+	parse_tokens(delim, ignore, max_delim);
+	index_tokens();
+}
+
+void Tokenizer::parse_tokens(const ConstString & delim, const ConstString & ignore, u32 max_delim){
 	char * p;
 	char * end;
-	unsigned int len0, len1;
+	CharacterSet delimiters(delim);
+	CharacterSet ignores(ignore);
 	bool on_token = false;
 	char end_match;
 	m_num_tokens = 0;
-	len0 = delim.length();
-	len1 = ignore.length();
 
 	p = cdata();
 	m_string_size = String::length();
@@ -51,9 +122,9 @@ void Tokenizer::parse(const ConstString & delim, const ConstString & ignore, u32
 		m_num_tokens++;
 	}
 	while( p < end ){
-		if( len1 > 0 ){
+		if( ignores.is_empty() == false ){
 			//this can be used to skip items in quotes "ignore=this" when delim includes = (don't split it)
-			while( belongs_to(*p, ignore, len1) ){
+			while( ignores.is_member(*p) ){
 				end_match = *p;
 				//fast forward to next member of ignore that matches the first
 				p++;
@@ -78,7 +149,7 @@ void Tokenizer::parse(const ConstString & delim, const ConstString & ignore, u32
 		}
 
 		//check to see if the current character is part of the delimiter string
-		if( belongs_to(*p, delim, len0) ){
+		if( delimiters.is_member(*p) ){
 			*p = 0; //set the character to zero
 			if( m_is_count_empty_tokens == true ){
 				m_num_tokens++;
@@ -103,36 +174,38 @@ void Tokenizer::parse(const ConstString & delim, const ConstString & ignore, u32
 	}
 }
 
-const ConstString Tokenizer::at(u32 n) const {
-	const char * p;
-	unsigned int i;
-	bool on_token = false;
-	unsigned int token = 0;
-	p = str();
+void Tokenizer::index_tokens(){
+	const char * start = str();
+	const char * p = start;
+	const char * end = start + m_string_size;
+	bool on_token;
 
-	if( n >= size() ){
-		return ConstString();
+	//one pass records where each token starts so at() doesn't rescan
+	m_offsets.clear();
+	if( m_num_tokens == 0 ){
+		return;
 	}
+	m_offsets.reserve(m_num_tokens);
 
 	if( m_is_count_empty_tokens ){
-		while( token != n ){
+		m_offsets.push_back(0);
+		while( (m_offsets.count() < m_num_tokens) && (p < end) ){
 			if( *p == 0 ){
-				token++;
+				m_offsets.push_back(p + 1 - start);
 			}
 			p++;
 		}
 	} else {
-		i = 0;
-		while( (i < m_string_size) && (*p == 0) ){
-			i++;
+		while( (p < end) && (*p == 0) ){
 			p++;
 		}
+		m_offsets.push_back(p - start);
 		on_token = true;
-		while( token != n ){
+		while( (m_offsets.count() < m_num_tokens) && (p < end) ){
 			p++;
 			if( *p != 0 ){
 				if( on_token == false ){
-					token++;
+					m_offsets.push_back(p - start);
 					on_token = true;
 				}
 			} else {
@@ -140,8 +213,19 @@ const ConstString Tokenizer::at(u32 n) const {
 			}
 		}
 	}
+}
+
+const ConstString Tokenizer::at(u32 n) const {
+	if( n >= size() ){
+		return ConstString();
+	}
 
-	return p;
+	if( n >= m_offsets.count() ){
+		//only possible if memory for the index could not be allocated
+		return ConstString();
+	}
+
+	return str() + m_offsets.at(n);
 }
 
 void Tokenizer::sort(enum sort_options sort_option){
@@ -203,12 +287,15 @@ void Tokenizer::sort(enum sort_options sort_option){
 		next += string_to_copy.length() + 1;
 		used[current] = 1;
 	}
+
+	index_tokens();
 }
 
 Tokenizer & Tokenizer::operator=(const Tokenizer & token){
 	set_capacity(token.capacity());
 	::memcpy(data(), token.data_const(), token.capacity());
 	m_num_tokens = token.m_num_tokens;
+	m_offsets = token.m_offsets;
 	m_string_size = token.m_string_size;
 	m_is_count_empty_tokens = token.m_is_count_empty_tokens;
 	return *this;
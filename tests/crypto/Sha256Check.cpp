@@ -0,0 +1,105 @@
+//Copyright 2011-2019 Tyler Gilbert; All Rights Reserved
+
+/*
+ * Checks the parallel Sha256::calculate_files() against the single-threaded
+ * Sha256::calculate() using files with different contents.
+ *
+ * This is a standalone host program (it isn't part of the library targets).
+ * Build it against the link build of the library, for example:
+ *
+ * g++ -std=c++11 -D__link -Iinclude tests/crypto/Sha256Check.cpp -lapi_link -lpthread -o Sha256Check
+ *
+ * Usage: Sha256Check [directory for the temporary files]
+ *
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "sys/File.hpp"
+#include "var/Data.hpp"
+#include "var/String.hpp"
+#include "var/Vector.hpp"
+#include "crypto/Sha256.hpp"
+
+using namespace crypto;
+
+enum {
+	FILE_COUNT = 2,
+	//larger than Sha256::FILE_CHUNK_SIZE so the files are read in more than one chunk
+	FILE_SIZE = 100000,
+	THREAD_COUNT = 4
+};
+
+static int failures = 0;
+
+static void check(bool value, const char * message){
+	if( value == false ){
+		printf("FAIL: %s\n", message);
+		failures++;
+	}
+}
+
+static bool is_equal(const var::Array<u8, 32> & a, const var::Array<u8, 32> & b){
+	return memcmp(a.data(), b.data(), 32) == 0;
+}
+
+int main(int argc, char * argv[]){
+	var::String directory(argc > 1 ? argv[1] : "/tmp");
+	var::Data contents[FILE_COUNT];
+	var::Array<u8, 32> expected[FILE_COUNT];
+	var::Vector<var::String> paths;
+	var::Vector< var::Array<u8, 32> > outputs;
+
+	//a known vector guards against both paths being wrong the same way
+	{
+		const u8 abc_digest[32] = {
+			0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+			0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+		};
+		Sha256 hash;
+		hash << var::ConstString("abc");
+		check(memcmp(hash.output().data(), abc_digest, 32) == 0, "sha256(\"abc\") doesn't match the known digest");
+	}
+
+	for(u32 i=0; i < FILE_COUNT; i++){
+		var::String path;
+		sys::File file;
+
+		contents[i].allocate(FILE_SIZE);
+		for(u32 j=0; j < FILE_SIZE; j++){
+			contents[i].to_u8()[j] = (u8)(j * (i+3) + i);
+		}
+
+		path.format("%s/Sha256Check-%d.bin", directory.cstring(), i);
+		if( (file.create(path) < 0) || (file.write(contents[i]) != FILE_SIZE) ){
+			printf("FAIL: can't write %s\n", path.cstring());
+			return 1;
+		}
+		file.close();
+		paths.push_back(path);
+	}
+
+	//each file is listed twice so every thread has work and the order is checked
+	for(u32 i=0; i < FILE_COUNT; i++){
+		paths.push_back(paths.at(FILE_COUNT-1-i));
+	}
+
+	check(Sha256::calculate(contents, expected, FILE_COUNT, 1) == 0, "calculate() failed");
+	check(is_equal(expected[0], expected[1]) == false, "different inputs have the same digest");
+
+	check(Sha256::calculate_files(paths, outputs, THREAD_COUNT) == 0, "calculate_files() failed");
+	check(outputs.count() == paths.count(), "calculate_files() has the wrong output count");
+	for(u32 i=0; i < outputs.count(); i++){
+		u32 source = i < FILE_COUNT ? i : FILE_COUNT-1-(i-FILE_COUNT);
+		char message[64];
+		snprintf(message, sizeof(message), "calculate_files() digest %d doesn't match calculate()", i);
+		check(is_equal(outputs.at(i), expected[source]), message);
+	}
+
+	for(u32 i=0; i < FILE_COUNT; i++){
+		sys::File::remove(paths.at(i));
+	}
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
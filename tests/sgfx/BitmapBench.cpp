@@ -0,0 +1,200 @@
+//Copyright 2011-2019 Tyler Gilbert; All Rights Reserved
+
+/*
+ * Times the word-at-a-time Bitmap scans (calculate_active_region(),
+ * is_empty() and downsample_bitmap()) against per-pixel get_pixel()
+ * loops that match the previous implementation. Each result is also
+ * checked against the per-pixel result.
+ *
+ * This is a standalone host program (it isn't part of the library targets).
+ * Build it against the link build of the library, for example:
+ *
+ * g++ -std=c++11 -O2 -D__link -Iinclude tests/sgfx/BitmapBench.cpp -lapi_link -o BitmapBench
+ *
+ * The reference downsample sums each cell with get_pixel(). The previous
+ * implementation also copied each cell to a sample bitmap first, so the
+ * reported speedup for downsample_bitmap() is a lower bound.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include "chrono/Timer.hpp"
+#include "sgfx/Bitmap.hpp"
+
+using namespace sgfx;
+
+enum {
+	WIDTH = 320,
+	HEIGHT = 240,
+	//each measurement repeats the operation this many times
+	REPEAT = 200
+};
+
+static int failures = 0;
+
+static Region reference_active_region(const Bitmap & bitmap){
+	Region result;
+	sg_point_t top_left;
+	sg_point_t bottom_right;
+
+	top_left.x = bitmap.width();
+	top_left.y = bitmap.height();
+	bottom_right.x = 0;
+	bottom_right.y = 0;
+
+	for(sg_int_t y = 0; y < bitmap.height(); y++){
+		for(sg_int_t x = 0; x < bitmap.width(); x++){
+			if( bitmap.get_pixel(Point(x,y)) ){
+				if( x < top_left.x ){ top_left.x = x; }
+				if( x > bottom_right.x ){ bottom_right.x = x; }
+				if( y < top_left.y ){ top_left.y = y; }
+				if( y > bottom_right.y ){ bottom_right.y = y; }
+			}
+		}
+	}
+
+	result.set_region(top_left, bottom_right);
+	return result;
+}
+
+static bool reference_is_empty(const Bitmap & bitmap, const Region & region){
+	for(sg_int_t y = region.y(); y < region.y() + region.height(); y++){
+		for(sg_int_t x = region.x(); x < region.x() + region.width(); x++){
+			if( bitmap.get_pixel(Point(x,y)) ){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void reference_downsample(Bitmap & dest, const Bitmap & source, const Area & factor){
+	sg_int_t dest_y = 0;
+	for(sg_int_t y = 0; y <= source.height() - factor.height()/2; y+=factor.height()){
+		sg_int_t dest_x = 0;
+		for(sg_int_t x = 0; x <= source.width() - factor.width()/2; x+=factor.width()){
+			u32 color = 0;
+			for(sg_int_t j = y; j < y + factor.height(); j++){
+				for(sg_int_t i = x; i < x + factor.width(); i++){
+					color += source.get_pixel(Point(i,j));
+				}
+			}
+			dest.bmap()->pen.color = color >= factor.calculate_area()/2 ? 1 : 0;
+			dest.draw_pixel(Point(dest_x,dest_y));
+			dest_x++;
+		}
+		dest_y++;
+	}
+}
+
+static bool is_same(const Region & a, const Region & b){
+	return (a.x() == b.x()) && (a.y() == b.y()) && (a.width() == b.width()) && (a.height() == b.height());
+}
+
+static bool is_same(const Bitmap & a, const Bitmap & b){
+	for(sg_int_t y = 0; y < a.height(); y++){
+		for(sg_int_t x = 0; x < a.width(); x++){
+			if( a.get_pixel(Point(x,y)) != b.get_pixel(Point(x,y)) ){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void report(const char * name, const char * content, u8 bits_per_pixel, u32 reference_us, u32 scan_us, bool is_ok){
+	printf("%-24s %-8s %2dbpp %10.2f %10.2f %7.1fx %s\n",
+			 name, content, bits_per_pixel,
+			 reference_us / (float)REPEAT,
+			 scan_us / (float)REPEAT,
+			 scan_us ? reference_us / (float)scan_us : 0.0f,
+			 is_ok ? "" : "MISMATCH");
+	if( is_ok == false ){
+		failures++;
+	}
+}
+
+static void fill(Bitmap & bitmap, bool is_sparse){
+	bitmap.clear();
+	if( is_sparse ){
+		//a small object in an otherwise blank bitmap (like a cursor or a glyph)
+		bitmap.bmap()->pen.color = (1 << bitmap.bits_per_pixel()) - 1;
+		bitmap.draw_rectangle(Region(Point(150,100), Area(20,12)));
+	} else {
+		for(sg_int_t y = 0; y < bitmap.height(); y++){
+			for(sg_int_t x = 0; x < bitmap.width(); x++){
+				bitmap.bmap()->pen.color = rand() & ((1 << bitmap.bits_per_pixel()) - 1);
+				bitmap.draw_pixel(Point(x,y));
+			}
+		}
+	}
+}
+
+static void run_downsample(const Bitmap & source, const char * content, sg_size_t factor){
+	Bitmap reference_dest(Area(WIDTH/factor+1, HEIGHT/factor+1), 1);
+	Bitmap scan_dest(Area(WIDTH/factor+1, HEIGHT/factor+1), 1);
+	chrono::Timer timer;
+	u32 reference_us;
+	char name[32];
+
+	reference_dest.clear();
+	scan_dest.clear();
+
+	timer.restart();
+	for(u32 i=0; i < REPEAT; i++){ reference_downsample(reference_dest, source, Area(factor,factor)); }
+	reference_us = timer.microseconds();
+	timer.restart();
+	for(u32 i=0; i < REPEAT; i++){ scan_dest.downsample_bitmap(source, Area(factor,factor)); }
+	snprintf(name, sizeof(name), "downsample_bitmap /%d", factor);
+	report(name, content, source.bits_per_pixel(), reference_us, timer.microseconds(), is_same(reference_dest, scan_dest));
+}
+
+static void run(u8 bits_per_pixel, bool is_sparse){
+	Bitmap source(Area(WIDTH, HEIGHT), bits_per_pixel);
+	const char * content = is_sparse ? "sparse" : "dense";
+	Region blank(Point(0,0), Area(WIDTH, 90));
+	chrono::Timer timer;
+	u32 reference_us;
+	Region reference_region;
+	Region scan_region;
+	bool reference_empty = false;
+	bool scan_empty = false;
+
+	fill(source, is_sparse);
+
+	timer.restart();
+	for(u32 i=0; i < REPEAT; i++){ reference_region = reference_active_region(source); }
+	reference_us = timer.microseconds();
+	timer.restart();
+	for(u32 i=0; i < REPEAT; i++){ scan_region = source.calculate_active_region(); }
+	report("calculate_active_region", content, bits_per_pixel, reference_us, timer.microseconds(), is_same(reference_region, scan_region));
+
+	timer.restart();
+	for(u32 i=0; i < REPEAT; i++){ reference_empty = reference_is_empty(source, blank); }
+	reference_us = timer.microseconds();
+	timer.restart();
+	for(u32 i=0; i < REPEAT; i++){ scan_empty = source.is_empty(blank); }
+	report("is_empty", content, bits_per_pixel, reference_us, timer.microseconds(), reference_empty == scan_empty);
+
+	//downsample_bitmap() sums pixel values so it is only meaningful for 1bpp sources
+	if( bits_per_pixel == 1 ){
+		run_downsample(source, content, 4);
+		//words that fall inside one cell are summed a word at a time
+		run_downsample(source, content, 32);
+	}
+}
+
+int main(){
+	const u8 bits_per_pixel_list[] = { 1, 4, 8 };
+
+	printf("%dx%d bitmap, %d calls per measurement\n", WIDTH, HEIGHT, REPEAT);
+	printf("%-24s %-8s %5s %10s %10s %8s\n", "operation", "content", "depth", "pixel us", "word us", "speedup");
+
+	for(u32 i=0; i < sizeof(bits_per_pixel_list); i++){
+		run(bits_per_pixel_list[i], true);
+		run(bits_per_pixel_list[i], false);
+	}
+
+	return failures ? 1 : 0;
+}